@@ -0,0 +1,110 @@
+/**
+ * Benchmark: nightly batch valuation of every portfolio.
+ *
+ * Fills the in-memory repositories with users holding one to three SIPs,
+ * each with one successful installment, and times BatchValuationEngine::run
+ * phase by phase (gather, NAV snapshot, valuation). Reports throughput, the
+ * time the same rate would take for 10M users, and checks a sample of users
+ * against PortfolioServiceImpl::getPortfolioSummary.
+ *
+ * Build & run (from the repository root):
+ *   g++ -std=c++14 -O2 -Wall -Wextra -pthread -I. -o batch_valuation_bench benchmarks/batch_valuation_bench.cpp
+ *   ./batch_valuation_bench [users] [funds] [threads]
+ */
+
+#include "repositories/InMemoryMutualFundRepository.h"
+#include "repositories/InMemorySIPRepository.h"
+#include "repositories/InMemoryTransactionRepository.h"
+#include "services/BatchValuationEngine.h"
+#include "services/MockMarketPriceService.h"
+#include "services/PortfolioServiceImpl.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace sip;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+bool close(double a, double b) {
+    return std::fabs(a - b) <= 1e-6 * std::max(1.0, std::fabs(b));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t userCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500000;
+    size_t fundCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+    unsigned threads = argc > 3 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 0;
+    if (userCount == 0 || fundCount == 0) {
+        std::fprintf(stderr, "usage: %s [users] [funds] [threads]\n", argv[0]);
+        return 1;
+    }
+
+    auto fundRepo = std::make_shared<InMemoryMutualFundRepository>();
+    auto sipRepo = std::make_shared<InMemorySIPRepository>();
+    auto txnRepo = std::make_shared<InMemoryTransactionRepository>();
+    auto prices = std::make_shared<MockMarketPriceService>();
+
+    std::vector<std::string> fundIds(fundCount);
+    std::vector<uint32_t> fundHandles(fundCount);
+    std::vector<double> navs(fundCount);
+    for (size_t f = 0; f < fundCount; ++f) {
+        fundIds[f] = "BATCH_FUND_" + std::to_string(f);
+        fundHandles[f] = IdInterner::funds().intern(fundIds[f]);
+        navs[f] = 10.0 + static_cast<double>(f % 490);
+        fundRepo->add(MutualFund(fundIds[f], fundIds[f], FundCategory::EQUITY, RiskLevel::MEDIUM, navs[f]));
+    }
+    prices->setNAVsByHandle(fundHandles, navs);
+
+    Clock::time_point start = Clock::now();
+    const Date date = DateUtils::createDate(2026, 1, 5);
+    size_t sipCount = 0;
+    for (size_t u = 0; u < userCount; ++u) {
+        std::string userId = "BATCH_USER_" + std::to_string(u);
+        for (size_t s = 0; s <= u % 3; ++s) {
+            std::string sipId = "BATCH_SIP_" + std::to_string(sipCount);
+            size_t fund = (u * 7 + s * 13) % fundCount;
+            double amount = 500.0 + 100.0 * static_cast<double>(s);
+            sipRepo->add(SIP(sipId, userId, fundIds[fund], amount, SIPFrequency::MONTHLY, date));
+            Transaction installment("BATCH_TXN_" + std::to_string(sipCount), sipId, amount, navs[fund] * 0.9, date);
+            installment.setStatus(PaymentStatus::SUCCESS);
+            txnRepo->add(installment);
+            sipCount++;
+        }
+    }
+    double setupSeconds = secondsSince(start);
+
+    BatchValuationEngine engine(sipRepo, txnRepo, prices, threads);
+    BatchValuationResult result = engine.run();
+
+    PortfolioServiceImpl portfolio(sipRepo, txnRepo, fundRepo, prices);
+    size_t mismatches = 0;
+    size_t step = std::max<size_t>(1, result.userIds.size() / 1000);
+    for (size_t u = 0; u < result.userIds.size(); u += step) {
+        PortfolioSummary expected = portfolio.getPortfolioSummary(result.userIds[u]);
+        const PortfolioSummary& actual = result.summaries[u];
+        if (!close(actual.totalCurrentValue, expected.totalCurrentValue) ||
+            !close(actual.totalInvested, expected.totalInvested) || actual.activeSIPCount != expected.activeSIPCount) {
+            mismatches++;
+        }
+    }
+
+    std::printf("users=%zu sips=%zu funds=%zu threads=%u (setup %.1f s)\n",
+                result.userIds.size(), result.holdingCount, result.fundCount, result.threadCount, setupSeconds);
+    std::printf("  gather     %9.1f ms\n", result.gatherSeconds * 1000.0);
+    std::printf("  snapshot   %9.1f ms\n", result.snapshotSeconds * 1000.0);
+    std::printf("  valuation  %9.1f ms\n", result.valuationSeconds * 1000.0);
+    std::printf("  total      %9.1f ms  %.0f users/s, %.0f holdings/s\n", result.totalSeconds() * 1000.0,
+                result.usersPerSecond(), result.holdingsPerSecond());
+    std::printf("  10M users at this rate: %.1f s\n", 1e7 / result.usersPerSecond());
+    std::printf("  sampled mismatches %zu\n", mismatches);
+    return mismatches == 0 && result.userIds.size() == userCount ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+/**
+ * Benchmark: per-user netting of same-day installments into mandate debits.
+ *
+ * Gives each user one to five SIPs due on the same day and runs
+ * SIPScheduler::executeDueSIPs against AsyncMockPaymentService (failures
+ * and duplicate callbacks injected) with debit netting off and on. Reports
+ * debits, callbacks and gateway round trips, and checks that every
+ * installment was settled exactly once and, when netting, that all of a
+ * user's installments share their debit's outcome.
+ *
+ * Build & run (from the repository root):
+ *   g++ -std=c++14 -O2 -Wall -Wextra -pthread -I. -o debit_netting_bench benchmarks/debit_netting_bench.cpp
+ *   ./debit_netting_bench [users]
+ */
+
+#include "repositories/InMemoryHoldingRepository.h"
+#include "repositories/InMemoryMutualFundRepository.h"
+#include "repositories/InMemorySIPRepository.h"
+#include "repositories/InMemoryTransactionRepository.h"
+#include "repositories/InMemoryUserRepository.h"
+#include "scheduler/SIPScheduler.h"
+#include "services/AsyncMockPaymentService.h"
+#include "services/MockMarketPriceService.h"
+#include "services/MutualFundServiceImpl.h"
+#include "services/SIPServiceImpl.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace sip;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+bool run(bool netting, size_t userCount) {
+    auto fundRepo = std::make_shared<InMemoryMutualFundRepository>();
+    auto userRepo = std::make_shared<InMemoryUserRepository>();
+    auto sipRepo = std::make_shared<InMemorySIPRepository>();
+    auto txnRepo = std::make_shared<InMemoryTransactionRepository>();
+    auto holdingRepo = std::make_shared<InMemoryHoldingRepository>();
+    auto prices = std::make_shared<MockMarketPriceService>();
+    PaymentGatewayProfile profile;
+    profile.latency = PaymentLatency::lognormal(1.0, 0.5);
+    profile.failureRate = 0.05;
+    profile.duplicateRate = 0.05;
+    auto gateway = std::make_shared<AsyncMockPaymentService>(profile, std::make_shared<RandomSource>(11));
+    auto fundService = std::make_shared<MutualFundServiceImpl>(fundRepo);
+    auto sipService = std::make_shared<SIPServiceImpl>(sipRepo, userRepo, fundService);
+    SIPScheduler scheduler(sipRepo, txnRepo, prices, gateway, sipService, holdingRepo);
+    scheduler.setDebitNetting(netting);
+
+    const Date start = DateUtils::createDate(2024, 1, 5);
+    for (int f = 0; f < 8; ++f) {
+        std::string fundId = "NETTING_FUND_" + std::to_string(f);
+        fundRepo->add(MutualFund(fundId, fundId, FundCategory::EQUITY, RiskLevel::MEDIUM, 10.0 + f));
+        prices->updateNAV(fundId, 10.0 + f);
+    }
+    // Users' SIPs are created interleaved, so netting has to regroup them
+    std::vector<std::vector<std::string>> sipsByUser(userCount);
+    size_t sipCount = 0;
+    for (size_t round = 0; round < 5; ++round) {
+        for (size_t u = 0; u < userCount; ++u) {
+            std::string userId = "NETTING_USER_" + std::to_string(u);
+            if (round == 0) {
+                userRepo->add(User(userId, userId, userId + "@example.com"));
+            }
+            if (round <= u % 5) {
+                sipsByUser[u].push_back(sipService->createSIP(userId, "NETTING_FUND_" + std::to_string((u + round) % 8),
+                                                              500.0 + 100.0 * round, SIPFrequency::MONTHLY,
+                                                              start).getId());
+                sipCount++;
+            }
+        }
+    }
+
+    auto begin = Clock::now();
+    int submitted = scheduler.executeDueSIPs(start);
+    gateway->waitForIdle();
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    PaymentGatewayStats stats = gateway->getStats();
+    size_t pending = txnRepo->getByStatus(PaymentStatus::PENDING).size();
+    size_t succeeded = 0, installments = 0, split = 0;
+    double successfulUnits = 0.0, heldUnits = 0.0;
+    for (const auto& sipIds : sipsByUser) {
+        size_t userSucceeded = 0;
+        for (const std::string& sipId : sipIds) {
+            for (const Transaction& txn : txnRepo->getBySipId(sipId)) {
+                userSucceeded += txn.getStatus() == PaymentStatus::SUCCESS ? 1 : 0;
+            }
+            installments += static_cast<size_t>(sipRepo->getById(sipId)->getInstallmentCount());
+            successfulUnits += txnRepo->getSuccessfulTotalsBySipId(sipId).totalUnits;
+        }
+        succeeded += userSucceeded;
+        split += userSucceeded != 0 && userSucceeded != sipIds.size() ? 1 : 0;
+    }
+    for (const Holding& holding : holdingRepo->getAll()) {
+        heldUnits += holding.getUnits();
+    }
+    bool consistent = static_cast<size_t>(submitted) == sipCount && pending == 0 && installments == succeeded &&
+                      std::fabs(heldUnits - successfulUnits) <= 1e-6 * successfulUnits &&
+                      stats.callbackErrors == 0 && (!netting || split == 0);
+
+    std::printf("  netting %-3s %6zu installments -> %6llu debits, %6llu callbacks, %4llu round trips, "
+                "%6.1f ms\n", netting ? "on" : "off", sipCount, static_cast<unsigned long long>(stats.initiated),
+                static_cast<unsigned long long>(stats.callbacksDelivered),
+                static_cast<unsigned long long>(stats.roundTrips), seconds * 1000.0);
+    std::printf("  %-11s %6zu succeeded, %llu debits failed, %zu users partly debited, %s\n", "", succeeded,
+                static_cast<unsigned long long>(stats.failures), split,
+                consistent ? "settled exactly once" : "INCONSISTENT");
+    return consistent;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t userCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    if (userCount == 0) {
+        std::fprintf(stderr, "usage: %s [users]\n", argv[0]);
+        return 1;
+    }
+    std::printf("users=%zu with 1-5 SIPs each, failure=5%% duplicate=5%%\n", userCount);
+    bool ok = run(false, userCount);
+    ok = run(true, userCount) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+/**
+ * Benchmark: payment-callback idempotency store.
+ *
+ * Replays a long stream of callbacks (a steady rate of new transaction IDs,
+ * a share of them redelivered within the retry window) through
+ * IdempotencyStore on a simulated clock, with and without Bloom filters,
+ * and through the unbounded unordered_map it replaces. Reports time per
+ * check, peak memory against the map's, duplicates rejected, and whether
+ * every key is still remembered up to the window and forgotten after it.
+ *
+ * Build & run (from the repository root):
+ *   g++ -std=c++14 -O2 -Wall -Wextra -pthread -I. -o idempotency_bench benchmarks/idempotency_bench.cpp
+ *   ./idempotency_bench [callbacks] [callbacks per window]
+ */
+
+#include "utils/IdempotencyStore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace sip;
+
+namespace {
+
+typedef IdempotencyStore::Clock Clock;
+
+struct ReplayResult {
+    double nanosecondsPerCheck;
+    size_t peakBytes;
+    size_t duplicatesRejected;
+    size_t falseDuplicates;  // New keys reported as duplicates
+};
+
+std::string transactionId(size_t n) {
+    return "TXN_" + std::to_string(n);
+}
+
+/**
+ * Callback n arrives at n * spacing; every 20th is redelivered half a
+ * window later.
+ */
+template <typename Check>
+ReplayResult replay(Clock::time_point start, size_t callbacks, Clock::duration spacing, size_t perWindow,
+                    Check check) {
+    std::vector<std::string> ids(callbacks);
+    for (size_t n = 0; n < callbacks; ++n) {
+        ids[n] = transactionId(n);
+    }
+    ReplayResult result = {0.0, 0, 0, 0};
+    size_t checks = 0;
+    auto begin = Clock::now();
+    for (size_t n = 0; n < callbacks; ++n) {
+        Clock::time_point now = start + spacing * static_cast<Clock::rep>(n);
+        result.falseDuplicates += check(ids[n], now) ? 0 : 1;
+        ++checks;
+        if (n >= perWindow / 2 && (n - perWindow / 2) % 20 == 0) {
+            result.duplicatesRejected += check(ids[n - perWindow / 2], now) ? 0 : 1;
+            ++checks;
+        }
+    }
+    result.nanosecondsPerCheck = std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / checks;
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t callbacks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    size_t perWindow = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+    if (callbacks == 0 || perWindow < 2) {
+        std::fprintf(stderr, "usage: %s [callbacks] [callbacks per window]\n", argv[0]);
+        return 1;
+    }
+    const Clock::duration window = std::chrono::hours(24);
+    const Clock::duration spacing = window / static_cast<Clock::rep>(perWindow);
+    const size_t expectedDuplicates = callbacks > perWindow / 2 ? (callbacks - perWindow / 2 - 1) / 20 + 1 : 0;
+
+    std::printf("callbacks=%zu, %zu per 24h retry window, %zu redelivered\n", callbacks, perWindow,
+                expectedDuplicates);
+    bool ok = true;
+    for (int bloom = 1; bloom >= 0; --bloom) {
+        const Clock::time_point start = Clock::now();
+        IdempotencyStore store(window, 8, bloom != 0, perWindow / 7);
+        size_t peak = 0;
+        size_t sampled = 0;
+        ReplayResult result = replay(start, callbacks, spacing, perWindow,
+                                     [&](const std::string& id, Clock::time_point now) {
+            bool fresh = store.tryRecord(id, now);
+            if (++sampled % 65536 == 0) {
+                peak = std::max(peak, store.memoryBytes());
+            }
+            return fresh;
+        });
+        result.peakBytes = std::max(peak, store.memoryBytes());
+
+        // The last key is remembered just inside the window and gone well after it
+        Clock::time_point last = start + spacing * static_cast<Clock::rep>(callbacks - 1);
+        bool remembered = store.contains(transactionId(callbacks - 1), last + window - spacing);
+        bool expired = !store.contains(transactionId(callbacks - 1), last + window * 2);
+
+        bool correct = result.duplicatesRejected == expectedDuplicates && remembered && expired;
+        ok = ok && correct;
+        std::printf("  store %-10s %6.1f ns/check, peak %7.1f MB, rejected %zu/%zu duplicates, "
+                    "%zu false, window %s\n", bloom ? "(bloom)" : "(no bloom)", result.nanosecondsPerCheck,
+                    result.peakBytes / 1048576.0, result.duplicatesRejected, expectedDuplicates,
+                    result.falseDuplicates, correct ? "honoured" : "VIOLATED");
+    }
+
+    std::unordered_map<std::string, bool> seen;
+    ReplayResult result = replay(Clock::now(), callbacks, spacing, perWindow,
+                                 [&](const std::string& id, Clock::time_point) {
+        return seen.emplace(id, true).second;
+    });
+    // Lower bound: one node (next pointer, cached hash, key, value) and one bucket slot per key
+    size_t bytes = seen.size() * (sizeof(void*) + sizeof(size_t) + sizeof(std::pair<const std::string, bool>)) +
+                   seen.bucket_count() * sizeof(void*);
+    std::printf("  unordered_map     %6.1f ns/check, >%7.1f MB and growing (%zu keys kept forever)\n",
+                result.nanosecondsPerCheck, bytes / 1048576.0, seen.size());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+/**
+ * Benchmark: multi-year GBM market simulation.
+ *
+ * Builds a catalogue of funds across all categories and times
+ * MarketSimulator over the given number of years, with and without
+ * recording every day in the NAV history. Then replays the same years one
+ * day at a time, checks that it lands on bit-identical NAVs, and compares
+ * the realized per-fund return and volatility and the cross-category
+ * correlation of daily moves with the configured assumptions.
+ *
+ * Build & run (from the repository root):
+ *   g++ -std=c++14 -O2 -Wall -Wextra -pthread -I. -o market_sim_bench benchmarks/market_sim_bench.cpp
+ *   ./market_sim_bench [funds] [years]
+ */
+
+#include "repositories/InMemoryMutualFundRepository.h"
+#include "repositories/InMemoryNavHistoryRepository.h"
+#include "services/MarketSimulator.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace sip;
+
+namespace {
+
+struct Market {
+    std::shared_ptr<MockMarketPriceService> prices;
+    std::shared_ptr<InMemoryNavHistoryRepository> history;
+    std::unique_ptr<MarketSimulator> simulator;
+};
+
+Market openMarket(const std::shared_ptr<InMemoryMutualFundRepository>& funds, bool recordHistory) {
+    Market market;
+    market.prices = std::make_shared<MockMarketPriceService>();
+    for (const MutualFund& fund : funds->getAll()) {
+        market.prices->updateNAV(fund.getId(), fund.getNav());
+    }
+    if (recordHistory) {
+        market.history = std::make_shared<InMemoryNavHistoryRepository>();
+    }
+    market.simulator.reset(new MarketSimulator(market.prices, funds, market.history));
+    return market;
+}
+
+double correlationOf(const std::vector<double>& x, const std::vector<double>& y) {
+    double n = static_cast<double>(x.size()), sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        sx += x[i];
+        sy += y[i];
+        sxx += x[i] * x[i];
+        syy += y[i] * y[i];
+        sxy += x[i] * y[i];
+    }
+    return (sxy - sx * sy / n) / std::sqrt((sxx - sx * sx / n) * (syy - sy * sy / n));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t fundCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    int years = argc > 2 ? std::atoi(argv[2]) : 5;
+    if (fundCount < kFundCategoryCount || years <= 0) {
+        std::fprintf(stderr, "usage: %s [funds >= %zu] [years]\n", argv[0], kFundCategoryCount);
+        return 1;
+    }
+
+    auto funds = std::make_shared<InMemoryMutualFundRepository>();
+    std::vector<std::string> fundIds;
+    std::vector<size_t> categoryOf;
+    for (size_t i = 0; i < fundCount; ++i) {
+        std::string id = "SIM_" + std::to_string(i);
+        FundCategory category = static_cast<FundCategory>(i % kFundCategoryCount);
+        funds->add(MutualFund(id, id, category, RiskLevel::MEDIUM, 10.0 + i % 90));
+        fundIds.push_back(id);
+        categoryOf.push_back(i % kFundCategoryCount);
+    }
+    std::vector<uint32_t> handles(fundIds.size());
+    IdInterner::funds().internAll(fundIds, handles.data());
+
+    const Date start = DateUtils::createDate(2024, 1, 1);
+    const int days = years * 365;
+
+    Market bulk = openMarket(funds, false);
+    MarketSimulationResult plain = bulk.simulator->advance(start, days);
+    Market recorded = openMarket(funds, true);
+    MarketSimulationResult withHistory = recorded.simulator->advance(start, days);
+
+    // Day by day, collecting daily log returns
+    Market daily = openMarket(funds, false);
+    std::vector<double> previous = daily.prices->getStoredNAVs(handles);
+    std::vector<double> sumReturn(fundCount, 0.0), sumSquared(fundCount, 0.0);
+    std::vector<std::vector<double>> categoryMoves(kFundCategoryCount, std::vector<double>(days, 0.0));
+    std::vector<size_t> categorySize(kFundCategoryCount, 0);
+    for (size_t i = 0; i < fundCount; ++i) {
+        categorySize[categoryOf[i]]++;
+    }
+    for (int d = 0; d < days; ++d) {
+        daily.simulator->advance(start + std::chrono::hours(24 * d), 1);
+        std::vector<double> current = daily.prices->getStoredNAVs(handles);
+        for (size_t i = 0; i < fundCount; ++i) {
+            double move = std::log(current[i] / previous[i]);
+            sumReturn[i] += move;
+            sumSquared[i] += move * move;
+            categoryMoves[categoryOf[i]][static_cast<size_t>(d)] += move / categorySize[categoryOf[i]];
+        }
+        previous.swap(current);
+    }
+
+    std::vector<double> bulkNavs = bulk.prices->getStoredNAVs(handles);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < fundCount; ++i) {
+        mismatches += bulkNavs[i] != previous[i] ? 1 : 0;
+    }
+
+    std::printf("funds=%zu years=%d days=%d kernel=%s\n", fundCount, years, days, PathKernel::implementationName());
+    std::printf("  simulate              %8.3f s  (%7.1f us/day)\n", plain.elapsedSeconds,
+                plain.elapsedSeconds * 1e6 / days);
+    std::printf("  simulate + history    %8.3f s  (%7.1f us/day, %zu points)\n", withHistory.elapsedSeconds,
+                withHistory.elapsedSeconds * 1e6 / days, recorded.history->getPointCount(fundIds[0]) * fundCount);
+    std::printf("  bulk vs day-by-day mismatches %zu\n", mismatches);
+    std::printf("  %-8s %8s %8s %8s %8s\n", "category", "drift", "real", "vol", "real");
+    for (size_t c = 0; c < kFundCategoryCount; ++c) {
+        FundCategory category = static_cast<FundCategory>(c);
+        ReturnAssumption assumption = bulk.simulator->getReturnAssumption(category);
+        double meanReturn = 0.0, meanVolatility = 0.0;
+        for (size_t i = c; i < fundCount; i += kFundCategoryCount) {
+            double mean = sumReturn[i] / days;
+            meanReturn += sumReturn[i] / years;
+            meanVolatility += std::sqrt((sumSquared[i] / days - mean * mean) * 365.0);
+        }
+        // Realized drift is compared in log terms: E[log return] = log(1 + mu) - sigma^2 / 2
+        double sigma = assumption.volatility;
+        std::printf("  %-8s %8.4f %8.4f %8.4f %8.4f\n", toName(category),
+                    std::log1p(assumption.expectedReturn) - 0.5 * sigma * sigma,
+                    meanReturn / categorySize[c], sigma, meanVolatility / categorySize[c]);
+    }
+    const FundCategory pairs[][2] = {{FundCategory::EQUITY, FundCategory::ELSS},
+                                     {FundCategory::EQUITY, FundCategory::HYBRID},
+                                     {FundCategory::EQUITY, FundCategory::DEBT}};
+    for (const auto& pair : pairs) {
+        std::printf("  corr %-6s/%-6s  target %5.2f  category averages %5.2f\n", toName(pair[0]), toName(pair[1]),
+                    bulk.simulator->getCategoryCorrelation(pair[0], pair[1]),
+                    correlationOf(categoryMoves[static_cast<size_t>(pair[0])],
+                                  categoryMoves[static_cast<size_t>(pair[1])]));
+    }
+    return mismatches == 0 ? 0 : 1;
+}
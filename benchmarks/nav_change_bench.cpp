@@ -0,0 +1,117 @@
+/**
+ * Benchmark: NAV change notifications.
+ *
+ * Times single-fund and whole-catalogue NAV updates on MockMarketPriceService
+ * with and without a subscriber, then runs a burst of updates against a
+ * deliberately slow subscriber that keeps a NAV cache from the batches alone.
+ * Reports how many batches were delivered and merged, and checks that the
+ * cache ends up equal to the published NAVs.
+ *
+ * Build & run (from the repository root):
+ *   g++ -std=c++14 -O2 -Wall -Wextra -pthread -I. -o nav_change_bench benchmarks/nav_change_bench.cpp
+ *   ./nav_change_bench [funds] [updates]
+ */
+
+#include "services/MockMarketPriceService.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+using namespace sip;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+template <typename Body>
+double microsecondsPerCall(int repeats, Body body) {
+    auto start = Clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        body(r);
+    }
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / repeats;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t fundCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 40000;
+    int updates = argc > 2 ? std::atoi(argv[2]) : 2000;
+    if (fundCount == 0 || updates <= 0) {
+        std::fprintf(stderr, "usage: %s [funds] [updates]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<std::string> fundIds;
+    std::vector<double> navs;
+    for (size_t i = 0; i < fundCount; ++i) {
+        fundIds.push_back("NOTIFY_" + std::to_string(i));
+        navs.push_back(10.0 + i % 500);
+    }
+    std::vector<uint32_t> handles(fundCount);
+    IdInterner::funds().internAll(fundIds, handles.data());
+
+    MockMarketPriceService prices;
+    prices.updateNAVs(fundIds, navs);
+
+    const int repeats = 500;
+    auto singleFund = [&](int r) { prices.updateNAV(fundIds[static_cast<size_t>(r) % fundCount], 20.0 + r % 7); };
+    auto wholeMarket = [&](int r) { prices.simulateMarketMovement(r % 2 == 0 ? 0.001 : -0.001); };
+    double singleAlone = microsecondsPerCall(repeats, singleFund);
+    double marketAlone = microsecondsPerCall(repeats / 10, wholeMarket);
+
+    uint64_t counted = 0;
+    uint64_t subscription = prices.subscribeNavChanges([&counted](const NavChangeBatch& batch) {
+        counted += batch.changes.size();
+    });
+    double singleWatched = microsecondsPerCall(repeats, singleFund);
+    double marketWatched = microsecondsPerCall(repeats / 10, wholeMarket);
+    prices.flushNavChanges();
+    prices.unsubscribeNavChanges(subscription);
+
+    // Burst against a slow subscriber that only knows what the batches told it
+    std::vector<double> cache = prices.getStoredNAVs(handles);
+    uint64_t delivered = prices.getNavChangeDispatcher().getDeliveredBatchCount();
+    uint64_t merged = prices.getNavChangeDispatcher().getMergedBatchCount();
+    uint64_t lastVersion = prices.getVersion();
+    bool ordered = true;
+    prices.subscribeNavChanges([&](const NavChangeBatch& batch) {
+        ordered = ordered && batch.firstVersion > lastVersion && batch.version >= batch.firstVersion;
+        lastVersion = batch.version;
+        for (const NavChange& change : batch.changes) {
+            if (change.fundHandle < cache.size()) {
+                cache[change.fundHandle] = change.nav;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    });
+    auto start = Clock::now();
+    for (int u = 0; u < updates; ++u) {
+        if (u % 100 == 0) {
+            prices.simulateMarketMovement(0.002);
+        } else {
+            singleFund(u);
+        }
+    }
+    double burstMicroseconds = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    prices.flushNavChanges();
+
+    std::vector<double> published = prices.getStoredNAVs(handles);
+    size_t stale = 0;
+    for (size_t i = 0; i < fundCount; ++i) {
+        stale += cache[handles[i]] != published[i] ? 1 : 0;
+    }
+    delivered = prices.getNavChangeDispatcher().getDeliveredBatchCount() - delivered;
+    merged = prices.getNavChangeDispatcher().getMergedBatchCount() - merged;
+
+    std::printf("funds=%zu\n", fundCount);
+    std::printf("  single-fund update   %8.1f us  (%8.1f us with a subscriber)\n", singleAlone, singleWatched);
+    std::printf("  whole-market update  %8.1f us  (%8.1f us with a subscriber)\n", marketAlone, marketWatched);
+    std::printf("  burst of %d updates  %8.1f us per update, %llu batches delivered, %llu merged\n", updates,
+                burstMicroseconds / updates, static_cast<unsigned long long>(delivered),
+                static_cast<unsigned long long>(merged));
+    std::printf("  changes counted %llu, stale cache entries %zu, versions in order %s\n",
+                static_cast<unsigned long long>(counted), stale, ordered ? "yes" : "NO");
+    return stale == 0 && ordered ? 0 : 1;
+}
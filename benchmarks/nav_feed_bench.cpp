@@ -0,0 +1,78 @@
+/**
+ * Benchmark: daily NAV file load.
+ *
+ * Generates an AMFI-format NAV file with the given number of schemes (plus
+ * category/AMC headings and some "N.A." lines), then times parsing it and
+ * publishing it to MockMarketPriceService as one version, and checks every
+ * published NAV against the value written. The file is loaded twice: the
+ * first load interns every scheme, the second is the steady state of a
+ * daily feed whose schemes the loader has already seen.
+ *
+ * Build & run (from the repository root):
+ *   g++ -std=c++14 -O2 -Wall -Wextra -pthread -I. -o nav_feed_bench benchmarks/nav_feed_bench.cpp
+ *   ./nav_feed_bench [schemes]
+ */
+
+#include "services/MockMarketPriceService.h"
+#include "services/NavFeedLoader.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace sip;
+
+int main(int argc, char** argv) {
+    size_t schemes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 40000;
+    if (schemes == 0) {
+        std::fprintf(stderr, "usage: %s [schemes]\n", argv[0]);
+        return 1;
+    }
+
+    std::string file = "Scheme Code;ISIN Div Payout/ ISIN Growth;ISIN Div Reinvestment;"
+                       "Scheme Name;Net Asset Value;Date\r\n";
+    std::vector<double> expected(schemes);
+    char line[256];
+    for (size_t i = 0; i < schemes; ++i) {
+        if (i % 500 == 0) {
+            file += "\r\nOpen Ended Schemes(Equity Scheme - Large Cap Fund)\r\n\r\nSample Mutual Fund\r\n\r\n";
+        }
+        // NAVs with four decimals, as published
+        long tenThousandths = 100000 + static_cast<long>((i * 7919) % 9000000);
+        expected[i] = tenThousandths / 10000.0;
+        const char* date = i % 50 == 0 ? "15-Oct-2026" : "16-Oct-2026";
+        int length;
+        if (i % 400 == 7) {
+            expected[i] = 0;
+            length = std::snprintf(line, sizeof(line), "%zu;INF%09zu;-;Sample Fund %zu - Direct Plan - Growth;N.A.;%s\r\n",
+                                   100000 + i, i, i, date);
+        } else {
+            length = std::snprintf(line, sizeof(line), "%zu;INF%09zu;-;Sample Fund %zu - Direct Plan - Growth;%ld.%04ld;%s\r\n",
+                                   100000 + i, i, i, tenThousandths / 10000, tenThousandths % 10000, date);
+        }
+        file.append(line, static_cast<size_t>(length));
+    }
+
+    auto prices = std::make_shared<MockMarketPriceService>();
+    NavFeedLoader loader(prices);
+    NavFeedLoadResult first = loader.load(file.data(), file.size());
+    NavFeedLoadResult result = loader.load(file.data(), file.size());
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < schemes; ++i) {
+        if (expected[i] > 0 && prices->getStoredNAV(std::to_string(100000 + i)) != expected[i]) {
+            mismatches++;
+        }
+    }
+
+    std::printf("schemes=%zu bytes=%zu\n", schemes, file.size());
+    std::printf("  published %zu, unpriced %zu, malformed %zu, catalogue version %llu\n",
+                result.publishedCount, result.unpricedCount, result.malformedCount,
+                static_cast<unsigned long long>(prices->getVersion()));
+    std::printf("                 first load   steady state\n");
+    std::printf("  parse     %10.3f ms  %10.3f ms\n", first.parseSeconds * 1000.0, result.parseSeconds * 1000.0);
+    std::printf("  publish   %10.3f ms  %10.3f ms\n", first.publishSeconds * 1000.0, result.publishSeconds * 1000.0);
+    std::printf("  total     %10.3f ms  %10.3f ms\n", (first.parseSeconds + first.publishSeconds) * 1000.0,
+                (result.parseSeconds + result.publishSeconds) * 1000.0);
+    std::printf("  NAV mismatches %zu\n", mismatches);
+    return mismatches == 0 && result.malformedCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+/**
+ * Benchmark: per-fund purchase order aggregation.
+ *
+ * Runs one day of SIPs through SIPScheduler with an OrderAggregator, closes
+ * the day's orders, writes the order file and allots every order at the
+ * fund's NAV with units rounded down to 3 decimals, as an AMC would.
+ * Reports orders against installments, the time to write and to allocate,
+ * and checks that each order's units were split exactly across its
+ * installments and landed in the holdings once, even though every allotment
+ * is delivered twice.
+ *
+ * Build & run (from the repository root):
+ *   g++ -std=c++14 -O2 -Wall -Wextra -pthread -I. -o order_aggregation_bench benchmarks/order_aggregation_bench.cpp
+ *   ./order_aggregation_bench [sips] [funds]
+ */
+
+#include "repositories/InMemoryHoldingRepository.h"
+#include "repositories/InMemoryMutualFundRepository.h"
+#include "repositories/InMemorySIPRepository.h"
+#include "repositories/InMemoryTransactionRepository.h"
+#include "repositories/InMemoryUserRepository.h"
+#include "scheduler/SIPScheduler.h"
+#include "services/MockMarketPriceService.h"
+#include "services/MockPaymentService.h"
+#include "services/MutualFundServiceImpl.h"
+#include "services/OrderAggregator.h"
+#include "services/SIPServiceImpl.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+using namespace sip;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t sipCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    size_t fundCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 40;
+    if (sipCount == 0 || fundCount == 0) {
+        std::fprintf(stderr, "usage: %s [sips] [funds]\n", argv[0]);
+        return 1;
+    }
+
+    auto fundRepo = std::make_shared<InMemoryMutualFundRepository>();
+    auto userRepo = std::make_shared<InMemoryUserRepository>();
+    auto sipRepo = std::make_shared<InMemorySIPRepository>();
+    auto txnRepo = std::make_shared<InMemoryTransactionRepository>();
+    auto holdingRepo = std::make_shared<InMemoryHoldingRepository>();
+    auto prices = std::make_shared<MockMarketPriceService>();
+    auto payments = std::make_shared<MockPaymentService>(0.98, true, std::make_shared<RandomSource>(5));
+    auto aggregator = std::make_shared<OrderAggregator>();
+    auto fundService = std::make_shared<MutualFundServiceImpl>(fundRepo);
+    auto sipService = std::make_shared<SIPServiceImpl>(sipRepo, userRepo, fundService);
+    SIPScheduler scheduler(sipRepo, txnRepo, prices, payments, sipService, holdingRepo, nullptr, aggregator);
+
+    const Date start = DateUtils::createDate(2024, 1, 10);
+    for (size_t f = 0; f < fundCount; ++f) {
+        std::string fundId = "ORDER_FUND_" + std::to_string(f);
+        fundRepo->add(MutualFund(fundId, fundId, FundCategory::EQUITY, RiskLevel::MEDIUM, 10.0 + f));
+        prices->updateNAV(fundId, 10.0 + f);
+    }
+    std::vector<std::string> sipIds;
+    for (size_t i = 0; i < sipCount; ++i) {
+        std::string userId = "ORDER_USER_" + std::to_string(i);
+        userRepo->add(User(userId, userId, userId + "@example.com"));
+        sipIds.push_back(sipService->createSIP(userId, "ORDER_FUND_" + std::to_string(i % fundCount),
+                                               500.0 + 50.0 * (i % 10), SIPFrequency::MONTHLY, start).getId());
+    }
+
+    auto begin = Clock::now();
+    scheduler.executeDueSIPs(start);
+    double executeMs = millisecondsSince(begin);
+    size_t installments = aggregator->getPendingInstallmentCount();
+
+    begin = Clock::now();
+    std::vector<PurchaseOrder> orders = aggregator->closeOrders(start);
+    std::ostringstream orderFile;
+    OrderAggregator::writeOrderFile(orders, orderFile);
+    double writeMs = millisecondsSince(begin);
+
+    // The AMC allots at its NAV (slightly off our price) and rounds units down to 3 decimals
+    double allocateMs = 0.0, applyMs = 0.0, worstSplitError = 0.0, allottedUnits = 0.0;
+    std::vector<OrderAllocation> allocations;
+    for (const PurchaseOrder& order : orders) {
+        double nav = prices->getCurrentNAV(order.fundId) * 1.001;
+        double units = std::floor(order.amount / nav * 1000.0) / 1000.0;
+        begin = Clock::now();
+        OrderAllocation allocation = aggregator->allocate(order.id, nav, units);
+        allocateMs += millisecondsSince(begin);
+        double split = 0.0;
+        for (double memberUnits : allocation.units) {
+            split += memberUnits;
+        }
+        worstSplitError = std::max(worstSplitError, std::fabs(split - units) / units);
+        allottedUnits += units;
+        begin = Clock::now();
+        scheduler.applyAllotment(allocation);
+        applyMs += millisecondsSince(begin);
+        allocations.push_back(std::move(allocation));
+    }
+    // A redelivered allotment must not add units again
+    for (const OrderAllocation& allocation : allocations) {
+        scheduler.applyAllotment(allocation);
+    }
+
+    double heldUnits = 0.0, transactionUnits = 0.0;
+    for (const Holding& holding : holdingRepo->getAll()) {
+        heldUnits += holding.getUnits();
+    }
+    for (const std::string& sipId : sipIds) {
+        transactionUnits += txnRepo->getSuccessfulTotalsBySipId(sipId).totalUnits;
+    }
+    bool consistent = orders.size() <= fundCount && worstSplitError < 1e-12 &&
+                      std::fabs(heldUnits - allottedUnits) <= 1e-9 * allottedUnits &&
+                      std::fabs(transactionUnits - allottedUnits) <= 1e-9 * allottedUnits &&
+                      aggregator->getOpenOrders().empty();
+
+    std::printf("sips=%zu funds=%zu\n", sipCount, fundCount);
+    std::printf("  %zu successful installments -> %zu orders (%.1f ms to execute the run)\n", installments,
+                orders.size(), executeMs);
+    std::printf("  close + write order file %8.3f ms (%zu bytes)\n", writeMs, orderFile.str().size());
+    std::printf("  allocate %8.1f ns per installment, apply to transactions and holdings %8.1f ns\n",
+                allocateMs * 1e6 / installments, applyMs * 1e6 / installments);
+    std::printf("  worst split error %.2e, units allotted %.3f, held %.3f, %s\n", worstSplitError, allottedUnits,
+                heldUnits, consistent ? "consistent" : "INCONSISTENT");
+    return consistent ? 0 : 1;
+}
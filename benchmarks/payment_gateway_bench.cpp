@@ -0,0 +1,128 @@
+/**
+ * Benchmark: SIP execution against an asynchronous payment gateway.
+ *
+ * Creates one SIP per user, runs SIPScheduler::executeDueSIPs with
+ * AsyncMockPaymentService as the gateway (lognormal latency, failures,
+ * duplicate and reordered callbacks), waits for every callback and reports
+ * throughput, gateway round trips and counters for each latency
+ * distribution, with installments sent one per call and in batches. Checks
+ * that each payment was applied exactly once: every transaction settled,
+ * installment counts match the successful payments and holdings match the
+ * successful units.
+ *
+ * Build & run (from the repository root):
+ *   g++ -std=c++14 -O2 -Wall -Wextra -pthread -I. -o payment_gateway_bench benchmarks/payment_gateway_bench.cpp
+ *   ./payment_gateway_bench [sips] [worker threads] [batch size]
+ */
+
+#include "repositories/InMemoryHoldingRepository.h"
+#include "repositories/InMemoryMutualFundRepository.h"
+#include "repositories/InMemorySIPRepository.h"
+#include "repositories/InMemoryTransactionRepository.h"
+#include "repositories/InMemoryUserRepository.h"
+#include "scheduler/SIPScheduler.h"
+#include "services/AsyncMockPaymentService.h"
+#include "services/MockMarketPriceService.h"
+#include "services/MutualFundServiceImpl.h"
+#include "services/SIPServiceImpl.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace sip;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+bool runProfile(const char* name, const PaymentGatewayProfile& profile, size_t sipCount, size_t batchSize) {
+    auto fundRepo = std::make_shared<InMemoryMutualFundRepository>();
+    auto userRepo = std::make_shared<InMemoryUserRepository>();
+    auto sipRepo = std::make_shared<InMemorySIPRepository>();
+    auto txnRepo = std::make_shared<InMemoryTransactionRepository>();
+    auto holdingRepo = std::make_shared<InMemoryHoldingRepository>();
+    auto prices = std::make_shared<MockMarketPriceService>();
+    auto gateway = std::make_shared<AsyncMockPaymentService>(profile, std::make_shared<RandomSource>(7));
+    auto fundService = std::make_shared<MutualFundServiceImpl>(fundRepo);
+    auto sipService = std::make_shared<SIPServiceImpl>(sipRepo, userRepo, fundService);
+    SIPScheduler scheduler(sipRepo, txnRepo, prices, gateway, sipService, holdingRepo);
+    scheduler.setPaymentBatchSize(batchSize);
+
+    const Date start = DateUtils::createDate(2024, 1, 1);
+    for (int f = 0; f < 8; ++f) {
+        std::string fundId = "GATEWAY_FUND_" + std::to_string(f);
+        fundRepo->add(MutualFund(fundId, fundId, FundCategory::EQUITY, RiskLevel::MEDIUM, 10.0 + f));
+        prices->updateNAV(fundId, 10.0 + f);
+    }
+    std::vector<std::string> sipIds;
+    for (size_t i = 0; i < sipCount; ++i) {
+        std::string userId = "GATEWAY_USER_" + std::to_string(i);
+        userRepo->add(User(userId, userId, userId + "@example.com"));
+        sipIds.push_back(sipService->createSIP(userId, "GATEWAY_FUND_" + std::to_string(i % 8), 1000.0,
+                                               SIPFrequency::MONTHLY, start).getId());
+    }
+
+    auto begin = Clock::now();
+    int submitted = scheduler.executeDueSIPs(start);
+    double submitSeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    gateway->waitForIdle();
+    double totalSeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    PaymentGatewayStats stats = gateway->getStats();
+    size_t pending = txnRepo->getByStatus(PaymentStatus::PENDING).size();
+    size_t succeeded = txnRepo->getByStatus(PaymentStatus::SUCCESS).size();
+    size_t installments = 0;
+    double successfulUnits = 0.0, heldUnits = 0.0;
+    for (const std::string& sipId : sipIds) {
+        auto sip = sipRepo->getById(sipId);
+        installments += static_cast<size_t>(sip->getInstallmentCount());
+        successfulUnits += txnRepo->getSuccessfulTotalsBySipId(sipId).totalUnits;
+    }
+    for (const Holding& holding : holdingRepo->getAll()) {
+        heldUnits += holding.getUnits();
+    }
+    bool consistent = pending == 0 && succeeded == sipCount - stats.failures && installments == succeeded &&
+                      std::fabs(heldUnits - successfulUnits) <= 1e-6 * successfulUnits && stats.callbackErrors == 0;
+
+    std::printf("  %-10s batch %4zu: submit %7.1f ms, settled %8.1f ms (%8.0f payments/s), %llu round trips, "
+                "max outstanding %zu\n", name, batchSize, submitSeconds * 1000.0, totalSeconds * 1000.0,
+                submitted / totalSeconds, static_cast<unsigned long long>(stats.roundTrips), stats.maxOutstanding);
+    std::printf("  %-10s callbacks %llu (%llu duplicate, %llu reordered), failed %llu, pending %zu, %s\n", "",
+                static_cast<unsigned long long>(stats.callbacksDelivered),
+                static_cast<unsigned long long>(stats.duplicates), static_cast<unsigned long long>(stats.reordered),
+                static_cast<unsigned long long>(stats.failures), pending,
+                consistent ? "applied exactly once" : "INCONSISTENT");
+    return consistent;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t sipCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 8;
+    size_t batchSize = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 256;
+    if (sipCount == 0 || threads == 0 || batchSize == 0) {
+        std::fprintf(stderr, "usage: %s [sips] [worker threads] [batch size]\n", argv[0]);
+        return 1;
+    }
+
+    PaymentGatewayProfile profile;
+    profile.workerThreads = threads;
+    profile.failureRate = 0.02;
+    profile.duplicateRate = 0.05;
+    profile.reorderRate = 0.05;
+    profile.reorderDelayMs = 20.0;
+
+    std::printf("sips=%zu workers=%u failure=2%% duplicate=5%% reorder=5%%\n", sipCount, threads);
+    bool ok = true;
+    profile.latency = PaymentLatency::fixed(2.0);
+    ok = runProfile("fixed", profile, sipCount, 1) && ok;
+    ok = runProfile("fixed", profile, sipCount, batchSize) && ok;
+    profile.latency = PaymentLatency::lognormal(2.0, 0.6);
+    ok = runProfile("lognormal", profile, sipCount, 1) && ok;
+    ok = runProfile("lognormal", profile, sipCount, batchSize) && ok;
+    profile.latency = PaymentLatency::longTail(2.0, 0.6, 0.01, 50.0);
+    ok = runProfile("long-tail", profile, sipCount, batchSize) && ok;
+    return ok ? 0 : 1;
+}
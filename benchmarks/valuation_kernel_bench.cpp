@@ -0,0 +1,126 @@
+/**
+ * Microbenchmark: units x NAV valuation.
+ *
+ * Compares the per-item loop PortfolioServiceImpl used to run on each
+ * SIPPortfolioItem against ValuationKernel's scalar and dispatched (AVX2 when
+ * available) column-wise implementations, and checks that all three agree.
+ *
+ * Build & run (from the repository root):
+ *   g++ -std=c++14 -O2 -Wall -Wextra -I. -o valuation_kernel_bench benchmarks/valuation_kernel_bench.cpp
+ *   ./valuation_kernel_bench [holdings] [funds] [iterations]
+ */
+
+#include "services/IPortfolioService.h"
+#include "utils/ValuationKernel.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace sip;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedNs(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+/**
+ * The per-item valuation from buildPortfolioItem, over an array of items.
+ */
+void valuePerItem(std::vector<SIPPortfolioItem>& items) {
+    for (auto& item : items) {
+        item.currentValue = item.totalUnits * item.currentNav;
+        item.gainLoss = item.currentValue - item.totalInvested;
+        if (item.totalInvested > 0) {
+            item.gainLossPercentage = (item.gainLoss / item.totalInvested) * 100.0;
+        } else {
+            item.gainLossPercentage = 0.0;
+        }
+    }
+}
+
+template <typename Fn>
+double bestNsPerHolding(int iterations, size_t holdings, Fn fn) {
+    double best = 0;
+    for (int i = 0; i < iterations; ++i) {
+        Clock::time_point start = Clock::now();
+        fn();
+        double ns = elapsedNs(start) / static_cast<double>(holdings);
+        if (i == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t holdings = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t funds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+    int iterations = argc > 3 ? std::atoi(argv[3]) : 20;
+    if (holdings == 0 || funds == 0 || iterations <= 0) {
+        std::fprintf(stderr, "usage: %s [holdings] [funds] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> navDist(10.0, 500.0);
+    std::uniform_real_distribution<double> unitsDist(0.0, 1000.0);
+    std::uniform_int_distribution<uint32_t> fundDist(0, static_cast<uint32_t>(funds - 1));
+
+    std::vector<double> navs(funds);
+    for (auto& nav : navs) {
+        nav = navDist(rng);
+    }
+
+    std::vector<double> units(holdings), invested(holdings);
+    std::vector<uint32_t> fundIndex(holdings);
+    std::vector<SIPPortfolioItem> items(holdings);
+    for (size_t i = 0; i < holdings; ++i) {
+        fundIndex[i] = fundDist(rng);
+        units[i] = unitsDist(rng);
+        invested[i] = (i % 16 == 0) ? 0.0 : units[i] * navDist(rng);
+        items[i].totalUnits = units[i];
+        items[i].totalInvested = invested[i];
+        items[i].currentNav = navs[fundIndex[i]];
+    }
+
+    std::vector<double> currentValue(holdings), gainLoss(holdings), gainLossPercentage(holdings);
+    ValuationKernel::Columns columns;
+    columns.count = holdings;
+    columns.units = units.data();
+    columns.fundIndex = fundIndex.data();
+    columns.navs = navs.data();
+    columns.invested = invested.data();
+    columns.currentValue = currentValue.data();
+    columns.gainLoss = gainLoss.data();
+    columns.gainLossPercentage = gainLossPercentage.data();
+
+    double perItemNs = bestNsPerHolding(iterations, holdings, [&]() { valuePerItem(items); });
+    double scalarNs = bestNsPerHolding(iterations, holdings, [&]() { ValuationKernel::valueScalar(columns); });
+    std::vector<double> scalarPercentage = gainLossPercentage;
+    double dispatchedNs = bestNsPerHolding(iterations, holdings, [&]() { ValuationKernel::value(columns); });
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < holdings; ++i) {
+        if (items[i].currentValue != currentValue[i] || items[i].gainLoss != gainLoss[i] ||
+            items[i].gainLossPercentage != gainLossPercentage[i] ||
+            scalarPercentage[i] != gainLossPercentage[i]) {
+            ++mismatches;
+        }
+    }
+
+    std::printf("holdings=%zu funds=%zu iterations=%d kernel=%s\n",
+                holdings, funds, iterations, ValuationKernel::implementationName());
+    std::printf("  per-item loop     %8.3f ns/holding\n", perItemNs);
+    std::printf("  kernel (scalar)   %8.3f ns/holding  %.2fx\n", scalarNs, perItemNs / scalarNs);
+    std::printf("  kernel (dispatch) %8.3f ns/holding  %.2fx\n", dispatchedNs, perItemNs / dispatchedNs);
+    std::printf("  mismatches        %zu\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
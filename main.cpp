@@ -16,6 +16,10 @@
 #include <string>
 #include <memory>
 #include <limits>
+#include <cmath>
+#include <sstream>
+#include <fstream>
+#include <unordered_map>
 
 // Models
 #include "models/Enums.h"
@@ -28,7 +32,9 @@
 #include "repositories/InMemoryMutualFundRepository.h"
 #include "repositories/InMemoryUserRepository.h"
 #include "repositories/InMemorySIPRepository.h"
+#include "repositories/InMemoryHoldingRepository.h"
 #include "repositories/InMemoryTransactionRepository.h"
+#include "repositories/InMemoryNavHistoryRepository.h"
 
 // Services
 #include "services/MutualFundServiceImpl.h"
@@ -36,6 +42,12 @@
 #include "services/PortfolioServiceImpl.h"
 #include "services/MockPaymentService.h"
 #include "services/MockMarketPriceService.h"
+#include "services/XirrEngine.h"
+#include "services/ScenarioEngine.h"
+#include "services/MonteCarloProjector.h"
+#include "services/NavFeedLoader.h"
+#include "services/CorporateActionService.h"
+#include "services/MarketSimulator.h"
 
 // Scheduler
 #include "scheduler/SIPScheduler.h"
@@ -44,6 +56,7 @@
 #include "utils/DateUtils.h"
 #include "utils/IdGenerator.h"
 #include "utils/Exceptions.h"
+#include "utils/StatementWriter.h"
 
 using namespace sip;
 
@@ -54,16 +67,26 @@ std::shared_ptr<IMutualFundRepository> g_fundRepo;
 std::shared_ptr<IUserRepository> g_userRepo;
 std::shared_ptr<ISIPRepository> g_sipRepo;
 std::shared_ptr<ITransactionRepository> g_txnRepo;
+std::shared_ptr<IHoldingRepository> g_holdingRepo;
+std::shared_ptr<INavHistoryRepository> g_navHistory;
 
 std::shared_ptr<MockMarketPriceService> g_marketPriceService;
 std::shared_ptr<MockPaymentService> g_paymentService;
 std::shared_ptr<MutualFundServiceImpl> g_fundService;
 std::shared_ptr<SIPServiceImpl> g_sipService;
 std::shared_ptr<PortfolioServiceImpl> g_portfolioService;
+std::shared_ptr<XirrEngine> g_xirrEngine;
+std::shared_ptr<ScenarioEngine> g_scenarioEngine;
+std::vector<uint8_t> g_fundCategories;  // Fund catalog by handle for what-if valuations
+std::shared_ptr<MonteCarloProjector> g_projector;
+std::shared_ptr<NavFeedLoader> g_navFeedLoader;
+std::shared_ptr<CorporateActionService> g_corporateActions;
+std::shared_ptr<MarketSimulator> g_marketSimulator;
 std::shared_ptr<SIPScheduler> g_scheduler;
 
 std::string g_currentUserId;
 Date g_currentDate;
+bool g_simulateDailyMarket = false;  // Advance Date moves NAVs with MarketSimulator
 
 // ============================================================================
 // Helper Functions
@@ -143,8 +166,8 @@ void printFundTable(const std::vector<MutualFund>& funds) {
                   << std::setw(4) << idx++
                   << std::setw(14) << fund.getId()
                   << std::setw(28) << fund.getName()
-                  << std::setw(10) << sip::toString(fund.getCategory())
-                  << std::setw(8) << sip::toString(fund.getRiskLevel())
+                  << std::setw(10) << sip::toName(fund.getCategory())
+                  << std::setw(8) << sip::toName(fund.getRiskLevel())
                   << "Rs. " << std::fixed << std::setprecision(2) << currentNav
                   << std::endl;
     }
@@ -159,8 +182,8 @@ void printSIPDetails(const SIP& sip) {
     std::cout << "  SIP ID:           " << sip.getId() << std::endl;
     std::cout << "  Fund:             " << fundName << " (" << sip.getFundId() << ")" << std::endl;
     std::cout << "  Base Amount:      Rs. " << std::fixed << std::setprecision(2) << sip.getBaseAmount() << std::endl;
-    std::cout << "  Frequency:        " << sip::toString(sip.getFrequency()) << std::endl;
-    std::cout << "  State:            " << sip::toString(sip.getState()) << std::endl;
+    std::cout << "  Frequency:        " << sip::toName(sip.getFrequency()) << std::endl;
+    std::cout << "  State:            " << sip::toName(sip.getState()) << std::endl;
     std::cout << "  Installments:     " << sip.getInstallmentCount() << std::endl;
     std::cout << "  Step-Up:          " << sip.getStepUpPercentage() << "%" << std::endl;
     std::cout << "  Start Date:       " << DateUtils::formatDate(sip.getStartDate()) << std::endl;
@@ -172,26 +195,67 @@ void printTransaction(const Transaction& txn) {
               << "Rs. " << std::right << std::setw(10) << std::fixed << std::setprecision(2) << txn.getAmount()
               << "  Units: " << std::setw(10) << txn.getUnits()
               << "  NAV: " << std::setw(8) << txn.getNav()
-              << "  " << sip::toString(txn.getStatus())
+              << "  " << sip::toName(txn.getStatus())
               << std::endl;
 }
 
+std::string formatXirr(const XirrResult& result) {
+    if (!result.converged) {
+        return "n/a";
+    }
+    double percent = result.rate * 100.0;
+    if (std::fabs(percent) < 0.005) {
+        percent = 0.0;  // Avoid printing "-0.00%"
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2) << (percent >= 0 ? "+" : "") << percent << "% p.a.";
+    return out.str();
+}
+
 void printPortfolioItem(const SIPPortfolioItem& item) {
     std::cout << "\n  " << item.sip.getId() << " - " << item.fundName << std::endl;
-    std::cout << "    State: " << sip::toString(item.sip.getState()) 
-              << " | Frequency: " << sip::toString(item.sip.getFrequency()) << std::endl;
+    std::cout << "    State: " << sip::toName(item.sip.getState()) 
+              << " | Frequency: " << sip::toName(item.sip.getFrequency()) << std::endl;
     std::cout << "    Invested: Rs. " << std::fixed << std::setprecision(2) << item.totalInvested
               << " | Units: " << item.totalUnits << std::endl;
     std::cout << "    Current Value: Rs. " << item.currentValue 
               << " | NAV: Rs. " << item.currentNav << std::endl;
     std::cout << "    Gain/Loss: Rs. " << item.gainLoss 
               << " (" << (item.gainLoss >= 0 ? "+" : "") << item.gainLossPercentage << "%)" << std::endl;
+    std::cout << "    XIRR: " << formatXirr(g_xirrEngine->getSIPXirr(item.sip.getId(), g_currentDate)) << std::endl;
     if (item.sip.getStepUpPercentage() > 0) {
         std::cout << "    Step-Up: " << item.sip.getStepUpPercentage() << "% | Next Installment: Rs. " 
                   << item.nextInstallmentAmount << std::endl;
     }
 }
 
+void printFundHolding(const FundHoldingItem& item) {
+    std::cout << "\n  " << item.fundId << " - " << item.fundName << std::endl;
+    std::cout << "    Invested: Rs. " << std::fixed << std::setprecision(2) << item.totalInvested
+              << " | Units: " << item.totalUnits << std::endl;
+    std::cout << "    Current Value: Rs. " << item.currentValue
+              << " | NAV: Rs. " << item.currentNav << std::endl;
+    std::cout << "    Gain/Loss: Rs. " << item.gainLoss
+              << " (" << (item.gainLoss >= 0 ? "+" : "") << item.gainLossPercentage << "%)" << std::endl;
+}
+
+void printProjection(const ProjectionResult& projection) {
+    std::cout << std::right << "\n  " << std::setw(6) << "Year" << std::setw(16) << "Invested"
+              << std::setw(16) << "Pessimistic" << std::setw(16) << "Median" << std::setw(16) << "Optimistic" << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+    for (const auto& band : projection.bands) {
+        // Every 5th year plus the first and last keep long horizons readable
+        if (band.year != 1 && band.year % 5 != 0 && band.year != static_cast<int>(projection.bands.size())) {
+            continue;
+        }
+        std::cout << "  " << std::setw(6) << band.year << std::setw(16) << band.invested
+                  << std::setw(16) << band.p10 << std::setw(16) << band.p50 << std::setw(16) << band.p90 << std::endl;
+    }
+    std::cout << std::left << std::setprecision(2);
+    std::cout << "\n  Pessimistic/Optimistic: 10th/90th percentile of " << projection.paths
+              << " simulated paths (" << projection.elapsedSeconds << "s)" << std::endl;
+}
+
 void printPortfolioSummary(const PortfolioSummary& summary) {
     std::cout << "\n  PORTFOLIO SUMMARY" << std::endl;
     std::cout << "  -----------------" << std::endl;
@@ -205,6 +269,26 @@ void printPortfolioSummary(const PortfolioSummary& summary) {
     std::cout << "  Stopped SIPs:      " << summary.stoppedSIPCount << std::endl;
 }
 
+// Record every fund's current NAV as today's entry in the NAV history
+void recordNavHistory() {
+    std::vector<std::string> fundIds;
+    std::vector<double> navs;
+    for (const auto& fund : g_fundRepo->getAll()) {
+        fundIds.push_back(fund.getId());
+        navs.push_back(g_marketPriceService->getStoredNAV(fund.getId()));
+    }
+    g_navHistory->appendAll(g_currentDate, fundIds, navs);
+}
+
+// Copy the price service's NAVs into the MutualFund objects to keep data consistent
+void syncFundNavs() {
+    for (const auto& fund : g_fundRepo->getAll()) {
+        MutualFund updatedFund = fund;
+        updatedFund.setNav(g_marketPriceService->getStoredNAV(fund.getId()));
+        g_fundRepo->update(updatedFund);
+    }
+}
+
 // ============================================================================
 // Menu Functions
 // ============================================================================
@@ -251,7 +335,7 @@ void browseFundCatalog() {
             std::cout << "  4. ELSS" << std::endl;
             int cat = getIntInput("  Choice: ", 1, 4);
             FundCategory category = static_cast<FundCategory>(cat - 1);
-            printSubHeader(std::string("Funds - ") + sip::toString(category));
+            printSubHeader(std::string("Funds - ") + sip::toName(category));
             funds = g_fundService->filterByCategory(category);
             break;
         }
@@ -262,7 +346,7 @@ void browseFundCatalog() {
             std::cout << "  3. HIGH" << std::endl;
             int risk = getIntInput("  Choice: ", 1, 3);
             RiskLevel riskLevel = static_cast<RiskLevel>(risk - 1);
-            printSubHeader(std::string("Funds - ") + sip::toString(riskLevel) + " Risk");
+            printSubHeader(std::string("Funds - ") + sip::toName(riskLevel) + " Risk");
             funds = g_fundService->filterByRiskLevel(riskLevel);
             break;
         }
@@ -323,7 +407,7 @@ void createSIP() {
     std::cout << "\n  SIP Summary:" << std::endl;
     std::cout << "  Fund: " << funds[fundChoice - 1].getName() << std::endl;
     std::cout << "  Amount: Rs. " << std::fixed << std::setprecision(2) << amount << std::endl;
-    std::cout << "  Frequency: " << sip::toString(frequency) << std::endl;
+    std::cout << "  Frequency: " << sip::toName(frequency) << std::endl;
     std::cout << "  Step-Up: " << stepUpPercentage << "%" << std::endl;
     std::cout << "  Start Date: " << DateUtils::formatDate(g_currentDate) << std::endl;
     
@@ -363,8 +447,8 @@ void viewMySIPs() {
             
             std::cout << "\n  " << idx++ << ". " << sip.getId() << " - " << fundName << std::endl;
             std::cout << "     Amount: Rs. " << std::fixed << std::setprecision(2) << sip.getBaseAmount()
-                      << " | " << sip::toString(sip.getFrequency()) 
-                      << " | State: " << sip::toString(sip.getState()) << std::endl;
+                      << " | " << sip::toName(sip.getFrequency()) 
+                      << " | State: " << sip::toName(sip.getState()) << std::endl;
             if (sip.getStepUpPercentage() > 0) {
                 std::cout << "     Step-Up: " << sip.getStepUpPercentage() << "%" << std::endl;
             }
@@ -394,7 +478,7 @@ void manageSIP() {
         auto fund = g_fundRepo->getById(sip.getFundId());
         std::string fundName = fund ? fund->getName() : "Unknown";
         std::cout << "  " << idx++ << ". " << sip.getId() << " - " << fundName 
-                  << " [" << sip::toString(sip.getState()) << "]" << std::endl;
+                  << " [" << sip::toName(sip.getState()) << "]" << std::endl;
     }
     std::cout << "  0. Back" << std::endl;
     
@@ -409,9 +493,11 @@ void manageSIP() {
     std::cout << "  2. Unpause SIP" << std::endl;
     std::cout << "  3. Stop SIP" << std::endl;
     std::cout << "  4. Modify Step-Up Percentage" << std::endl;
+    std::cout << "  5. Project Future Value (goal planning)" << std::endl;
+    std::cout << "  6. Export Statement (CSV)" << std::endl;
     std::cout << "  0. Back" << std::endl;
     
-    int action = getIntInput("\n  Select action: ", 0, 4);
+    int action = getIntInput("\n  Select action: ", 0, 6);
     
     try {
         switch (action) {
@@ -438,6 +524,28 @@ void manageSIP() {
                 std::cout << "\n  SUCCESS! Step-up updated to " << newStepUp << "%" << std::endl;
                 break;
             }
+            case 5: {
+                int years = getIntInput("  Projection horizon in years (1-40): ", 1, 40);
+                printProjection(g_projector->projectSIP(selectedSip.getId(), years, 20000));
+                break;
+            }
+            case 6: {
+                std::string path = getStringInput("  File name (blank for " + selectedSip.getId() + ".csv): ");
+                if (path.empty()) {
+                    path = selectedSip.getId() + ".csv";
+                }
+                std::ofstream file(path, std::ios::binary);
+                if (!file) {
+                    throw SIPSystemException("Cannot open " + path);
+                }
+                StatementWriter writer(file);
+                writer.writeHeader();
+                writer.writeTransactions(g_portfolioService->getTransactionHistory(selectedSip.getId()));
+                writer.flush();
+                std::cout << "\n  SUCCESS! " << writer.getRowCount() << " transaction(s) written to " << path
+                          << std::endl;
+                break;
+            }
             case 0:
                 return;
         }
@@ -466,6 +574,8 @@ void viewPortfolio() {
         // Show summary first
         auto summary = g_portfolioService->getPortfolioSummary(g_currentUserId);
         printPortfolioSummary(summary);
+        std::cout << "  XIRR:              "
+                  << formatXirr(g_xirrEngine->getPortfolioXirr(g_currentUserId, g_currentDate)) << std::endl;
         
         // Filter options
         std::cout << "\n  View Options:" << std::endl;
@@ -473,8 +583,23 @@ void viewPortfolio() {
         std::cout << "  2. Active SIPs only" << std::endl;
         std::cout << "  3. Paused SIPs only" << std::endl;
         std::cout << "  4. Stopped SIPs only" << std::endl;
+        std::cout << "  5. Holdings by fund" << std::endl;
         
-        int choice = getIntInput("\n  Select: ", 1, 4);
+        int choice = getIntInput("\n  Select: ", 1, 5);
+
+        if (choice == 5) {
+            auto holdings = g_portfolioService->getUserHoldings(g_currentUserId);
+            if (holdings.empty()) {
+                std::cout << "\n  No units purchased yet." << std::endl;
+            } else {
+                printSubHeader("Holdings by Fund");
+                for (const auto& holding : holdings) {
+                    printFundHolding(holding);
+                }
+            }
+            waitForEnter();
+            return;
+        }
         
         std::vector<SIPPortfolioItem> items;
         switch (choice) {
@@ -608,9 +733,21 @@ void advanceDate() {
         case 0: return;
     }
     
+    Date previousDate = g_currentDate;
     g_currentDate = g_currentDate + std::chrono::hours(24 * days);
     
     std::cout << "\n  Date advanced to: " << DateUtils::formatDate(g_currentDate) << std::endl;
+
+    if (g_simulateDailyMarket) {
+        try {
+            MarketSimulationResult result = g_marketSimulator->advance(previousDate, days);
+            syncFundNavs();
+            std::cout << "  Simulated " << result.days << " market day(s) for " << result.fundCount
+                      << " funds" << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << "\n  ERROR: " << e.what() << std::endl;
+        }
+    }
     
     // Check for due SIPs
     auto dueSips = g_sipRepo->getDueSIPs(g_currentDate);
@@ -639,9 +776,104 @@ void simulateMarketMovement() {
     std::cout << "  3. Market Down 5%" << std::endl;
     std::cout << "  4. Market Down 10%" << std::endl;
     std::cout << "  5. Custom percentage" << std::endl;
+    std::cout << "  6. What-if preview for my portfolio (prices unchanged)" << std::endl;
+    std::cout << "  7. Load daily NAV file (AMFI format, scheme codes mapped to funds)" << std::endl;
+    std::cout << "  8. Unit split / bonus for a fund" << std::endl;
+    std::cout << "  9. Simulated daily market when advancing date: " << (g_simulateDailyMarket ? "ON" : "OFF")
+              << std::endl;
     std::cout << "  0. Back" << std::endl;
     
-    int choice = getIntInput("\n  Select: ", 0, 5);
+    int choice = getIntInput("\n  Select: ", 0, 9);
+
+    if (choice == 9) {
+        g_simulateDailyMarket = !g_simulateDailyMarket;
+        std::cout << "\n  Simulated daily market is now " << (g_simulateDailyMarket ? "ON" : "OFF") << "." << std::endl;
+        if (g_simulateDailyMarket) {
+            std::cout << "  NAVs will follow correlated random paths by fund category as the date advances." << std::endl;
+        }
+        waitForEnter();
+        return;
+    }
+
+    if (choice == 8) {
+        std::string fundId = getStringInput("  Fund ID: ");
+        double multiplier = getDoubleInput("  Units after per unit before (e.g., 10 for a 1:10 split, 1.5 for a 1:2 bonus): ");
+        try {
+            g_corporateActions->apply({CorporateAction(fundId, multiplier)});
+            syncFundNavs();
+            std::cout << "\n  " << fundId << ": NAV now Rs. " << std::fixed << std::setprecision(4)
+                      << g_marketPriceService->getStoredNAV(fundId) << ", units multiplied by "
+                      << std::setprecision(2) << multiplier << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << "\n  ERROR: " << e.what() << std::endl;
+        }
+        waitForEnter();
+        return;
+    }
+
+    if (choice == 7) {
+        // AMFI scheme codes are not catalog fund IDs: only mapped schemes are applied
+        std::cout << "  Map the file's scheme codes to catalog funds, e.g. 118955=FUND_000001 120377=FUND_000002"
+                  << std::endl;
+        std::istringstream pairs(getStringInput("  Scheme code mappings: "));
+        std::unordered_map<std::string, std::string> mapping;
+        std::string pair;
+        while (pairs >> pair) {
+            size_t equals = pair.find('=');
+            std::string fundId = equals == std::string::npos ? "" : pair.substr(equals + 1);
+            if (equals == 0 || fundId.empty() || !g_fundService->fundExists(fundId)) {
+                std::cout << "  Skipping '" << pair << "': not CODE=FUND_ID for a catalog fund" << std::endl;
+                continue;
+            }
+            mapping[pair.substr(0, equals)] = fundId;
+        }
+        if (mapping.empty()) {
+            std::cout << "\n  No scheme codes mapped; nothing to load." << std::endl;
+            waitForEnter();
+            return;
+        }
+        std::string path = getStringInput("  NAV file path: ");
+        try {
+            g_navFeedLoader->setSchemeMapping(mapping);
+            NavFeedLoadResult result = g_navFeedLoader->loadFile(path);
+            syncFundNavs();
+            std::cout << "\n  Published " << result.publishedCount << " NAVs ("
+                      << result.unpricedCount << " unpriced, " << result.malformedCount << " malformed lines, "
+                      << result.unmappedCount << " unmapped schemes skipped)" << std::endl;
+            std::cout << "  Parsed in " << std::fixed << std::setprecision(2) << result.parseSeconds * 1000.0
+                      << " ms, published in " << result.publishSeconds * 1000.0 << " ms" << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << "\n  ERROR: " << e.what() << std::endl;
+        }
+        waitForEnter();
+        return;
+    }
+
+    if (choice == 6) {
+        std::cout << "  Enter percentage (e.g., 5 for +5%, -3 for -3%): ";
+        double pct;
+        std::cin >> pct;
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        if (!(pct > -100.0)) {
+            std::cout << "\n  ERROR: A market move must be greater than -100%" << std::endl;
+            waitForEnter();
+            return;
+        }
+
+        MarketScenario scenario("what-if");
+        scenario.shockMarket(pct / 100.0);
+        auto current = g_portfolioService->getPortfolioSummary(g_currentUserId);
+        auto projected = g_scenarioEngine->evaluateUser(g_currentUserId, scenario, g_fundCategories);
+        std::cout << "\n  If the market moved " << (pct >= 0 ? "+" : "") << pct << "%:" << std::endl;
+        std::cout << "    Current Value:   Rs. " << std::fixed << std::setprecision(2)
+                  << current.totalCurrentValue << std::endl;
+        std::cout << "    Scenario Value:  Rs. " << projected.totalCurrentValue << std::endl;
+        std::cout << "    Gain/Loss:       Rs. " << projected.gainLoss
+                  << " (" << (projected.gainLoss >= 0 ? "+" : "") << projected.gainLossPercentage << "%)" << std::endl;
+        std::cout << "\n  Fund NAVs were not changed." << std::endl;
+        waitForEnter();
+        return;
+    }
     
     double percentage = 0;
     switch (choice) {
@@ -660,15 +892,17 @@ void simulateMarketMovement() {
         case 0: return;
     }
     
-    g_marketPriceService->simulateMarketMovement(percentage);
+    try {
+        g_marketPriceService->simulateMarketMovement(percentage);
+    } catch (const std::exception& e) {
+        std::cout << "\n  ERROR: " << e.what() << std::endl;
+        waitForEnter();
+        return;
+    }
     
     // Also update the MutualFund objects in the repository to keep data consistent
-    for (const auto& fund : funds) {
-        double newNav = g_marketPriceService->getStoredNAV(fund.getId());
-        MutualFund updatedFund = fund;
-        updatedFund.setNav(newNav);
-        g_fundRepo->update(updatedFund);
-    }
+    syncFundNavs();
+    recordNavHistory();
     
     std::cout << "\n  Market moved by " << (percentage >= 0 ? "+" : "") 
               << (percentage * 100) << "%" << std::endl;
@@ -699,6 +933,8 @@ void setupSampleFunds() {
     g_marketPriceService->updateNAV("FUND_000004", 120.00);
     g_marketPriceService->updateNAV("FUND_000005", 95.75);
     g_marketPriceService->updateNAV("FUND_000006", 32.50);
+
+    recordNavHistory();
 }
 
 void setupUser() {
@@ -725,22 +961,38 @@ void initializeSystem() {
     g_userRepo = std::make_shared<InMemoryUserRepository>();
     g_sipRepo = std::make_shared<InMemorySIPRepository>();
     g_txnRepo = std::make_shared<InMemoryTransactionRepository>();
+    g_holdingRepo = std::make_shared<InMemoryHoldingRepository>();
+    g_navHistory = std::make_shared<InMemoryNavHistoryRepository>();
     
     // Initialize services
     g_marketPriceService = std::make_shared<MockMarketPriceService>(false, 0.0);
     g_paymentService = std::make_shared<MockPaymentService>(1.0, true);
     g_fundService = std::make_shared<MutualFundServiceImpl>(g_fundRepo);
     g_sipService = std::make_shared<SIPServiceImpl>(g_sipRepo, g_userRepo, g_fundService);
-    g_portfolioService = std::make_shared<PortfolioServiceImpl>(g_sipRepo, g_txnRepo, g_fundRepo, g_marketPriceService);
     
     // Initialize scheduler
-    g_scheduler = std::make_shared<SIPScheduler>(g_sipRepo, g_txnRepo, g_marketPriceService, g_paymentService, g_sipService);
+    g_scheduler = std::make_shared<SIPScheduler>(g_sipRepo, g_txnRepo, g_marketPriceService, g_paymentService,
+                                                 g_sipService, g_holdingRepo, g_navHistory);
+    // Readers and corporate actions share the scheduler's repository lock
+    std::shared_ptr<std::mutex> repositoryLock = g_scheduler->getRepositoryMutex();
+    g_corporateActions = std::make_shared<CorporateActionService>(g_marketPriceService, g_sipRepo, g_txnRepo,
+                                                                  g_holdingRepo, g_navHistory, repositoryLock);
+    g_portfolioService = std::make_shared<PortfolioServiceImpl>(g_sipRepo, g_txnRepo, g_fundRepo, g_marketPriceService,
+                                                                g_holdingRepo, repositoryLock);
+    g_xirrEngine = std::make_shared<XirrEngine>(g_sipRepo, g_txnRepo, g_marketPriceService, 0, repositoryLock);
+    g_scenarioEngine = std::make_shared<ScenarioEngine>(g_sipRepo, g_txnRepo, g_fundRepo, g_marketPriceService, 0,
+                                                        repositoryLock);
+    g_projector = std::make_shared<MonteCarloProjector>(g_sipRepo, g_txnRepo, g_fundRepo, g_marketPriceService, 0,
+                                                        MonteCarloProjector::kDefaultSeed, repositoryLock);
+    g_navFeedLoader = std::make_shared<NavFeedLoader>(g_marketPriceService, g_navHistory);
+    g_marketSimulator = std::make_shared<MarketSimulator>(g_marketPriceService, g_fundRepo, g_navHistory);
     
     // Set current date
     g_currentDate = DateUtils::createDate(2024, 1, 1);
     
     // Setup sample funds
     setupSampleFunds();
+    g_fundCategories = g_scenarioEngine->fundCategories();
 }
 
 // ============================================================================
@@ -1,106 +1,90 @@
 #ifndef ENUMS_H
 #define ENUMS_H
 
+#include <cstddef>
+#include <cstring>
 #include <string>
 
 namespace sip {
 
+/*
+ * Each enum is declared from a single value list. The same list generates
+ * the enumerators, the constexpr name table used by toName/toString and the
+ * reverse lookup used by tryParse, so adding an enumerator cannot leave the
+ * conversions out of sync.
+ */
+#define SIP_ENUM_VALUE(name) name,
+#define SIP_ENUM_NAME(name) #name,
+
+#define SIP_DEFINE_ENUM_CONVERSIONS(Type, VALUES)                                        \
+    constexpr const char* const k##Type##Names[] = { VALUES(SIP_ENUM_NAME) };            \
+    constexpr std::size_t k##Type##Count = sizeof(k##Type##Names) / sizeof(const char*); \
+                                                                                         \
+    /* Static name of a value; no allocation. */                                        \
+    constexpr const char* toName(Type value) {                                           \
+        return static_cast<std::size_t>(value) < k##Type##Count                          \
+                   ? k##Type##Names[static_cast<std::size_t>(value)]                     \
+                   : "UNKNOWN";                                                          \
+    }                                                                                    \
+                                                                                         \
+    inline std::string toString(Type value) {                                            \
+        return toName(value);                                                            \
+    }                                                                                    \
+                                                                                         \
+    /* Parse an exact (case-sensitive) name; returns false if none matches. */          \
+    inline bool tryParse(const char* text, std::size_t length, Type& out) {              \
+        for (std::size_t i = 0; i < k##Type##Count; ++i) {                               \
+            const char* name = k##Type##Names[i];                                        \
+            if (std::strlen(name) == length && std::memcmp(name, text, length) == 0) {   \
+                out = static_cast<Type>(i);                                              \
+                return true;                                                             \
+            }                                                                            \
+        }                                                                                \
+        return false;                                                                    \
+    }                                                                                    \
+                                                                                         \
+    inline bool tryParse(const std::string& text, Type& out) {                           \
+        return tryParse(text.data(), text.size(), out);                                  \
+    }
+
 // SIP Frequency - how often the SIP executes
-enum class SIPFrequency {
-    WEEKLY,
-    MONTHLY,
-    QUARTERLY
-};
+#define SIP_FREQUENCY_VALUES(X) X(WEEKLY) X(MONTHLY) X(QUARTERLY)
+enum class SIPFrequency { SIP_FREQUENCY_VALUES(SIP_ENUM_VALUE) };
+SIP_DEFINE_ENUM_CONVERSIONS(SIPFrequency, SIP_FREQUENCY_VALUES)
 
 // SIP State - lifecycle states of an SIP
-enum class SIPState {
-    ACTIVE,
-    PAUSED,
-    STOPPED
-};
+#define SIP_STATE_VALUES(X) X(ACTIVE) X(PAUSED) X(STOPPED)
+enum class SIPState { SIP_STATE_VALUES(SIP_ENUM_VALUE) };
+SIP_DEFINE_ENUM_CONVERSIONS(SIPState, SIP_STATE_VALUES)
 
 // Payment Status - status of a payment transaction
-enum class PaymentStatus {
-    PENDING,
-    SUCCESS,
-    FAILURE
-};
+#define PAYMENT_STATUS_VALUES(X) X(PENDING) X(SUCCESS) X(FAILURE)
+enum class PaymentStatus { PAYMENT_STATUS_VALUES(SIP_ENUM_VALUE) };
+SIP_DEFINE_ENUM_CONVERSIONS(PaymentStatus, PAYMENT_STATUS_VALUES)
 
 // Transaction Type - type of transaction
-enum class TransactionType {
-    INSTALLMENT,
-    LUMP_SUM
-};
+#define TRANSACTION_TYPE_VALUES(X) X(INSTALLMENT) X(LUMP_SUM)
+enum class TransactionType { TRANSACTION_TYPE_VALUES(SIP_ENUM_VALUE) };
+SIP_DEFINE_ENUM_CONVERSIONS(TransactionType, TRANSACTION_TYPE_VALUES)
 
 // Risk Level for mutual funds
-enum class RiskLevel {
-    LOW,
-    MEDIUM,
-    HIGH
-};
+#define RISK_LEVEL_VALUES(X) X(LOW) X(MEDIUM) X(HIGH)
+enum class RiskLevel { RISK_LEVEL_VALUES(SIP_ENUM_VALUE) };
+SIP_DEFINE_ENUM_CONVERSIONS(RiskLevel, RISK_LEVEL_VALUES)
 
 // Fund Category
-enum class FundCategory {
-    EQUITY,
-    DEBT,
-    HYBRID,
-    ELSS
-};
-
-// Helper functions for string conversion
-inline std::string toString(SIPFrequency freq) {
-    switch (freq) {
-        case SIPFrequency::WEEKLY: return "WEEKLY";
-        case SIPFrequency::MONTHLY: return "MONTHLY";
-        case SIPFrequency::QUARTERLY: return "QUARTERLY";
-        default: return "UNKNOWN";
-    }
-}
-
-inline std::string toString(SIPState state) {
-    switch (state) {
-        case SIPState::ACTIVE: return "ACTIVE";
-        case SIPState::PAUSED: return "PAUSED";
-        case SIPState::STOPPED: return "STOPPED";
-        default: return "UNKNOWN";
-    }
-}
-
-inline std::string toString(PaymentStatus status) {
-    switch (status) {
-        case PaymentStatus::PENDING: return "PENDING";
-        case PaymentStatus::SUCCESS: return "SUCCESS";
-        case PaymentStatus::FAILURE: return "FAILURE";
-        default: return "UNKNOWN";
-    }
-}
-
-inline std::string toString(TransactionType type) {
-    switch (type) {
-        case TransactionType::INSTALLMENT: return "INSTALLMENT";
-        case TransactionType::LUMP_SUM: return "LUMP_SUM";
-        default: return "UNKNOWN";
-    }
-}
-
-inline std::string toString(RiskLevel level) {
-    switch (level) {
-        case RiskLevel::LOW: return "LOW";
-        case RiskLevel::MEDIUM: return "MEDIUM";
-        case RiskLevel::HIGH: return "HIGH";
-        default: return "UNKNOWN";
-    }
-}
-
-inline std::string toString(FundCategory category) {
-    switch (category) {
-        case FundCategory::EQUITY: return "EQUITY";
-        case FundCategory::DEBT: return "DEBT";
-        case FundCategory::HYBRID: return "HYBRID";
-        case FundCategory::ELSS: return "ELSS";
-        default: return "UNKNOWN";
-    }
-}
+#define FUND_CATEGORY_VALUES(X) X(EQUITY) X(DEBT) X(HYBRID) X(ELSS)
+enum class FundCategory { FUND_CATEGORY_VALUES(SIP_ENUM_VALUE) };
+SIP_DEFINE_ENUM_CONVERSIONS(FundCategory, FUND_CATEGORY_VALUES)
+
+// Business-day adjustment applied to scheduled execution dates
+//   NONE               - execute on the calendar date even if it is a weekend
+//   FOLLOWING          - move weekend dates to the next Monday
+//   PRECEDING          - move weekend dates to the previous Friday
+//   MODIFIED_FOLLOWING - FOLLOWING, unless that crosses into the next month
+#define BUSINESS_DAY_RULE_VALUES(X) X(NONE) X(FOLLOWING) X(PRECEDING) X(MODIFIED_FOLLOWING)
+enum class BusinessDayRule { BUSINESS_DAY_RULE_VALUES(SIP_ENUM_VALUE) };
+SIP_DEFINE_ENUM_CONVERSIONS(BusinessDayRule, BUSINESS_DAY_RULE_VALUES)
 
 } // namespace sip
 
@@ -0,0 +1,75 @@
+#ifndef HOLDING_H
+#define HOLDING_H
+
+#include <string>
+#include "../utils/BufferWriter.h"
+
+namespace sip {
+
+/**
+ * Consolidated position of one user in one fund, across all of the user's
+ * SIPs into that fund.
+ */
+class Holding {
+private:
+    std::string userId;
+    std::string fundId;
+    double units;
+    double investedAmount;  // Cost basis: sum of successful payments
+    int purchaseCount;
+
+public:
+    Holding() : units(0.0), investedAmount(0.0), purchaseCount(0) {}
+
+    Holding(const std::string& userId, const std::string& fundId)
+        : userId(userId), fundId(fundId), units(0.0), investedAmount(0.0), purchaseCount(0) {}
+
+    /**
+     * Holding IDs are "<userId>|<fundId>".
+     */
+    static std::string makeId(const std::string& userId, const std::string& fundId) {
+        std::string id;
+        id.reserve(userId.size() + 1 + fundId.size());
+        id.append(userId).append(1, '|').append(fundId);
+        return id;
+    }
+
+    // Getters
+    std::string getId() const { return makeId(userId, fundId); }
+    const std::string& getUserId() const { return userId; }
+    const std::string& getFundId() const { return fundId; }
+    double getUnits() const { return units; }
+    double getInvestedAmount() const { return investedAmount; }
+    int getPurchaseCount() const { return purchaseCount; }
+
+    // Setters
+    void setUserId(const std::string& userId) { this->userId = userId; }
+    void setFundId(const std::string& fundId) { this->fundId = fundId; }
+    void setUnits(double units) { this->units = units; }
+    void setInvestedAmount(double amount) { this->investedAmount = amount; }
+    void setPurchaseCount(int count) { this->purchaseCount = count; }
+
+    // Record a successful purchase of units
+    void addPurchase(double amount, double purchasedUnits) {
+        investedAmount += amount;
+        units += purchasedUnits;
+        purchaseCount++;
+    }
+
+    // Display helpers
+    void formatTo(BufferWriter& out) const {
+        out.append("Holding{userId=").append(userId)
+           .append(", fundId=").append(fundId)
+           .append(", units=").appendFixed(units)
+           .append(", investedAmount=").appendFixed(investedAmount)
+           .append(", purchaseCount=").appendInt(purchaseCount).append('}');
+    }
+
+    std::string toString() const {
+        return formatToString(*this);
+    }
+};
+
+} // namespace sip
+
+#endif // HOLDING_H
@@ -0,0 +1,82 @@
+#ifndef MARKET_SCENARIO_H
+#define MARKET_SCENARIO_H
+
+#include <string>
+#include <unordered_map>
+#include "Enums.h"
+
+namespace sip {
+
+/**
+ * A hypothetical market move, as NAV shocks in decimal form
+ * (0.05 = +5%, -0.10 = -10%, as in simulateMarketMovement).
+ *
+ * The most specific shock wins: a fund shock overrides its category's shock,
+ * which overrides the market-wide shock. ScenarioTransform applies a
+ * scenario to a NavSnapshot.
+ */
+class MarketScenario {
+private:
+    std::string name;
+    double marketShock;
+    double categoryShocks[kFundCategoryCount];
+    bool hasCategoryShock[kFundCategoryCount];
+    std::unordered_map<std::string, double> fundShocks;
+
+public:
+    explicit MarketScenario(const std::string& name = "scenario") : name(name), marketShock(0.0) {
+        for (size_t i = 0; i < kFundCategoryCount; ++i) {
+            categoryShocks[i] = 0.0;
+            hasCategoryShock[i] = false;
+        }
+    }
+
+    const std::string& getName() const { return name; }
+    double getMarketShock() const { return marketShock; }
+    const std::unordered_map<std::string, double>& getFundShocks() const { return fundShocks; }
+
+    // Shock every fund
+    MarketScenario& shockMarket(double shock) {
+        marketShock = shock;
+        return *this;
+    }
+
+    // Shock every fund in a category
+    MarketScenario& shockCategory(FundCategory category, double shock) {
+        size_t index = static_cast<size_t>(category);
+        if (index < kFundCategoryCount) {
+            categoryShocks[index] = shock;
+            hasCategoryShock[index] = true;
+        }
+        return *this;
+    }
+
+    // Shock one fund
+    MarketScenario& shockFund(const std::string& fundId, double shock) {
+        fundShocks[fundId] = shock;
+        return *this;
+    }
+
+    /**
+     * Shock that applies to a fund of the given category, ignoring fund-level shocks.
+     */
+    double shockForCategory(FundCategory category) const {
+        size_t index = static_cast<size_t>(category);
+        if (index < kFundCategoryCount && hasCategoryShock[index]) {
+            return categoryShocks[index];
+        }
+        return marketShock;
+    }
+
+    /**
+     * Shock that applies to a fund.
+     */
+    double shockForFund(const std::string& fundId, FundCategory category) const {
+        auto it = fundShocks.find(fundId);
+        return it != fundShocks.end() ? it->second : shockForCategory(category);
+    }
+};
+
+} // namespace sip
+
+#endif // MARKET_SCENARIO_H
@@ -3,6 +3,7 @@
 
 #include <string>
 #include "Enums.h"
+#include "../utils/BufferWriter.h"
 
 namespace sip {
 
@@ -35,12 +36,17 @@ public:
     void setRiskLevel(RiskLevel riskLevel) { this->riskLevel = riskLevel; }
     void setNav(double nav) { this->nav = nav; }
 
-    // Display helper
+    // Display helpers
+    void formatTo(BufferWriter& out) const {
+        out.append("MutualFund{id=").append(id)
+           .append(", name=").append(name)
+           .append(", category=").append(sip::toName(category))
+           .append(", riskLevel=").append(sip::toName(riskLevel))
+           .append(", nav=").appendFixed(nav).append('}');
+    }
+
     std::string toString() const {
-        return "MutualFund{id=" + id + ", name=" + name + 
-               ", category=" + sip::toString(category) + 
-               ", riskLevel=" + sip::toString(riskLevel) + 
-               ", nav=" + std::to_string(nav) + "}";
+        return formatToString(*this);
     }
 };
 
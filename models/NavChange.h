@@ -0,0 +1,40 @@
+#ifndef NAV_CHANGE_H
+#define NAV_CHANGE_H
+
+#include "../utils/IdInterner.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sip {
+
+/**
+ * A fund's NAV after a price update.
+ */
+struct NavChange {
+    uint32_t fundHandle;  // See IdInterner::funds()
+    double nav;
+
+    const std::string& fundId() const {
+        return IdInterner::funds().idOf(fundHandle);
+    }
+};
+
+/**
+ * Funds whose NAV changed in NAV versions firstVersion..version, at most one
+ * entry per fund (its NAV as of `version`), in fund handle order.
+ */
+struct NavChangeBatch {
+    uint64_t firstVersion;
+    uint64_t version;
+    std::vector<NavChange> changes;
+
+    NavChangeBatch() : firstVersion(0), version(0) {}
+};
+
+typedef std::function<void(const NavChangeBatch&)> NavChangeListener;
+
+} // namespace sip
+
+#endif // NAV_CHANGE_H
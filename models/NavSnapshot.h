@@ -0,0 +1,33 @@
+#ifndef NAV_SNAPSHOT_H
+#define NAV_SNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Point-in-time NAVs for every fund, indexed by fund handle
+ * (see IdInterner::funds()). A NAV of 0 means "no price".
+ */
+struct NavSnapshot {
+    uint64_t version;
+    std::vector<double> navs;
+
+    NavSnapshot() : version(0) {}
+
+    double getNav(uint32_t fundHandle) const {
+        return fundHandle < navs.size() ? navs[fundHandle] : 0.0;
+    }
+
+    void setNav(uint32_t fundHandle, double nav) {
+        if (fundHandle >= navs.size()) {
+            navs.resize(static_cast<size_t>(fundHandle) + 1, 0.0);
+        }
+        navs[fundHandle] = nav;
+    }
+};
+
+} // namespace sip
+
+#endif // NAV_SNAPSHOT_H
@@ -0,0 +1,50 @@
+#ifndef PURCHASE_ORDER_H
+#define PURCHASE_ORDER_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace sip {
+
+using Date = std::chrono::system_clock::time_point;
+
+/**
+ * One fund's purchases for one cut-off, submitted to the AMC/RTA as a
+ * single order in place of the installments it covers.
+ */
+struct PurchaseOrder {
+    std::string id;
+    std::string fundId;
+    Date cutOff;
+    double amount;            // Sum of the installment amounts
+    size_t installmentCount;
+};
+
+/**
+ * An installment rolled into a purchase order.
+ */
+struct OrderMember {
+    std::string transactionId;
+    std::string sipId;
+    std::string userId;
+};
+
+/**
+ * Units allotted against an order, split across its installments in
+ * proportion to their amounts: units[i] belongs to members[i], who paid
+ * amounts[i].
+ */
+struct OrderAllocation {
+    PurchaseOrder order;
+    double nav;
+    double allottedUnits;
+    std::vector<OrderMember> members;
+    std::vector<double> amounts;
+    std::vector<double> units;
+};
+
+} // namespace sip
+
+#endif // PURCHASE_ORDER_H
@@ -0,0 +1,32 @@
+#ifndef RETURN_ASSUMPTION_H
+#define RETURN_ASSUMPTION_H
+
+#include "Enums.h"
+
+namespace sip {
+
+/**
+ * Annual return assumption for a fund category, in decimal form
+ * (0.12 = 12% expected return per year).
+ */
+struct ReturnAssumption {
+    double expectedReturn;
+    double volatility;
+
+    /**
+     * Long-run assumption used when none has been configured.
+     */
+    static ReturnAssumption defaultFor(FundCategory category) {
+        switch (category) {
+            case FundCategory::DEBT: return ReturnAssumption{0.07, 0.03};
+            case FundCategory::HYBRID: return ReturnAssumption{0.10, 0.10};
+            case FundCategory::ELSS: return ReturnAssumption{0.13, 0.20};
+            case FundCategory::EQUITY:
+            default: return ReturnAssumption{0.12, 0.18};
+        }
+    }
+};
+
+} // namespace sip
+
+#endif // RETURN_ASSUMPTION_H
@@ -4,6 +4,7 @@
 #include <string>
 #include <chrono>
 #include "Enums.h"
+#include "../utils/BufferWriter.h"
 
 namespace sip {
 
@@ -59,14 +60,20 @@ public:
     // Increment installment count
     void incrementInstallmentCount() { ++installmentCount; }
 
-    // Display helper
+    // Display helpers
+    void formatTo(BufferWriter& out) const {
+        out.append("SIP{id=").append(id)
+           .append(", userId=").append(userId)
+           .append(", fundId=").append(fundId)
+           .append(", baseAmount=").appendFixed(baseAmount)
+           .append(", frequency=").append(sip::toName(frequency))
+           .append(", state=").append(sip::toName(state))
+           .append(", installmentCount=").appendInt(installmentCount)
+           .append(", stepUpPercentage=").appendFixed(stepUpPercentage).append("%}");
+    }
+
     std::string toString() const {
-        return "SIP{id=" + id + ", userId=" + userId + ", fundId=" + fundId +
-               ", baseAmount=" + std::to_string(baseAmount) +
-               ", frequency=" + sip::toString(frequency) +
-               ", state=" + sip::toString(state) +
-               ", installmentCount=" + std::to_string(installmentCount) +
-               ", stepUpPercentage=" + std::to_string(stepUpPercentage) + "%}";
+        return formatToString(*this);
     }
 };
 
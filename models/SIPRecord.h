@@ -0,0 +1,97 @@
+#ifndef SIP_RECORD_H
+#define SIP_RECORD_H
+
+#include "SIP.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace sip {
+
+/**
+ * Dense handle of an SIP inside a repository (index into its record arrays).
+ */
+using SIPHandle = uint32_t;
+
+/**
+ * Fields read by due-date scanning and installment execution.
+ * Packed to 4-byte alignment so a record is 28 bytes and the scheduler's
+ * working set stays small (10M SIPs ~ 280 MB). nextExecutionTime is whole
+ * seconds since the Unix epoch; fundHandle comes from IdInterner::funds().
+ */
+#pragma pack(push, 4)
+struct SIPHotRecord {
+    double baseAmount;
+    double stepUpPercentage;
+    uint32_t nextExecutionTime;
+    uint32_t fundHandle;
+    uint16_t installmentCount;
+    uint8_t state;      // SIPState, or kVacant for a free slot
+    uint8_t frequency;  // SIPFrequency
+
+    static const uint8_t kVacant = 0xFF;
+
+    SIPState getState() const { return static_cast<SIPState>(state); }
+    SIPFrequency getFrequency() const { return static_cast<SIPFrequency>(frequency); }
+    bool isVacant() const { return state == kVacant; }
+
+    static uint32_t toTime(Date date) {
+        long long seconds = std::chrono::duration_cast<std::chrono::seconds>(
+            date.time_since_epoch()).count();
+        if (seconds < 0) return 0;
+        if (seconds > 0xFFFFFFFFLL) return 0xFFFFFFFFu;
+        return static_cast<uint32_t>(seconds);
+    }
+
+    static Date toDate(uint32_t time) {
+        return Date(std::chrono::duration_cast<Date::duration>(std::chrono::seconds(time)));
+    }
+};
+#pragma pack(pop)
+
+static_assert(sizeof(SIPHotRecord) < 32, "SIPHotRecord must stay under 32 bytes");
+
+/**
+ * Identity and metadata fields that the scheduler does not scan.
+ */
+struct SIPColdRecord {
+    std::string id;
+    std::string userId;
+    std::string fundId;
+    Date startDate;
+};
+
+/**
+ * Split an SIP into its hot and cold records.
+ */
+inline void splitSIP(const SIP& sip, uint32_t fundHandle, SIPHotRecord& hot, SIPColdRecord& cold) {
+    hot.baseAmount = sip.getBaseAmount();
+    hot.stepUpPercentage = sip.getStepUpPercentage();
+    hot.nextExecutionTime = SIPHotRecord::toTime(sip.getNextExecutionDate());
+    hot.fundHandle = fundHandle;
+    int count = sip.getInstallmentCount();
+    hot.installmentCount = static_cast<uint16_t>(count < 0 ? 0 : (count > 0xFFFF ? 0xFFFF : count));
+    hot.state = static_cast<uint8_t>(sip.getState());
+    hot.frequency = static_cast<uint8_t>(sip.getFrequency());
+
+    cold.id = sip.getId();
+    cold.userId = sip.getUserId();
+    cold.fundId = sip.getFundId();
+    cold.startDate = sip.getStartDate();
+}
+
+/**
+ * Reassemble an SIP from its hot and cold records.
+ */
+inline SIP assembleSIP(const SIPHotRecord& hot, const SIPColdRecord& cold) {
+    SIP sip(cold.id, cold.userId, cold.fundId, hot.baseAmount, hot.getFrequency(),
+            cold.startDate, hot.stepUpPercentage);
+    sip.setState(hot.getState());
+    sip.setNextExecutionDate(SIPHotRecord::toDate(hot.nextExecutionTime));
+    sip.setInstallmentCount(hot.installmentCount);
+    return sip;
+}
+
+} // namespace sip
+
+#endif // SIP_RECORD_H
@@ -4,6 +4,7 @@
 #include <string>
 #include <chrono>
 #include "Enums.h"
+#include "../utils/BufferWriter.h"
 
 namespace sip {
 
@@ -20,6 +21,7 @@ private:
     Date date;
     TransactionType type;
     bool callbackProcessed;  // For idempotent callback processing
+    std::string mandateId;   // Netted debit that paid this installment; empty if paid on its own
 
 public:
     Transaction() : amount(0.0), units(0.0), nav(0.0), 
@@ -47,6 +49,7 @@ public:
     Date getDate() const { return date; }
     TransactionType getType() const { return type; }
     bool isCallbackProcessed() const { return callbackProcessed; }
+    const std::string& getMandateId() const { return mandateId; }
 
     // Setters
     void setId(const std::string& id) { this->id = id; }
@@ -58,6 +61,7 @@ public:
     void setDate(Date date) { this->date = date; }
     void setType(TransactionType type) { this->type = type; }
     void setCallbackProcessed(bool processed) { this->callbackProcessed = processed; }
+    void setMandateId(const std::string& mandateId) { this->mandateId = mandateId; }
 
     // Recalculate units based on amount and NAV
     void calculateUnits() {
@@ -66,14 +70,19 @@ public:
         }
     }
 
-    // Display helper
+    // Display helpers
+    void formatTo(BufferWriter& out) const {
+        out.append("Transaction{id=").append(id)
+           .append(", sipId=").append(sipId)
+           .append(", amount=").appendFixed(amount)
+           .append(", units=").appendFixed(units)
+           .append(", nav=").appendFixed(nav)
+           .append(", status=").append(sip::toName(status))
+           .append(", type=").append(sip::toName(type)).append('}');
+    }
+
     std::string toString() const {
-        return "Transaction{id=" + id + ", sipId=" + sipId +
-               ", amount=" + std::to_string(amount) +
-               ", units=" + std::to_string(units) +
-               ", nav=" + std::to_string(nav) +
-               ", status=" + sip::toString(status) +
-               ", type=" + sip::toString(type) + "}";
+        return formatToString(*this);
     }
 };
 
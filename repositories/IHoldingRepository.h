@@ -0,0 +1,35 @@
+#ifndef IHOLDING_REPOSITORY_H
+#define IHOLDING_REPOSITORY_H
+
+#include "IRepository.h"
+#include "../models/Holding.h"
+#include <vector>
+
+namespace sip {
+
+/**
+ * Repository interface for consolidated (user, fund) holdings.
+ * Extends IRepository with holding-specific query and update methods.
+ */
+class IHoldingRepository : public IRepository<Holding> {
+public:
+    virtual ~IHoldingRepository() = default;
+
+    // Get all of a user's holdings, ordered by fund ID
+    virtual std::vector<Holding> getByUserId(const std::string& userId) const = 0;
+
+    // Get the holding for a (user, fund) pair; nullptr if the user never bought the fund
+    virtual std::shared_ptr<Holding> getByUserAndFund(const std::string& userId,
+                                                      const std::string& fundId) const = 0;
+
+    // Add a successful purchase to the (user, fund) holding, creating it if needed
+    virtual void recordPurchase(const std::string& userId, const std::string& fundId,
+                                double amount, double units) = 0;
+
+    // Multiply the units of every holding in a fund (split or bonus); cost basis is unchanged
+    virtual void scaleUnits(const std::string& fundId, double multiplier) = 0;
+};
+
+} // namespace sip
+
+#endif // IHOLDING_REPOSITORY_H
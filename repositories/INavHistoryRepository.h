@@ -0,0 +1,83 @@
+#ifndef INAV_HISTORY_REPOSITORY_H
+#define INAV_HISTORY_REPOSITORY_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace sip {
+
+using Date = std::chrono::system_clock::time_point;
+
+/**
+ * A fund's NAV on one day.
+ */
+struct NavPoint {
+    Date date;
+    double nav;
+
+    NavPoint() : nav(0) {}
+    NavPoint(Date date, double nav) : date(date), nav(nav) {}
+};
+
+/**
+ * Repository interface for per-fund NAV history.
+ * Series are append-only: at most one NAV per fund per day, in date order.
+ */
+class INavHistoryRepository {
+public:
+    virtual ~INavHistoryRepository() = default;
+
+    /**
+     * Record a fund's NAV for a day. Recording the latest day again
+     * replaces that day's NAV (a corrected publication).
+     * @throws ValidationException if nav is not positive or date is before
+     *         the fund's latest NAV
+     */
+    virtual void append(const std::string& fundId, Date date, double nav) = 0;
+
+    /**
+     * Record one day's NAV for many funds (a daily NAV file).
+     * navs[i] belongs to fundIds[i]. Nothing is recorded if any entry is invalid.
+     * @throws ValidationException as for append
+     */
+    virtual void appendAll(Date date, const std::vector<std::string>& fundIds,
+                           const std::vector<double>& navs) = 0;
+
+    /**
+     * Record NAVs dated individually (a NAV file in which some schemes
+     * carry an older date). navs[i] belongs to fundIds[i] on dates[i].
+     * Nothing is recorded if any entry is invalid.
+     * @throws ValidationException as for append
+     */
+    virtual void appendAll(const std::vector<Date>& dates, const std::vector<std::string>& fundIds,
+                           const std::vector<double>& navs) = 0;
+
+    /**
+     * Multiply every recorded NAV of many funds: factors[i] applies to
+     * fundIds[i] (e.g. 0.1 after a 1:10 split, so past NAVs stay comparable
+     * with the new ones). Funds without history are skipped.
+     * @throws ValidationException if the columns differ in length or any
+     *         factor is not positive; nothing is changed in either case
+     */
+    virtual void adjustNAVs(const std::vector<std::string>& fundIds, const std::vector<double>& factors) = 0;
+
+    /**
+     * NAV in effect on a date: the latest NAV recorded on or before it.
+     * Returns 0 if the fund has no NAV on or before the date.
+     */
+    virtual double getNAV(const std::string& fundId, Date date) const = 0;
+
+    // Get a fund's NAVs with from <= date <= to, in date order
+    virtual std::vector<NavPoint> getRange(const std::string& fundId, Date from, Date to) const = 0;
+
+    // Number of NAVs stored for a fund
+    virtual size_t getPointCount(const std::string& fundId) const = 0;
+
+    // Number of funds with at least one NAV
+    virtual size_t getFundCount() const = 0;
+};
+
+} // namespace sip
+
+#endif // INAV_HISTORY_REPOSITORY_H
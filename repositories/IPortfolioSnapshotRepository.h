@@ -0,0 +1,62 @@
+#ifndef IPORTFOLIO_SNAPSHOT_REPOSITORY_H
+#define IPORTFOLIO_SNAPSHOT_REPOSITORY_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace sip {
+
+using Date = std::chrono::system_clock::time_point;
+
+/**
+ * One day's valuation of a user's portfolio.
+ */
+struct PortfolioValuePoint {
+    Date date;
+    double currentValue;
+    double totalInvested;
+
+    PortfolioValuePoint() : currentValue(0), totalInvested(0) {}
+
+    PortfolioValuePoint(Date date, double currentValue, double totalInvested)
+        : date(date), currentValue(currentValue), totalInvested(totalInvested) {}
+};
+
+/**
+ * Repository interface for daily portfolio value time series.
+ * Series are append-only: one point per user per day, in date order.
+ */
+class IPortfolioSnapshotRepository {
+public:
+    virtual ~IPortfolioSnapshotRepository() = default;
+
+    /**
+     * Append a user's valuation for a day. Appending the latest day again
+     * replaces that day's point (a re-run of the nightly job).
+     * @throws ValidationException if date is before the user's latest point
+     */
+    virtual void append(const std::string& userId, Date date,
+                        double currentValue, double totalInvested) = 0;
+
+    /**
+     * Append one day's valuation for many users (the nightly job).
+     * currentValues[i] and investedAmounts[i] belong to userIds[i].
+     */
+    virtual void appendAll(Date date, const std::vector<std::string>& userIds,
+                           const std::vector<double>& currentValues,
+                           const std::vector<double>& investedAmounts) = 0;
+
+    // Get a user's points with from <= date <= to, in date order
+    virtual std::vector<PortfolioValuePoint> getRange(const std::string& userId, Date from, Date to) const = 0;
+
+    // Number of points stored for a user
+    virtual size_t getPointCount(const std::string& userId) const = 0;
+
+    // Number of users with at least one point
+    virtual size_t getUserCount() const = 0;
+};
+
+} // namespace sip
+
+#endif // IPORTFOLIO_SNAPSHOT_REPOSITORY_H
@@ -3,11 +3,32 @@
 
 #include "IRepository.h"
 #include "../models/SIP.h"
+#include "../models/SIPRecord.h"
 #include "../models/Enums.h"
+#include <functional>
 #include <vector>
 
 namespace sip {
 
+/**
+ * Hot record of an SIP that is due, with the handle to reach its cold record.
+ */
+struct DueSIPRecord {
+    SIPHandle handle;
+    SIPHotRecord hot;
+};
+
+/**
+ * Read-only view of a stored SIP, valid only for the duration of a visit.
+ */
+struct SIPRecordView {
+    SIPHandle handle;
+    const SIPHotRecord& hot;
+    const SIPColdRecord& cold;
+};
+
+using SIPRecordVisitor = std::function<void(const SIPRecordView&)>;
+
 /**
  * Repository interface for SIP entities.
  * Extends IRepository with SIP-specific query methods.
@@ -19,6 +40,15 @@ public:
     // Get all SIPs for a specific user
     virtual std::vector<SIP> getByUserId(const std::string& userId) const = 0;
 
+    // Visit a user's SIPs in place, without materializing SIP objects
+    virtual void forEachByUserId(const std::string& userId, const SIPRecordVisitor& visitor) const = 0;
+
+    // Visit every stored SIP in place (batch jobs), without materializing SIP objects
+    virtual void forEachSIP(const SIPRecordVisitor& visitor) const = 0;
+
+    // forEachSIP with each user's SIPs visited consecutively (users in no particular order)
+    virtual void forEachSIPByUser(const SIPRecordVisitor& visitor) const = 0;
+
     // Get all SIPs for a specific fund
     virtual std::vector<SIP> getByFundId(const std::string& fundId) const = 0;
 
@@ -30,6 +60,15 @@ public:
 
     // Get all active SIPs that are due for execution on a given date
     virtual std::vector<SIP> getDueSIPs(Date asOfDate) const = 0;
+
+    // Hot-path variant of getDueSIPs: returns only the compact hot records
+    virtual std::vector<DueSIPRecord> getDueRecords(Date asOfDate) const = 0;
+
+    // Get the SIP ID behind a handle (empty if the handle is not in use)
+    virtual std::string getIdByHandle(SIPHandle handle) const = 0;
+
+    // Get the user ID of the SIP behind a handle (empty if the handle is not in use)
+    virtual std::string getUserIdByHandle(SIPHandle handle) const = 0;
 };
 
 } // namespace sip
@@ -8,6 +8,17 @@
 
 namespace sip {
 
+/**
+ * Running totals of an SIP's successful transactions.
+ */
+struct SIPTransactionTotals {
+    double totalInvested;
+    double totalUnits;
+    int successfulCount;
+
+    SIPTransactionTotals() : totalInvested(0), totalUnits(0), successfulCount(0) {}
+};
+
 /**
  * Repository interface for Transaction entities.
  * Extends IRepository with transaction-specific query methods.
@@ -19,11 +30,20 @@ public:
     // Get all transactions for a specific SIP
     virtual std::vector<Transaction> getBySipId(const std::string& sipId) const = 0;
 
+    // Get the installments paid by one netted mandate debit
+    virtual std::vector<Transaction> getByMandateId(const std::string& mandateId) const = 0;
+
     // Get transactions by status
     virtual std::vector<Transaction> getByStatus(PaymentStatus status) const = 0;
 
     // Get successful transactions for a SIP (for calculating totals)
     virtual std::vector<Transaction> getSuccessfulBySipId(const std::string& sipId) const = 0;
+
+    // Get totals of successful transactions for a SIP without copying them
+    virtual SIPTransactionTotals getSuccessfulTotalsBySipId(const std::string& sipId) const = 0;
+
+    // Multiply the units of a SIP's transactions and divide their NAVs (split or bonus); amounts are unchanged
+    virtual void scaleUnits(const std::string& sipId, double multiplier) = 0;
 };
 
 } // namespace sip
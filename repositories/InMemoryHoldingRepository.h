@@ -0,0 +1,155 @@
+#ifndef INMEMORY_HOLDING_REPOSITORY_H
+#define INMEMORY_HOLDING_REPOSITORY_H
+
+#include "IHoldingRepository.h"
+#include <map>
+#include <unordered_map>
+
+namespace sip {
+
+/**
+ * In-memory implementation of IHoldingRepository.
+ * Holdings are grouped by user (O(1) lookup) and ordered by fund within a user.
+ */
+class InMemoryHoldingRepository : public IHoldingRepository {
+private:
+    std::unordered_map<std::string, std::map<std::string, Holding>> storage;  // userId -> fundId -> holding
+    size_t holdingCount;
+
+    /**
+     * Split a "<userId>|<fundId>" holding ID. Returns false if malformed.
+     */
+    static bool splitId(const std::string& id, std::string& userId, std::string& fundId) {
+        size_t separator = id.find('|');
+        if (separator == std::string::npos) {
+            return false;
+        }
+        userId = id.substr(0, separator);
+        fundId = id.substr(separator + 1);
+        return true;
+    }
+
+    const Holding* find(const std::string& userId, const std::string& fundId) const {
+        auto user = storage.find(userId);
+        if (user == storage.end()) {
+            return nullptr;
+        }
+        auto fund = user->second.find(fundId);
+        return fund != user->second.end() ? &fund->second : nullptr;
+    }
+
+public:
+    InMemoryHoldingRepository() : holdingCount(0) {}
+
+    void add(const Holding& holding) override {
+        auto& funds = storage[holding.getUserId()];
+        auto result = funds.emplace(holding.getFundId(), holding);
+        if (result.second) {
+            holdingCount++;
+        } else {
+            result.first->second = holding;
+        }
+    }
+
+    std::shared_ptr<Holding> getById(const std::string& id) const override {
+        std::string userId, fundId;
+        if (!splitId(id, userId, fundId)) {
+            return nullptr;
+        }
+        return getByUserAndFund(userId, fundId);
+    }
+
+    std::vector<Holding> getAll() const override {
+        std::vector<Holding> result;
+        result.reserve(holdingCount);
+        for (const auto& user : storage) {
+            for (const auto& fund : user.second) {
+                result.push_back(fund.second);
+            }
+        }
+        return result;
+    }
+
+    bool update(const Holding& holding) override {
+        auto user = storage.find(holding.getUserId());
+        if (user == storage.end()) {
+            return false;
+        }
+        auto fund = user->second.find(holding.getFundId());
+        if (fund == user->second.end()) {
+            return false;
+        }
+        fund->second = holding;
+        return true;
+    }
+
+    bool remove(const std::string& id) override {
+        std::string userId, fundId;
+        if (!splitId(id, userId, fundId)) {
+            return false;
+        }
+        auto user = storage.find(userId);
+        if (user == storage.end() || user->second.erase(fundId) == 0) {
+            return false;
+        }
+        if (user->second.empty()) {
+            storage.erase(user);
+        }
+        holdingCount--;
+        return true;
+    }
+
+    bool exists(const std::string& id) const override {
+        std::string userId, fundId;
+        return splitId(id, userId, fundId) && find(userId, fundId) != nullptr;
+    }
+
+    size_t count() const override {
+        return holdingCount;
+    }
+
+    std::vector<Holding> getByUserId(const std::string& userId) const override {
+        std::vector<Holding> result;
+        auto user = storage.find(userId);
+        if (user != storage.end()) {
+            result.reserve(user->second.size());
+            for (const auto& fund : user->second) {
+                result.push_back(fund.second);
+            }
+        }
+        return result;
+    }
+
+    std::shared_ptr<Holding> getByUserAndFund(const std::string& userId,
+                                              const std::string& fundId) const override {
+        const Holding* holding = find(userId, fundId);
+        if (holding) {
+            return std::make_shared<Holding>(*holding);
+        }
+        return nullptr;
+    }
+
+    void recordPurchase(const std::string& userId, const std::string& fundId,
+                        double amount, double units) override {
+        auto& funds = storage[userId];
+        auto it = funds.find(fundId);
+        if (it == funds.end()) {
+            it = funds.emplace(fundId, Holding(userId, fundId)).first;
+            holdingCount++;
+        }
+        it->second.addPurchase(amount, units);
+    }
+
+    void scaleUnits(const std::string& fundId, double multiplier) override {
+        for (auto& user : storage) {
+            auto it = user.second.find(fundId);
+            if (it != user.second.end()) {
+                it->second.setUnits(it->second.getUnits() * multiplier);
+            }
+        }
+    }
+};
+
+} // namespace sip
+
+#endif // INMEMORY_HOLDING_REPOSITORY_H
@@ -0,0 +1,540 @@
+#ifndef INMEMORY_NAV_HISTORY_REPOSITORY_H
+#define INMEMORY_NAV_HISTORY_REPOSITORY_H
+
+#include "INavHistoryRepository.h"
+#include "../utils/DateUtils.h"
+#include "../utils/Exceptions.h"
+#include "../utils/MappedFile.h"
+#include "../utils/Varint.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <unistd.h>
+
+namespace sip {
+
+/**
+ * In-memory implementation of INavHistoryRepository, optionally journaled
+ * to an append-only file.
+ *
+ * Each fund's series is one compressed byte stream. A point is the zigzag
+ * varint day delta followed by the NAV's bits XORed with the previous NAV's
+ * (Gorilla-style): an unchanged NAV costs one byte, a changed one a tag byte
+ * plus only the bytes between the leading and trailing zero bytes of the
+ * XOR. NAVs are stored losslessly. Every kBlockPoints points a block index
+ * entry records the first day and the decoder state, so getNAV binary
+ * searches the blocks and decodes at most kBlockPoints points; the latest
+ * NAV is answered without decoding.
+ *
+ * With a journal path, every append is also written to the file in the same
+ * encoding (plus a one-off record naming each fund), as is every adjustment. An existing journal is
+ * memory-mapped and replayed on construction; a torn final record from a
+ * crash is truncated away.
+ */
+class InMemoryNavHistoryRepository : public INavHistoryRepository {
+public:
+    static const uint32_t kBlockPoints = 64;
+
+private:
+    static constexpr const char* kJournalMagic = "SIPNAVH1";
+    static const size_t kJournalMagicSize = 8;
+
+    // Journal record tags
+    enum JournalRecord : uint8_t {
+        kFundRecord = 1,   // varint id length, id bytes
+        kPointRecord = 2,  // varint fund index, encoded point
+        kAdjustRecord = 3  // varint fund index, varint factor bits
+    };
+
+    /**
+     * Decoder state: the last decoded point (or zeros before the first).
+     */
+    struct Cursor {
+        int day;
+        uint64_t navBits;
+
+        Cursor() : day(0), navBits(0) {}
+    };
+
+    struct Block {
+        int firstDay;
+        size_t offset;  // Byte offset of the block's first point
+        Cursor before;  // State before decoding that point
+    };
+
+    struct Series {
+        std::vector<uint8_t> bytes;
+        std::vector<Block> blocks;
+        uint32_t count;
+        Cursor last;
+        size_t lastOffset;  // Byte offset of the last point, for same-day replacement
+        Cursor beforeLast;
+
+        int64_t journalIndex;  // Fund's index in the journal, -1 until written
+        Cursor journalLast;    // Last point written to the journal
+
+        Series() : count(0), lastOffset(0), journalIndex(-1) {}
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Series> storage;
+    std::FILE* journal;
+    int64_t journalFundCount;
+    std::vector<uint8_t> journalBuffer;
+
+    static uint64_t toBits(double nav) {
+        uint64_t bits;
+        std::memcpy(&bits, &nav, sizeof(bits));
+        return bits;
+    }
+
+    static double fromBits(uint64_t bits) {
+        double nav;
+        std::memcpy(&nav, &bits, sizeof(nav));
+        return nav;
+    }
+
+    static void encodePoint(std::vector<uint8_t>& out, const Cursor& previous, int day, uint64_t navBits) {
+        Varint::appendSigned(out, static_cast<int64_t>(day) - previous.day);
+        uint64_t changed = navBits ^ previous.navBits;
+        if (changed == 0) {
+            out.push_back(0);
+            return;
+        }
+        int leading = 0;
+        while ((changed >> (56 - 8 * leading)) == 0) {
+            leading++;
+        }
+        int trailing = 0;
+        while (((changed >> (8 * trailing)) & 0xFF) == 0) {
+            trailing++;
+        }
+        out.push_back(static_cast<uint8_t>(1 + leading * 8 + trailing));
+        changed >>= 8 * trailing;
+        for (int i = 0; i < 8 - leading - trailing; ++i) {
+            out.push_back(static_cast<uint8_t>(changed));
+            changed >>= 8;
+        }
+    }
+
+    static bool decodePoint(const uint8_t* data, size_t size, size_t& pos, Cursor& cursor) {
+        size_t at = pos;
+        int64_t dayDelta;
+        if (!Varint::readSigned(data, size, at, dayDelta) || at >= size) {
+            return false;
+        }
+        uint8_t tag = data[at++];
+        uint64_t changed = 0;
+        if (tag != 0) {
+            int leading = (tag - 1) / 8;
+            int trailing = (tag - 1) % 8;
+            int width = 8 - leading - trailing;
+            if (tag > 64 || width <= 0 || size - at < static_cast<size_t>(width)) {
+                return false;
+            }
+            for (int i = width - 1; i >= 0; --i) {
+                changed = (changed << 8) | data[at + static_cast<size_t>(i)];
+            }
+            changed <<= 8 * trailing;
+            at += static_cast<size_t>(width);
+        }
+        cursor.day += static_cast<int>(dayDelta);
+        cursor.navBits ^= changed;
+        pos = at;
+        return true;
+    }
+
+    static void appendPoint(Series& series, int day, uint64_t navBits) {
+        if (series.count > 0 && day < series.last.day) {
+            throw ValidationException("NAV history must be appended in date order");
+        }
+        if (series.count > 0 && day == series.last.day) {
+            // Replace the latest point: drop it and its block, if it started one
+            series.bytes.resize(series.lastOffset);
+            series.last = series.beforeLast;
+            series.count--;
+            if (series.count % kBlockPoints == 0) {
+                series.blocks.pop_back();
+            }
+        }
+
+        if (series.count % kBlockPoints == 0) {
+            series.blocks.push_back(Block{day, series.bytes.size(), series.last});
+        }
+        series.lastOffset = series.bytes.size();
+        series.beforeLast = series.last;
+        encodePoint(series.bytes, series.last, day, navBits);
+        series.last.day = day;
+        series.last.navBits = navBits;
+        series.count++;
+    }
+
+    /**
+     * Last block whose first day is on or before day (the first block if none).
+     */
+    static std::vector<Block>::const_iterator findBlock(const Series& series, int day) {
+        auto block = std::upper_bound(series.blocks.begin(), series.blocks.end(), day,
+            [](int d, const Block& b) { return d < b.firstDay; });
+        return block == series.blocks.begin() ? block : block - 1;
+    }
+
+    /**
+     * Re-encode a series with every NAV multiplied by factor.
+     */
+    static void scaleSeries(Series& series, double factor) {
+        Series scaled;
+        scaled.journalIndex = series.journalIndex;
+        scaled.journalLast = series.journalLast;
+        size_t pos = 0;
+        Cursor point;
+        while (pos < series.bytes.size() && decodePoint(series.bytes.data(), series.bytes.size(), pos, point)) {
+            appendPoint(scaled, point.day, toBits(fromBits(point.navBits) * factor));
+        }
+        series = std::move(scaled);
+    }
+
+    /**
+     * Write the fund's record to journalBuffer the first time it is journaled.
+     */
+    void journalFund(const std::string& fundId, Series& series) {
+        if (series.journalIndex < 0) {
+            journalBuffer.push_back(kFundRecord);
+            Varint::append(journalBuffer, fundId.size());
+            journalBuffer.insert(journalBuffer.end(), fundId.begin(), fundId.end());
+            series.journalIndex = journalFundCount++;
+        }
+    }
+
+    /**
+     * Encode a point into journalBuffer (preceded by the fund's record the
+     * first time the fund is journaled); flushJournal writes the buffer out.
+     */
+    void encodeJournal(const std::string& fundId, Series& series, int day, uint64_t navBits) {
+        journalFund(fundId, series);
+        journalBuffer.push_back(kPointRecord);
+        Varint::append(journalBuffer, static_cast<uint64_t>(series.journalIndex));
+        encodePoint(journalBuffer, series.journalLast, day, navBits);
+        series.journalLast.day = day;
+        series.journalLast.navBits = navBits;
+    }
+
+    void flushJournal() {
+        bool written = std::fwrite(journalBuffer.data(), 1, journalBuffer.size(), journal) == journalBuffer.size() &&
+                       std::fflush(journal) == 0;
+        journalBuffer.clear();
+        if (!written) {
+            throw SIPSystemException("Failed to write NAV history journal");
+        }
+    }
+
+    /**
+     * Replay a mapped journal into storage. Returns the byte length of the
+     * complete records; anything after it is a torn write.
+     */
+    size_t replayJournal(const MappedFile& file) {
+        const uint8_t* data = file.data();
+        size_t size = file.size();
+        if (size < kJournalMagicSize && std::memcmp(data, kJournalMagic, size) == 0) {
+            return 0;  // Torn header: the journal was never written to
+        }
+        if (size < kJournalMagicSize || std::memcmp(data, kJournalMagic, kJournalMagicSize) != 0) {
+            throw SIPSystemException("Not a NAV history journal");
+        }
+
+        std::vector<Series*> funds;
+        size_t pos = kJournalMagicSize;
+        while (pos < size) {
+            size_t at = pos + 1;
+            if (data[pos] == kFundRecord) {
+                uint64_t length;
+                if (!Varint::read(data, size, at, length) || size - at < length) {
+                    break;
+                }
+                std::string fundId(reinterpret_cast<const char*>(data + at), static_cast<size_t>(length));
+                Series& series = storage[fundId];
+                series.journalIndex = static_cast<int64_t>(funds.size());
+                funds.push_back(&series);
+                at += static_cast<size_t>(length);
+            } else if (data[pos] == kPointRecord) {
+                uint64_t index;
+                if (!Varint::read(data, size, at, index) || index >= funds.size()) {
+                    break;
+                }
+                Series& series = *funds[static_cast<size_t>(index)];
+                Cursor point = series.journalLast;
+                if (!decodePoint(data, size, at, point)) {
+                    break;
+                }
+                appendPoint(series, point.day, point.navBits);
+                series.journalLast = point;
+            } else if (data[pos] == kAdjustRecord) {
+                uint64_t index;
+                uint64_t factorBits;
+                if (!Varint::read(data, size, at, index) || index >= funds.size() ||
+                    !Varint::read(data, size, at, factorBits)) {
+                    break;
+                }
+                scaleSeries(*funds[static_cast<size_t>(index)], fromBits(factorBits));
+            } else {
+                break;
+            }
+            pos = at;
+        }
+        journalFundCount = static_cast<int64_t>(funds.size());
+        return pos;
+    }
+
+    static void checkBatch(size_t dateCount, const std::vector<std::string>& fundIds,
+                           const std::vector<double>& navs) {
+        if (dateCount != fundIds.size() || navs.size() != fundIds.size()) {
+            throw ValidationException("NAV batch columns must have one entry per fund");
+        }
+        for (double nav : navs) {
+            if (!(nav > 0) || !std::isfinite(nav)) {
+                throw ValidationException("NAV must be positive");
+            }
+        }
+    }
+
+    /**
+     * Append a validated batch; dayOf(i) is the day of entry i.
+     * Caller holds mutex.
+     */
+    template <typename DayOf>
+    void appendBatch(const std::vector<std::string>& fundIds, const std::vector<double>& navs, DayOf dayOf) {
+        for (size_t i = 0; i < fundIds.size(); ++i) {
+            Series& series = storage[fundIds[i]];
+            int day = dayOf(i);
+            uint64_t navBits = toBits(navs[i]);
+            appendPoint(series, day, navBits);
+            if (journal) {
+                encodeJournal(fundIds[i], series, day, navBits);
+            }
+        }
+        if (journal) {
+            flushJournal();  // One write for the whole batch
+        }
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param journalPath If non-empty, history is loaded from and appended to
+     *                    this file (created if missing)
+     * @throws SIPSystemException if the journal cannot be read or written
+     */
+    explicit InMemoryNavHistoryRepository(const std::string& journalPath = "")
+        : journal(nullptr), journalFundCount(0) {
+        if (journalPath.empty()) {
+            return;
+        }
+        bool existing = MappedFile::exists(journalPath);
+        if (existing) {
+            size_t validLength;
+            size_t fileLength;
+            {
+                MappedFile file(journalPath);
+                fileLength = file.size();
+                validLength = fileLength == 0 ? 0 : replayJournal(file);
+            }
+            if (validLength < fileLength && ::truncate(journalPath.c_str(), static_cast<off_t>(validLength)) != 0) {
+                throw SIPSystemException("Cannot truncate NAV history journal: " + journalPath);
+            }
+            existing = validLength > 0;
+        }
+        journal = std::fopen(journalPath.c_str(), "ab");
+        if (!journal) {
+            throw SIPSystemException("Cannot open NAV history journal: " + journalPath);
+        }
+        if (!existing && (std::fwrite(kJournalMagic, 1, kJournalMagicSize, journal) != kJournalMagicSize ||
+                          std::fflush(journal) != 0)) {
+            throw SIPSystemException("Failed to write NAV history journal");
+        }
+    }
+
+    ~InMemoryNavHistoryRepository() override {
+        if (journal) {
+            std::fclose(journal);
+        }
+    }
+
+    InMemoryNavHistoryRepository(const InMemoryNavHistoryRepository&) = delete;
+    InMemoryNavHistoryRepository& operator=(const InMemoryNavHistoryRepository&) = delete;
+
+    void append(const std::string& fundId, Date date, double nav) override {
+        if (!(nav > 0) || !std::isfinite(nav)) {
+            throw ValidationException("NAV must be positive");
+        }
+        int day = DateUtils::toDayNumber(date);
+        uint64_t navBits = toBits(nav);
+        std::lock_guard<std::mutex> lock(mutex);
+        Series& series = storage[fundId];
+        appendPoint(series, day, navBits);
+        if (journal) {
+            encodeJournal(fundId, series, day, navBits);
+            flushJournal();
+        }
+    }
+
+    void appendAll(Date date, const std::vector<std::string>& fundIds,
+                   const std::vector<double>& navs) override {
+        checkBatch(fundIds.size(), fundIds, navs);
+        int day = DateUtils::toDayNumber(date);
+        std::lock_guard<std::mutex> lock(mutex);
+        // Check ordering before touching any series so a bad batch records nothing
+        for (const std::string& fundId : fundIds) {
+            auto it = storage.find(fundId);
+            if (it != storage.end() && it->second.count > 0 && day < it->second.last.day) {
+                throw ValidationException("NAV history must be appended in date order");
+            }
+        }
+        appendBatch(fundIds, navs, [day](size_t) { return day; });
+    }
+
+    void appendAll(const std::vector<Date>& dates, const std::vector<std::string>& fundIds,
+                   const std::vector<double>& navs) override {
+        checkBatch(dates.size(), fundIds, navs);
+        std::vector<int> days(dates.size());
+        for (size_t i = 0; i < dates.size(); ++i) {
+            days[i] = i > 0 && dates[i] == dates[i - 1] ? days[i - 1] : DateUtils::toDayNumber(dates[i]);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        // As above, but a fund listed twice must also be in order within the batch
+        std::unordered_map<std::string, int> latestDay;
+        for (size_t i = 0; i < fundIds.size(); ++i) {
+            auto seen = latestDay.find(fundIds[i]);
+            if (seen == latestDay.end()) {
+                auto it = storage.find(fundIds[i]);
+                int last = it != storage.end() && it->second.count > 0 ? it->second.last.day : days[i];
+                seen = latestDay.emplace(fundIds[i], last).first;
+            }
+            if (days[i] < seen->second) {
+                throw ValidationException("NAV history must be appended in date order");
+            }
+            seen->second = days[i];
+        }
+        appendBatch(fundIds, navs, [&days](size_t i) { return days[i]; });
+    }
+
+    void adjustNAVs(const std::vector<std::string>& fundIds, const std::vector<double>& factors) override {
+        if (factors.size() != fundIds.size()) {
+            throw ValidationException("NAV adjustment columns must have one entry per fund");
+        }
+        for (double factor : factors) {
+            if (!(factor > 0) || !std::isfinite(factor)) {
+                throw ValidationException("NAV adjustment factor must be positive");
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < fundIds.size(); ++i) {
+            auto it = storage.find(fundIds[i]);
+            if (it == storage.end() || it->second.count == 0) {
+                continue;
+            }
+            scaleSeries(it->second, factors[i]);
+            if (journal) {
+                journalFund(fundIds[i], it->second);
+                journalBuffer.push_back(kAdjustRecord);
+                Varint::append(journalBuffer, static_cast<uint64_t>(it->second.journalIndex));
+                Varint::append(journalBuffer, toBits(factors[i]));
+            }
+        }
+        if (journal && !journalBuffer.empty()) {
+            flushJournal();
+        }
+    }
+
+    double getNAV(const std::string& fundId, Date date) const override {
+        int day = DateUtils::toDayNumber(date);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = storage.find(fundId);
+        if (it == storage.end() || it->second.count == 0) {
+            return 0.0;
+        }
+        const Series& series = it->second;
+        if (day >= series.last.day) {
+            return fromBits(series.last.navBits);
+        }
+        if (day < series.blocks.front().firstDay) {
+            return 0.0;
+        }
+
+        auto block = findBlock(series, day);
+        size_t pos = block->offset;
+        Cursor cursor = block->before;
+        Cursor next = cursor;
+        while (decodePoint(series.bytes.data(), series.bytes.size(), pos, next) && next.day <= day) {
+            cursor = next;
+        }
+        return fromBits(cursor.navBits);
+    }
+
+    std::vector<NavPoint> getRange(const std::string& fundId, Date from, Date to) const override {
+        std::vector<NavPoint> result;
+        int fromDay = DateUtils::toDayNumber(from);
+        int toDay = DateUtils::toDayNumber(to);
+        if (toDay < fromDay) {
+            return result;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = storage.find(fundId);
+        if (it == storage.end() || it->second.count == 0) {
+            return result;
+        }
+        const Series& series = it->second;
+
+        auto block = findBlock(series, fromDay);
+        size_t pos = block->offset;
+        Cursor cursor = block->before;
+        std::vector<int> days;
+        while (decodePoint(series.bytes.data(), series.bytes.size(), pos, cursor)) {
+            if (cursor.day > toDay) {
+                break;
+            }
+            if (cursor.day >= fromDay) {
+                days.push_back(cursor.day);
+                result.emplace_back(Date(), fromBits(cursor.navBits));
+            }
+        }
+
+        std::vector<Date> dates(days.size());
+        DateUtils::fromDayNumbers(days.data(), days.size(), dates.data());
+        for (size_t i = 0; i < dates.size(); ++i) {
+            result[i].date = dates[i];
+        }
+        return result;
+    }
+
+    size_t getPointCount(const std::string& fundId) const override {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = storage.find(fundId);
+        return it != storage.end() ? it->second.count : 0;
+    }
+
+    size_t getFundCount() const override {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t funds = 0;
+        for (const auto& pair : storage) {
+            funds += pair.second.count > 0 ? 1 : 0;
+        }
+        return funds;
+    }
+
+    /**
+     * Compressed size of a fund's series in bytes (excluding the block index).
+     */
+    size_t getEncodedSize(const std::string& fundId) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = storage.find(fundId);
+        return it != storage.end() ? it->second.bytes.size() : 0;
+    }
+};
+
+} // namespace sip
+
+#endif // INMEMORY_NAV_HISTORY_REPOSITORY_H
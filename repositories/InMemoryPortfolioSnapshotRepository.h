@@ -0,0 +1,211 @@
+#ifndef INMEMORY_PORTFOLIO_SNAPSHOT_REPOSITORY_H
+#define INMEMORY_PORTFOLIO_SNAPSHOT_REPOSITORY_H
+
+#include "IPortfolioSnapshotRepository.h"
+#include "../utils/DateUtils.h"
+#include "../utils/Exceptions.h"
+#include "../utils/Varint.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace sip {
+
+/**
+ * In-memory implementation of IPortfolioSnapshotRepository.
+ *
+ * Each user's series is one compressed byte stream. A point is stored as
+ * three zigzag varints: the day-number delta and the deltas of current value
+ * and invested amount in paise. Consecutive daily points usually cost 4-8
+ * bytes. Every kCheckpointInterval points a checkpoint records the byte
+ * offset and running totals, so a range query seeks to the nearest
+ * checkpoint and then decodes forward sequentially.
+ */
+class InMemoryPortfolioSnapshotRepository : public IPortfolioSnapshotRepository {
+public:
+    static const uint32_t kCheckpointInterval = 256;
+
+private:
+    /**
+     * Decoder state: the last decoded point (or all zeros before the first).
+     */
+    struct Cursor {
+        int day;
+        int64_t valuePaise;
+        int64_t investedPaise;
+
+        Cursor() : day(0), valuePaise(0), investedPaise(0) {}
+    };
+
+    struct Checkpoint {
+        size_t offset;  // Byte offset of point index * kCheckpointInterval
+        Cursor before;  // State before decoding that point
+    };
+
+    struct Series {
+        std::vector<uint8_t> bytes;
+        std::vector<Checkpoint> checkpoints;
+        uint32_t count;
+        Cursor last;
+        size_t lastOffset;  // Byte offset of the last point, for same-day replacement
+        Cursor beforeLast;
+
+        Series() : count(0), lastOffset(0) {}
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Series> storage;
+
+    static int64_t toPaise(double amount) {
+        double paise = amount * 100.0;
+        // llround is undefined for NaN, infinities and values outside int64_t
+        if (!std::isfinite(paise) || std::fabs(paise) >= 9.2e18) {
+            throw ValidationException("Portfolio snapshot amounts must be finite");
+        }
+        return static_cast<int64_t>(std::llround(paise));
+    }
+
+    static void appendPoint(Series& series, int day, int64_t valuePaise, int64_t investedPaise) {
+        if (series.count > 0 && day < series.last.day) {
+            throw ValidationException("Portfolio snapshots must be appended in date order");
+        }
+        if (series.count > 0 && day == series.last.day) {
+            // Replace the latest point: drop it and its checkpoint, if it started one
+            series.bytes.resize(series.lastOffset);
+            series.last = series.beforeLast;
+            series.count--;
+            if (series.count % kCheckpointInterval == 0) {
+                series.checkpoints.pop_back();
+            }
+        }
+
+        if (series.count % kCheckpointInterval == 0) {
+            series.checkpoints.push_back(Checkpoint{series.bytes.size(), series.last});
+        }
+        series.lastOffset = series.bytes.size();
+        series.beforeLast = series.last;
+        Varint::appendSigned(series.bytes, static_cast<int64_t>(day) - series.last.day);
+        Varint::appendSigned(series.bytes, valuePaise - series.last.valuePaise);
+        Varint::appendSigned(series.bytes, investedPaise - series.last.investedPaise);
+        series.last.day = day;
+        series.last.valuePaise = valuePaise;
+        series.last.investedPaise = investedPaise;
+        series.count++;
+    }
+
+    static bool decodePoint(const std::vector<uint8_t>& bytes, size_t& pos, Cursor& cursor) {
+        int64_t dayDelta, valueDelta, investedDelta;
+        if (!Varint::readSigned(bytes.data(), bytes.size(), pos, dayDelta) ||
+            !Varint::readSigned(bytes.data(), bytes.size(), pos, valueDelta) ||
+            !Varint::readSigned(bytes.data(), bytes.size(), pos, investedDelta)) {
+            return false;
+        }
+        cursor.day += static_cast<int>(dayDelta);
+        cursor.valuePaise += valueDelta;
+        cursor.investedPaise += investedDelta;
+        return true;
+    }
+
+public:
+    void append(const std::string& userId, Date date,
+                double currentValue, double totalInvested) override {
+        int day = DateUtils::toDayNumber(date);
+        int64_t valuePaise = toPaise(currentValue);
+        int64_t investedPaise = toPaise(totalInvested);
+        std::lock_guard<std::mutex> lock(mutex);
+        appendPoint(storage[userId], day, valuePaise, investedPaise);
+    }
+
+    void appendAll(Date date, const std::vector<std::string>& userIds,
+                   const std::vector<double>& currentValues,
+                   const std::vector<double>& investedAmounts) override {
+        if (currentValues.size() != userIds.size() || investedAmounts.size() != userIds.size()) {
+            throw ValidationException("Snapshot batch columns must have one entry per user");
+        }
+        std::vector<int64_t> valuePaise(userIds.size());
+        std::vector<int64_t> investedPaise(userIds.size());
+        for (size_t i = 0; i < userIds.size(); ++i) {
+            valuePaise[i] = toPaise(currentValues[i]);
+            investedPaise[i] = toPaise(investedAmounts[i]);
+        }
+        int day = DateUtils::toDayNumber(date);
+        std::lock_guard<std::mutex> lock(mutex);
+        // Check ordering before touching any series so a bad batch records nothing
+        for (const std::string& userId : userIds) {
+            auto it = storage.find(userId);
+            if (it != storage.end() && it->second.count > 0 && day < it->second.last.day) {
+                throw ValidationException("Portfolio snapshots must be appended in date order");
+            }
+        }
+        for (size_t i = 0; i < userIds.size(); ++i) {
+            appendPoint(storage[userIds[i]], day, valuePaise[i], investedPaise[i]);
+        }
+    }
+
+    std::vector<PortfolioValuePoint> getRange(const std::string& userId, Date from, Date to) const override {
+        std::vector<PortfolioValuePoint> result;
+        int fromDay = DateUtils::toDayNumber(from);
+        int toDay = DateUtils::toDayNumber(to);
+        if (toDay < fromDay) {
+            return result;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = storage.find(userId);
+        if (it == storage.end() || it->second.count == 0) {
+            return result;
+        }
+        const Series& series = it->second;
+
+        // Last checkpoint whose preceding point is before the range
+        auto checkpoint = std::partition_point(series.checkpoints.begin() + 1, series.checkpoints.end(),
+            [fromDay](const Checkpoint& c) { return c.before.day < fromDay; }) - 1;
+
+        size_t pos = checkpoint->offset;
+        Cursor cursor = checkpoint->before;
+        std::vector<int> days;
+        while (pos < series.bytes.size() && decodePoint(series.bytes, pos, cursor)) {
+            if (cursor.day > toDay) {
+                break;
+            }
+            if (cursor.day >= fromDay) {
+                days.push_back(cursor.day);
+                result.emplace_back(Date(), static_cast<double>(cursor.valuePaise) / 100.0,
+                                    static_cast<double>(cursor.investedPaise) / 100.0);
+            }
+        }
+
+        std::vector<Date> dates(days.size());
+        DateUtils::fromDayNumbers(days.data(), days.size(), dates.data());
+        for (size_t i = 0; i < dates.size(); ++i) {
+            result[i].date = dates[i];
+        }
+        return result;
+    }
+
+    size_t getPointCount(const std::string& userId) const override {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = storage.find(userId);
+        return it != storage.end() ? it->second.count : 0;
+    }
+
+    size_t getUserCount() const override {
+        std::lock_guard<std::mutex> lock(mutex);
+        return storage.size();
+    }
+
+    /**
+     * Compressed size of a user's series in bytes (excluding checkpoints).
+     */
+    size_t getEncodedSize(const std::string& userId) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = storage.find(userId);
+        return it != storage.end() ? it->second.bytes.size() : 0;
+    }
+};
+
+} // namespace sip
+
+#endif // INMEMORY_PORTFOLIO_SNAPSHOT_REPOSITORY_H
@@ -2,6 +2,8 @@
 #define INMEMORY_SIP_REPOSITORY_H
 
 #include "ISIPRepository.h"
+#include "../utils/IdInterner.h"
+#include <algorithm>
 #include <unordered_map>
 #include <set>
 
@@ -9,112 +11,183 @@ namespace sip {
 
 /**
  * In-memory implementation of ISIPRepository.
- * Uses unordered_map for O(1) lookups by ID with secondary indexes.
+ * SIPs are stored split into parallel hot and cold record arrays indexed by
+ * SIPHandle, so due-date scans touch only the compact hot array. An ID map
+ * gives O(1) lookups by ID, with secondary indexes by user and fund.
  */
 class InMemorySIPRepository : public ISIPRepository {
 private:
-    std::unordered_map<std::string, SIP> storage;
-    std::unordered_map<std::string, std::set<std::string>> userIndex;   // userId -> set of sipIds
+    std::vector<SIPHotRecord> hotRecords;
+    std::vector<SIPColdRecord> coldRecords;
+    std::vector<SIPHandle> freeHandles;                                 // Vacant slots left by remove()
+    std::unordered_map<std::string, SIPHandle> handleIndex;             // sipId -> handle
+    std::unordered_map<std::string, std::vector<SIPHandle>> userIndex;  // userId -> handles, ordered by sipId
     std::unordered_map<std::string, std::set<std::string>> fundIndex;   // fundId -> set of sipIds
 
-    void addToIndexes(const SIP& sip) {
-        userIndex[sip.getUserId()].insert(sip.getId());
-        fundIndex[sip.getFundId()].insert(sip.getId());
+    void addToIndexes(SIPHandle handle) {
+        const SIPColdRecord& cold = coldRecords[handle];
+        std::vector<SIPHandle>& handles = userIndex[cold.userId];
+        auto pos = std::lower_bound(handles.begin(), handles.end(), cold.id,
+            [this](SIPHandle h, const std::string& id) { return coldRecords[h].id < id; });
+        handles.insert(pos, handle);
+        fundIndex[cold.fundId].insert(cold.id);
     }
 
-    void removeFromIndexes(const SIP& sip) {
-        userIndex[sip.getUserId()].erase(sip.getId());
-        fundIndex[sip.getFundId()].erase(sip.getId());
+    void removeFromIndexes(SIPHandle handle) {
+        const SIPColdRecord& cold = coldRecords[handle];
+        std::vector<SIPHandle>& handles = userIndex[cold.userId];
+        handles.erase(std::remove(handles.begin(), handles.end(), handle), handles.end());
+        fundIndex[cold.fundId].erase(cold.id);
+    }
+
+    SIP materialize(SIPHandle handle) const {
+        return assembleSIP(hotRecords[handle], coldRecords[handle]);
+    }
+
+    void store(SIPHandle handle, const SIP& sip) {
+        splitSIP(sip, IdInterner::funds().intern(sip.getFundId()),
+                 hotRecords[handle], coldRecords[handle]);
+    }
+
+    std::vector<SIP> materializeAll(const std::set<std::string>& sipIds) const {
+        std::vector<SIP> result;
+        result.reserve(sipIds.size());
+        for (const auto& sipId : sipIds) {
+            auto it = handleIndex.find(sipId);
+            if (it != handleIndex.end()) {
+                result.push_back(materialize(it->second));
+            }
+        }
+        return result;
     }
 
 public:
     void add(const SIP& sip) override {
-        storage[sip.getId()] = sip;
-        addToIndexes(sip);
+        auto existing = handleIndex.find(sip.getId());
+        if (existing != handleIndex.end()) {
+            update(sip);
+            return;
+        }
+
+        SIPHandle handle;
+        if (!freeHandles.empty()) {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+        } else {
+            handle = static_cast<SIPHandle>(hotRecords.size());
+            hotRecords.emplace_back();
+            coldRecords.emplace_back();
+        }
+        store(handle, sip);
+        handleIndex[sip.getId()] = handle;
+        addToIndexes(handle);
     }
 
     std::shared_ptr<SIP> getById(const std::string& id) const override {
-        auto it = storage.find(id);
-        if (it != storage.end()) {
-            return std::make_shared<SIP>(it->second);
+        auto it = handleIndex.find(id);
+        if (it != handleIndex.end()) {
+            return std::make_shared<SIP>(materialize(it->second));
         }
         return nullptr;
     }
 
     std::vector<SIP> getAll() const override {
         std::vector<SIP> result;
-        result.reserve(storage.size());
-        for (const auto& pair : storage) {
-            result.push_back(pair.second);
+        result.reserve(handleIndex.size());
+        for (const auto& pair : handleIndex) {
+            result.push_back(materialize(pair.second));
         }
         return result;
     }
 
     bool update(const SIP& sip) override {
-        auto it = storage.find(sip.getId());
-        if (it != storage.end()) {
+        auto it = handleIndex.find(sip.getId());
+        if (it != handleIndex.end()) {
             // Remove from old indexes if userId/fundId changed
             removeFromIndexes(it->second);
             // Update
-            it->second = sip;
+            store(it->second, sip);
             // Add to new indexes
-            addToIndexes(sip);
+            addToIndexes(it->second);
             return true;
         }
         return false;
     }
 
     bool remove(const std::string& id) override {
-        auto it = storage.find(id);
-        if (it != storage.end()) {
-            removeFromIndexes(it->second);
-            storage.erase(it);
+        auto it = handleIndex.find(id);
+        if (it != handleIndex.end()) {
+            SIPHandle handle = it->second;
+            removeFromIndexes(handle);
+            hotRecords[handle].state = SIPHotRecord::kVacant;
+            coldRecords[handle] = SIPColdRecord();
+            freeHandles.push_back(handle);
+            handleIndex.erase(it);
             return true;
         }
         return false;
     }
 
     bool exists(const std::string& id) const override {
-        return storage.find(id) != storage.end();
+        return handleIndex.find(id) != handleIndex.end();
     }
 
     size_t count() const override {
-        return storage.size();
+        return handleIndex.size();
     }
 
     std::vector<SIP> getByUserId(const std::string& userId) const override {
         std::vector<SIP> result;
         auto it = userIndex.find(userId);
         if (it != userIndex.end()) {
-            for (const auto& sipId : it->second) {
-                auto sipIt = storage.find(sipId);
-                if (sipIt != storage.end()) {
-                    result.push_back(sipIt->second);
-                }
+            result.reserve(it->second.size());
+            for (SIPHandle handle : it->second) {
+                result.push_back(materialize(handle));
             }
         }
         return result;
     }
 
+    void forEachByUserId(const std::string& userId, const SIPRecordVisitor& visitor) const override {
+        auto it = userIndex.find(userId);
+        if (it == userIndex.end()) {
+            return;
+        }
+        for (SIPHandle handle : it->second) {
+            visitor(SIPRecordView{handle, hotRecords[handle], coldRecords[handle]});
+        }
+    }
+
+    void forEachSIP(const SIPRecordVisitor& visitor) const override {
+        for (size_t handle = 0; handle < hotRecords.size(); ++handle) {
+            if (!hotRecords[handle].isVacant()) {
+                visitor(SIPRecordView{static_cast<SIPHandle>(handle), hotRecords[handle], coldRecords[handle]});
+            }
+        }
+    }
+
+    void forEachSIPByUser(const SIPRecordVisitor& visitor) const override {
+        for (const auto& entry : userIndex) {
+            for (SIPHandle handle : entry.second) {
+                visitor(SIPRecordView{handle, hotRecords[handle], coldRecords[handle]});
+            }
+        }
+    }
+
     std::vector<SIP> getByFundId(const std::string& fundId) const override {
-        std::vector<SIP> result;
         auto it = fundIndex.find(fundId);
         if (it != fundIndex.end()) {
-            for (const auto& sipId : it->second) {
-                auto sipIt = storage.find(sipId);
-                if (sipIt != storage.end()) {
-                    result.push_back(sipIt->second);
-                }
-            }
+            return materializeAll(it->second);
         }
-        return result;
+        return std::vector<SIP>();
     }
 
     std::vector<SIP> getByState(SIPState state) const override {
         std::vector<SIP> result;
-        for (const auto& pair : storage) {
-            if (pair.second.getState() == state) {
-                result.push_back(pair.second);
+        const uint8_t wanted = static_cast<uint8_t>(state);
+        for (size_t handle = 0; handle < hotRecords.size(); ++handle) {
+            if (hotRecords[handle].state == wanted) {
+                result.push_back(materialize(static_cast<SIPHandle>(handle)));
             }
         }
         return result;
@@ -133,18 +206,43 @@ public:
 
     std::vector<SIP> getDueSIPs(Date asOfDate) const override {
         std::vector<SIP> result;
-        for (const auto& pair : storage) {
-            const SIP& sip = pair.second;
-            // Only ACTIVE SIPs can be due
-            if (sip.getState() == SIPState::ACTIVE) {
-                // Check if nextExecutionDate <= asOfDate
-                if (sip.getNextExecutionDate() <= asOfDate) {
-                    result.push_back(sip);
-                }
+        for (const auto& due : getDueRecords(asOfDate)) {
+            result.push_back(materialize(due.handle));
+        }
+        return result;
+    }
+
+    std::vector<DueSIPRecord> getDueRecords(Date asOfDate) const override {
+        std::vector<DueSIPRecord> result;
+        const uint32_t asOf = SIPHotRecord::toTime(asOfDate);
+        const uint8_t active = static_cast<uint8_t>(SIPState::ACTIVE);
+        const SIPHotRecord* records = hotRecords.data();
+        const size_t n = hotRecords.size();
+        for (size_t handle = 0; handle < n; ++handle) {
+            // Only ACTIVE SIPs can be due; vacant slots never match
+            if (records[handle].state == active && records[handle].nextExecutionTime <= asOf) {
+                DueSIPRecord due;
+                due.handle = static_cast<SIPHandle>(handle);
+                due.hot = records[handle];
+                result.push_back(due);
             }
         }
         return result;
     }
+
+    std::string getIdByHandle(SIPHandle handle) const override {
+        if (handle >= coldRecords.size() || hotRecords[handle].isVacant()) {
+            return std::string();
+        }
+        return coldRecords[handle].id;
+    }
+
+    std::string getUserIdByHandle(SIPHandle handle) const override {
+        if (handle >= coldRecords.size() || hotRecords[handle].isVacant()) {
+            return std::string();
+        }
+        return coldRecords[handle].userId;
+    }
 };
 
 } // namespace sip
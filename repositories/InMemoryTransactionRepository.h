@@ -9,17 +9,59 @@ namespace sip {
 
 /**
  * In-memory implementation of ITransactionRepository.
- * Uses unordered_map for O(1) lookups by ID with sipId index.
+ * Uses unordered_map for O(1) lookups by ID with sipId and mandateId indexes.
  */
 class InMemoryTransactionRepository : public ITransactionRepository {
 private:
     std::unordered_map<std::string, Transaction> storage;
     std::unordered_map<std::string, std::set<std::string>> sipIndex;  // sipId -> set of transactionIds
+    std::unordered_map<std::string, std::set<std::string>> mandateIndex;  // mandateId -> set of transactionIds
+    std::unordered_map<std::string, SIPTransactionTotals> successTotals;  // sipId -> SUCCESS totals
+
+    /**
+     * Add (sign = +1) or remove (sign = -1) a transaction's share of its SIP's totals.
+     */
+    void applyToTotals(const Transaction& transaction, int sign) {
+        if (transaction.getStatus() != PaymentStatus::SUCCESS) {
+            return;
+        }
+        SIPTransactionTotals& totals = successTotals[transaction.getSipId()];
+        totals.successfulCount += sign;
+        if (totals.successfulCount <= 0) {
+            successTotals.erase(transaction.getSipId());
+            return;
+        }
+        totals.totalInvested += sign * transaction.getAmount();
+        totals.totalUnits += sign * transaction.getUnits();
+    }
+
+    void indexMandate(const Transaction& transaction) {
+        if (!transaction.getMandateId().empty()) {
+            mandateIndex[transaction.getMandateId()].insert(transaction.getId());
+        }
+    }
+
+    void unindexMandate(const Transaction& transaction) {
+        auto it = mandateIndex.find(transaction.getMandateId());
+        if (it != mandateIndex.end()) {
+            it->second.erase(transaction.getId());
+            if (it->second.empty()) {
+                mandateIndex.erase(it);
+            }
+        }
+    }
 
 public:
     void add(const Transaction& transaction) override {
+        auto existing = storage.find(transaction.getId());
+        if (existing != storage.end()) {
+            applyToTotals(existing->second, -1);
+            unindexMandate(existing->second);
+        }
         storage[transaction.getId()] = transaction;
         sipIndex[transaction.getSipId()].insert(transaction.getId());
+        indexMandate(transaction);
+        applyToTotals(transaction, +1);
     }
 
     std::shared_ptr<Transaction> getById(const std::string& id) const override {
@@ -47,7 +89,13 @@ public:
                 sipIndex[it->second.getSipId()].erase(transaction.getId());
                 sipIndex[transaction.getSipId()].insert(transaction.getId());
             }
+            if (it->second.getMandateId() != transaction.getMandateId()) {
+                unindexMandate(it->second);
+                indexMandate(transaction);
+            }
+            applyToTotals(it->second, -1);
             it->second = transaction;
+            applyToTotals(transaction, +1);
             return true;
         }
         return false;
@@ -57,6 +105,8 @@ public:
         auto it = storage.find(id);
         if (it != storage.end()) {
             sipIndex[it->second.getSipId()].erase(id);
+            unindexMandate(it->second);
+            applyToTotals(it->second, -1);
             storage.erase(it);
             return true;
         }
@@ -85,6 +135,20 @@ public:
         return result;
     }
 
+    std::vector<Transaction> getByMandateId(const std::string& mandateId) const override {
+        std::vector<Transaction> result;
+        auto it = mandateIndex.find(mandateId);
+        if (it != mandateIndex.end()) {
+            for (const auto& txnId : it->second) {
+                auto txnIt = storage.find(txnId);
+                if (txnIt != storage.end()) {
+                    result.push_back(txnIt->second);
+                }
+            }
+        }
+        return result;
+    }
+
     std::vector<Transaction> getByStatus(PaymentStatus status) const override {
         std::vector<Transaction> result;
         for (const auto& pair : storage) {
@@ -105,6 +169,31 @@ public:
         }
         return result;
     }
+
+    SIPTransactionTotals getSuccessfulTotalsBySipId(const std::string& sipId) const override {
+        auto it = successTotals.find(sipId);
+        if (it != successTotals.end()) {
+            return it->second;
+        }
+        return SIPTransactionTotals();
+    }
+
+    void scaleUnits(const std::string& sipId, double multiplier) override {
+        auto it = sipIndex.find(sipId);
+        if (it == sipIndex.end()) {
+            return;
+        }
+        for (const auto& txnId : it->second) {
+            auto txnIt = storage.find(txnId);
+            if (txnIt != storage.end()) {
+                Transaction& transaction = txnIt->second;
+                applyToTotals(transaction, -1);
+                transaction.setUnits(transaction.getUnits() * multiplier);
+                transaction.setNav(transaction.getNav() / multiplier);
+                applyToTotals(transaction, +1);
+            }
+        }
+    }
 };
 
 } // namespace sip
@@ -4,39 +4,205 @@
 #include "../services/ISIPService.h"
 #include "../services/IMarketPriceService.h"
 #include "../services/IPaymentService.h"
+#include "../services/OrderAggregator.h"
 #include "../repositories/ISIPRepository.h"
 #include "../repositories/ITransactionRepository.h"
+#include "../repositories/IHoldingRepository.h"
+#include "../repositories/INavHistoryRepository.h"
 #include "../utils/DateUtils.h"
 #include "../utils/IdGenerator.h"
+#include "../utils/IdempotencyStore.h"
+#include "../utils/IdInterner.h"
 #include "../utils/Exceptions.h"
+#include "../utils/StepUpEngine.h"
+#include <algorithm>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <iostream>
-#include <cmath>
+#include <vector>
 
 namespace sip {
 
 /**
  * SIP Scheduler - Executes due SIPs based on their schedule.
+ *
+ * Payment callbacks may arrive on other threads (an asynchronous gateway),
+ * concurrently with each other and with executeDueSIPs: all repository
+ * access made by the scheduler is serialized by one mutex. Payments are
+ * initiated outside it, so a gateway may also call back inline. The mutex
+ * covers only the scheduler and code that takes it (getRepositoryMutex);
+ * SIPServiceImpl and the repositories do not. While an asynchronous gateway
+ * may still deliver callbacks, nothing else may read or modify the
+ * repositories the scheduler uses without holding it: construct readers
+ * (PortfolioServiceImpl, BatchValuationEngine, ScenarioEngine, XirrEngine,
+ * MonteCarloProjector) with it, or use them only once the gateway is idle.
+ *
+ * A SIP whose installment is still awaiting its payment result is not
+ * executed again, so a run that starts before the previous run's callbacks
+ * arrive does not debit the same installment twice. Callbacks arriving
+ * after the scheduler is destroyed are ignored.
+ *
+ * executeDueSIPs nets a user's installments due on the same date into one
+ * mandate debit (unless debit netting is off) and sends the debits to the gateway
+ * in chunks of paymentBatchSize, one initiatePayments call per chunk with
+ * one sink that fans each result out to the debit's installments.
  */
 class SIPScheduler {
 private:
+    struct Installment {
+        std::string transactionId;
+        std::string sipId;
+    };
+
+    /**
+     * Installments netted into one debit: the same user, due on the same day.
+     */
+    struct DebitKey {
+        std::string userId;
+        int dueDay;  // DateUtils::toDayNumber
+
+        bool operator==(const DebitKey& other) const {
+            return dueDay == other.dueDay && userId == other.userId;
+        }
+    };
+
+    struct DebitKeyHash {
+        size_t operator()(const DebitKey& key) const {
+            return std::hash<std::string>()(key.userId) * 31 + std::hash<int>()(key.dueDay);
+        }
+    };
+
+    /**
+     * What gateway callbacks reach the scheduler through. The destructor
+     * clears it (waiting for a callback in progress), so callbacks that
+     * outlive the scheduler do nothing.
+     */
+    struct CallbackTarget {
+        std::mutex mutex;
+        SIPScheduler* scheduler;
+
+        explicit CallbackTarget(SIPScheduler* scheduler) : scheduler(scheduler) {}
+    };
+
+    /**
+     * Completion sink for one chunk of debits. Debit i covers installments
+     * [debitStarts[i], debitStarts[i + 1]); a debit of one installment is
+     * paid under the installment's own transaction ID, a netted one under
+     * a mandate ID stored on each of its transactions.
+     */
+    class InstallmentBatch : public IPaymentBatchSink {
+    private:
+        std::shared_ptr<CallbackTarget> target;
+
+    public:
+        std::vector<Installment> installments;
+        std::vector<size_t> debitStarts;
+
+        explicit InstallmentBatch(std::shared_ptr<CallbackTarget> target) : target(std::move(target)) {}
+
+        void onPaymentResult(size_t index, const std::string& transactionId, PaymentStatus status) override {
+            (void)transactionId;
+            std::lock_guard<std::mutex> lock(target->mutex);
+            if (target->scheduler) {
+                target->scheduler->settleDebit(installments.data() + debitStarts[index],
+                                               debitStarts[index + 1] - debitStarts[index], status);
+            }
+        }
+    };
+
     std::shared_ptr<ISIPRepository> sipRepository;
     std::shared_ptr<ITransactionRepository> transactionRepository;
     std::shared_ptr<IMarketPriceService> marketPriceService;
     std::shared_ptr<IPaymentService> paymentService;
     std::shared_ptr<ISIPService> sipService;
+    std::shared_ptr<IHoldingRepository> holdingRepository;  // Optional
+    std::shared_ptr<INavHistoryRepository> navHistory;      // Optional
+    std::shared_ptr<OrderAggregator> orderAggregator;       // Optional
+    std::shared_ptr<std::mutex> repositoryMutex;
+    IdempotencyStore settledCallbacks;  // Recently settled transactions, to skip repository reads on redelivery
+    std::unordered_map<std::string, int> pendingInstallments;  // SIP ID -> installments awaiting payment
+    std::shared_ptr<CallbackTarget> callbackTarget;
+    size_t paymentBatchSize;  // Debits per gateway call
+    bool debitNetting;
 
 public:
+    /**
+     * Constructor.
+     * @param holdingRepo If set, consolidated (user, fund) holdings are
+     *                    updated on every successful payment
+     * @param navHistoryRepo If set, installments are priced at the NAV in
+     *                       effect on their execution date
+     * @param aggregator If set, successful installments are rolled into
+     *                   per-fund purchase orders; their units and holdings
+     *                   are applied when the order's allotment arrives
+     *                   (applyAllotment) instead of on payment. Until then
+     *                   their transactions carry no NAV (0) and 0 units.
+     */
     SIPScheduler(std::shared_ptr<ISIPRepository> sipRepo,
                  std::shared_ptr<ITransactionRepository> txnRepo,
                  std::shared_ptr<IMarketPriceService> marketSvc,
                  std::shared_ptr<IPaymentService> paymentSvc,
-                 std::shared_ptr<ISIPService> sipSvc)
+                 std::shared_ptr<ISIPService> sipSvc,
+                 std::shared_ptr<IHoldingRepository> holdingRepo = nullptr,
+                 std::shared_ptr<INavHistoryRepository> navHistoryRepo = nullptr,
+                 std::shared_ptr<OrderAggregator> aggregator = nullptr)
         : sipRepository(std::move(sipRepo)),
           transactionRepository(std::move(txnRepo)),
           marketPriceService(std::move(marketSvc)),
           paymentService(std::move(paymentSvc)),
-          sipService(std::move(sipSvc)) {}
+          sipService(std::move(sipSvc)),
+          holdingRepository(std::move(holdingRepo)),
+          navHistory(std::move(navHistoryRepo)),
+          orderAggregator(std::move(aggregator)),
+          repositoryMutex(std::make_shared<std::mutex>()),
+          settledCallbacks(IPaymentService::callbackRetryWindow()),
+          callbackTarget(std::make_shared<CallbackTarget>(this)),
+          paymentBatchSize(256), debitNetting(true) {}
+
+    ~SIPScheduler() {
+        std::lock_guard<std::mutex> lock(callbackTarget->mutex);
+        callbackTarget->scheduler = nullptr;
+    }
+
+    SIPScheduler(const SIPScheduler&) = delete;
+    SIPScheduler& operator=(const SIPScheduler&) = delete;
+
+    /**
+     * The lock that serializes the scheduler's repository access. Hold it
+     * to read or change data the scheduler reads or writes while payment
+     * callbacks may be in flight (e.g. CorporateActionService, XirrEngine).
+     */
+    std::shared_ptr<std::mutex> getRepositoryMutex() const {
+        return repositoryMutex;
+    }
+
+    /**
+     * Set how many debits executeDueSIPs sends per gateway call.
+     */
+    void setPaymentBatchSize(size_t size) {
+        if (size == 0) {
+            throw ValidationException("Payment batch size must be positive");
+        }
+        paymentBatchSize = size;
+    }
+
+    size_t getPaymentBatchSize() const {
+        return paymentBatchSize;
+    }
+
+    /**
+     * When on (the default), a user's installments due on the same date are
+     * paid by one mandate debit, and its success or failure applies to all of
+     * them. When off, every installment is debited separately.
+     */
+    void setDebitNetting(bool enabled) {
+        debitNetting = enabled;
+    }
+
+    bool isDebitNetting() const {
+        return debitNetting;
+    }
 
     /**
      * Check if an SIP is due for execution on the given date.
@@ -53,19 +219,94 @@ public:
 
     /**
      * Execute all SIPs that are due on the given date.
+     * Each installment is dated and priced at its SIP's own due date, so a
+     * run that catches up on missed days records them as of those days.
      * Returns the number of SIPs processed.
      */
     int executeDueSIPs(Date asOfDate) {
-        std::vector<SIP> dueSIPs = sipRepository->getDueSIPs(asOfDate);
+        // Scan compact hot records only; cold fields are fetched per due SIP
+        std::vector<DueSIPRecord> dueRecords;
+        std::vector<std::string> sipIds;
+        std::vector<DebitKey> debitKeys;
+        {
+            std::lock_guard<std::mutex> lock(*repositoryMutex);
+            dueRecords = sipRepository->getDueRecords(asOfDate);
+            sipIds.reserve(dueRecords.size());
+            size_t kept = 0;
+            for (const auto& due : dueRecords) {
+                std::string sipId = sipRepository->getIdByHandle(due.handle);
+                // Still awaiting the last installment's payment: its date has not advanced yet
+                if (pendingInstallments.count(sipId) != 0) {
+                    continue;
+                }
+                if (debitNetting) {
+                    int dueDay = DateUtils::toDayNumber(SIPHotRecord::toDate(due.hot.nextExecutionTime));
+                    debitKeys.push_back(DebitKey{sipRepository->getUserIdByHandle(due.handle), dueDay});
+                }
+                sipIds.push_back(std::move(sipId));
+                dueRecords[kept++] = due;
+            }
+            dueRecords.resize(kept);
+        }
+        std::vector<size_t> order;
+        std::vector<size_t> debitStarts;
+        groupDebits(debitKeys, dueRecords.size(), order, debitStarts);
         int processedCount = 0;
 
-        for (const auto& sip : dueSIPs) {
+        std::vector<PaymentRequest> requests;
+        const size_t debitCount = debitStarts.size() - 1;
+        for (size_t begin = 0; begin < debitCount; begin += paymentBatchSize) {
+            size_t end = std::min(debitCount, begin + paymentBatchSize);
+            auto batch = std::make_shared<InstallmentBatch>(callbackTarget);
+            batch->installments.reserve(debitStarts[end] - debitStarts[begin]);
+            requests.clear();
+            {
+                std::lock_guard<std::mutex> lock(*repositoryMutex);
+                for (size_t d = begin; d < end; ++d) {
+                    size_t first = batch->installments.size();
+                    double total = 0.0;
+                    // A netted debit is paid under a mandate ID that its installments record
+                    std::string mandateId = debitStarts[d + 1] - debitStarts[d] > 1
+                                          ? IdGenerator::generateSimple("MANDATE") : std::string();
+                    for (size_t k = debitStarts[d]; k < debitStarts[d + 1]; ++k) {
+                        const SIPHotRecord& hot = dueRecords[order[k]].hot;
+                        const std::string& sipId = sipIds[order[k]];
+                        try {
+                            if (hot.getState() == SIPState::ACTIVE) {
+                                PaymentRequest request = recordInstallment(
+                                    sipId, IdInterner::funds().idOf(hot.fundHandle), hot.fundHandle,
+                                    hot.baseAmount, hot.stepUpPercentage, hot.installmentCount,
+                                    SIPHotRecord::toDate(hot.nextExecutionTime), mandateId);
+                                batch->installments.push_back(Installment{request.transactionId, sipId});
+                                total += request.amount;
+                            }
+                            processedCount++;
+                        } catch (const std::exception& e) {
+                            // Log error but continue processing other SIPs
+                            std::cerr << "Error executing SIP " << sipId << ": " << e.what() << std::endl;
+                        }
+                    }
+                    size_t members = batch->installments.size() - first;
+                    if (members == 0) {
+                        continue;
+                    }
+                    batch->debitStarts.push_back(first);
+                    requests.push_back(PaymentRequest{mandateId.empty() ? batch->installments[first].transactionId
+                                                                        : mandateId,
+                                                      total});
+                }
+            }
+            batch->debitStarts.push_back(batch->installments.size());
+            if (requests.empty()) {
+                continue;
+            }
             try {
-                executeSIP(sip, asOfDate);
-                processedCount++;
+                paymentService->initiatePayments(requests.data(), requests.size(), batch);
             } catch (const std::exception& e) {
-                // Log error but continue processing other SIPs
-                std::cerr << "Error executing SIP " << sip.getId() << ": " << e.what() << std::endl;
+                // The chunk was not submitted: fail its installments so none stays PENDING
+                std::cerr << "Error initiating " << requests.size() << " payments: " << e.what() << std::endl;
+                settleDebit(batch->installments.data(), batch->installments.size(), PaymentStatus::FAILURE);
+                processedCount -= static_cast<int>(batch->installments.size());
             }
         }
 
@@ -73,7 +314,52 @@ public:
     }
 
     /**
-     * Execute a single SIP installment.
+     * Apply a payment result that arrives outside the initiating callback
+     * (the gateway's completion handler or onPaymentCallback, e.g. a
+     * webhook or reconciliation), by the ID the payment was initiated
+     * under: an installment's transaction ID or a netted debit's mandate
+     * ID. Already settled installments and unknown IDs are ignored.
+     */
+    void handleGatewayCallback(const std::string& paymentId, PaymentStatus status) {
+        std::lock_guard<std::mutex> lock(*repositoryMutex);
+        auto txn = transactionRepository->getById(paymentId);
+        if (txn) {
+            settleInstallment(paymentId, txn->getSipId(), status);
+            return;
+        }
+        for (const Transaction& member : transactionRepository->getByMandateId(paymentId)) {
+            settleInstallment(member.getId(), member.getSipId(), status);
+        }
+    }
+
+    /**
+     * Apply an allotment from the order aggregator: each installment's
+     * transaction takes its share of the units at the allotment NAV, and
+     * the units are added to the user's holding. Installments that already
+     * have a NAV (allotted before) are skipped, so applying the same
+     * allotment twice changes nothing.
+     */
+    void applyAllotment(const OrderAllocation& allocation) {
+        std::lock_guard<std::mutex> lock(*repositoryMutex);
+        for (size_t i = 0; i < allocation.members.size(); ++i) {
+            const OrderMember& member = allocation.members[i];
+            auto txn = transactionRepository->getById(member.transactionId);
+            if (!txn || txn->getStatus() != PaymentStatus::SUCCESS || txn->getNav() > 0) {
+                continue;
+            }
+            txn->setNav(allocation.nav);
+            txn->setUnits(allocation.units[i]);
+            transactionRepository->update(*txn);
+            if (holdingRepository) {
+                holdingRepository->recordPurchase(member.userId, allocation.order.fundId, allocation.amounts[i],
+                                                  allocation.units[i]);
+            }
+        }
+    }
+
+    /**
+     * Execute a single SIP installment. A backdated executionDate is priced
+     * at that day's NAV when NAV history is available.
      */
     void executeSIP(const SIP& sip, Date executionDate) {
         // Skip if not ACTIVE
@@ -81,39 +367,134 @@ public:
             return;
         }
 
-        // Get current NAV
-        double nav = marketPriceService->getCurrentNAV(sip.getFundId());
+        submitInstallment(sip.getId(), sip.getFundId(), IdInterner::funds().find(sip.getFundId()),
+                          sip.getBaseAmount(), sip.getStepUpPercentage(), sip.getInstallmentCount(), executionDate);
+    }
+
+private:
+    /**
+     * Order due records into debits: with debit keys, one debit per key
+     * (keys in order of first appearance, their SIPs in due order);
+     * without, one debit per record. Debit d covers
+     * order[debitStarts[d] .. debitStarts[d + 1]).
+     */
+    static void groupDebits(const std::vector<DebitKey>& debitKeys, size_t count,
+                            std::vector<size_t>& order, std::vector<size_t>& debitStarts) {
+        order.resize(count);
+        if (debitKeys.empty()) {
+            debitStarts.resize(count + 1);
+            for (size_t i = 0; i < count; ++i) {
+                order[i] = i;
+                debitStarts[i] = i;
+            }
+            debitStarts[count] = count;
+            return;
+        }
+        // Counting sort on each key's first-appearance rank
+        std::unordered_map<DebitKey, size_t, DebitKeyHash> rankOf;
+        std::vector<size_t> ranks(count);
+        for (size_t i = 0; i < count; ++i) {
+            ranks[i] = rankOf.emplace(debitKeys[i], rankOf.size()).first->second;
+        }
+        debitStarts.assign(rankOf.size() + 1, 0);
+        for (size_t i = 0; i < count; ++i) {
+            debitStarts[ranks[i] + 1]++;
+        }
+        for (size_t r = 0; r < rankOf.size(); ++r) {
+            debitStarts[r + 1] += debitStarts[r];
+        }
+        std::vector<size_t> next(debitStarts.begin(), debitStarts.end() - 1);
+        for (size_t i = 0; i < count; ++i) {
+            order[next[ranks[i]]++] = i;
+        }
+    }
+
+    /**
+     * Price an installment and record its pending transaction.
+     * Caller holds repositoryMutex.
+     * @return The payment to initiate for it
+     */
+    PaymentRequest recordInstallment(const std::string& sipId, const std::string& fundId, uint32_t fundHandle,
+                                     double baseAmount, double stepUpPercentage, int installmentCount,
+                                     Date executionDate, const std::string& mandateId = std::string()) {
+        // NAV as of the execution date; current NAV if there is no history for it
+        double nav = navHistory ? navHistory->getNAV(fundId, executionDate) : 0.0;
+        if (nav <= 0) {
+            nav = marketPriceService->getNAVByHandle(fundHandle);
+        }
+        if (nav <= 0) {
+            throw FundNotFoundException(fundId);
+        }
         
         // Calculate installment amount (with step-up)
-        double amount = calculateSteppedUpAmount(sip.getBaseAmount(), 
-                                                  sip.getStepUpPercentage(), 
-                                                  sip.getInstallmentCount() + 1);
+        double amount = StepUpEngine::steppedUpAmount(baseAmount, stepUpPercentage, installmentCount + 1);
         
         // Calculate units
         double units = amount / nav;
         
         // Create transaction
         std::string txnId = IdGenerator::generateTransactionId();
-        Transaction txn(txnId, sip.getId(), amount, nav, executionDate, TransactionType::INSTALLMENT);
-        txn.setUnits(units);
+        // Aggregated purchases are priced by the order's allotment: no NAV or units until then
+        Transaction txn(txnId, sipId, amount, orderAggregator ? 0.0 : nav, executionDate,
+                        TransactionType::INSTALLMENT);
+        txn.setUnits(orderAggregator ? 0.0 : units);
         txn.setStatus(PaymentStatus::PENDING);
+        txn.setMandateId(mandateId);
         transactionRepository->add(txn);
+        pendingInstallments[sipId]++;
+        return PaymentRequest{txnId, amount};
+    }
+
+    /**
+     * Price an installment, record its pending transaction and initiate payment.
+     */
+    void submitInstallment(const std::string& sipId, const std::string& fundId, uint32_t fundHandle,
+                           double baseAmount, double stepUpPercentage, int installmentCount, Date executionDate) {
+        std::unique_lock<std::mutex> lock(*repositoryMutex);
+        PaymentRequest request = recordInstallment(sipId, fundId, fundHandle, baseAmount, stepUpPercentage,
+                                                   installmentCount, executionDate);
+        lock.unlock();
         
         // Initiate payment with callback
-        std::string sipId = sip.getId();
-        paymentService->initiatePayment(txnId, amount, 
-            [this, txnId, sipId](const std::string& transactionId, PaymentStatus status) {
-                this->handlePaymentCallback(transactionId, sipId, status);
+        std::shared_ptr<CallbackTarget> target = callbackTarget;
+        paymentService->initiatePayment(request.transactionId, request.amount, 
+            [target, sipId](const std::string& transactionId, PaymentStatus status) {
+                std::lock_guard<std::mutex> targetLock(target->mutex);
+                if (target->scheduler) {
+                    target->scheduler->handlePaymentCallback(transactionId, sipId, status);
+                }
             });
     }
 
-private:
+    /**
+     * Apply a debit's outcome to each of its installments.
+     */
+    void settleDebit(const Installment* installments, size_t count, PaymentStatus status) {
+        std::lock_guard<std::mutex> lock(*repositoryMutex);
+        for (size_t i = 0; i < count; ++i) {
+            settleInstallment(installments[i].transactionId, installments[i].sipId, status);
+        }
+    }
+
     /**
      * Handle payment callback.
      */
     void handlePaymentCallback(const std::string& transactionId, 
                                 const std::string& sipId, 
                                 PaymentStatus status) {
+        std::lock_guard<std::mutex> lock(*repositoryMutex);
+        settleInstallment(transactionId, sipId, status);
+    }
+
+    /**
+     * Apply a payment outcome to one installment, once.
+     * Caller holds repositoryMutex.
+     */
+    void settleInstallment(const std::string& transactionId, const std::string& sipId, PaymentStatus status) {
+        // Redelivery within the retry window is rejected without a repository read
+        if (settledCallbacks.contains(transactionId)) {
+            return;
+        }
         auto txn = transactionRepository->getById(transactionId);
         if (!txn) {
             return;
@@ -121,6 +502,7 @@ private:
         
         // Idempotent check - skip if already processed
         if (txn->isCallbackProcessed()) {
+            settledCallbacks.tryRecord(transactionId);
             return;
         }
         
@@ -128,26 +510,32 @@ private:
         txn->setStatus(status);
         txn->setCallbackProcessed(true);
         transactionRepository->update(*txn);
+        settledCallbacks.tryRecord(transactionId);
+        auto pending = pendingInstallments.find(sipId);
+        if (pending != pendingInstallments.end() && --pending->second == 0) {
+            pendingInstallments.erase(pending);
+        }
         
         if (status == PaymentStatus::SUCCESS) {
             // Increment installment count
             sipService->onPaymentSuccess(sipId);
             // Update next execution date
             sipService->updateNextExecutionDate(sipId);
+            // Roll the purchase into its fund's order, or add the units to the holding now
+            if (orderAggregator || holdingRepository) {
+                auto sip = sipRepository->getById(sipId);
+                if (sip && orderAggregator) {
+                    orderAggregator->addInstallment(sip->getFundId(),
+                                                    OrderMember{transactionId, sipId, sip->getUserId()},
+                                                    txn->getAmount());
+                } else if (sip) {
+                    holdingRepository->recordPurchase(sip->getUserId(), sip->getFundId(),
+                                                      txn->getAmount(), txn->getUnits());
+                }
+            }
         }
         // For FAILURE, we don't increment or update next execution date
     }
-
-    /**
-     * Calculate stepped-up amount.
-     */
-    static double calculateSteppedUpAmount(double baseAmount, double stepUpPercentage, int installmentNumber) {
-        if (stepUpPercentage <= 0 || installmentNumber <= 1) {
-            return baseAmount;
-        }
-        double factor = std::pow(1.0 + stepUpPercentage / 100.0, installmentNumber - 1);
-        return baseAmount * factor;
-    }
 };
 
 } // namespace sip
@@ -0,0 +1,257 @@
+#ifndef SCHEDULE_GENERATOR_H
+#define SCHEDULE_GENERATOR_H
+
+#include "../models/Enums.h"
+#include "../utils/DateUtils.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Identifies one precomputed schedule.
+ * anchorDay is the day-of-month (1-31) for MONTHLY/QUARTERLY schedules and
+ * the day-of-week (0 = Sunday) for WEEKLY schedules. anchorMonthPhase is the
+ * anchor month modulo 3 and only matters for QUARTERLY schedules.
+ */
+struct ScheduleKey {
+    int anchorDay;
+    int anchorMonthPhase;
+    SIPFrequency frequency;
+    BusinessDayRule rule;
+
+    ScheduleKey()
+        : anchorDay(1), anchorMonthPhase(0),
+          frequency(SIPFrequency::MONTHLY), rule(BusinessDayRule::NONE) {}
+
+    ScheduleKey(int anchorDay, int anchorMonthPhase, SIPFrequency frequency, BusinessDayRule rule)
+        : anchorDay(anchorDay), anchorMonthPhase(anchorMonthPhase),
+          frequency(frequency), rule(rule) {}
+
+    bool operator==(const ScheduleKey& other) const {
+        return anchorDay == other.anchorDay && anchorMonthPhase == other.anchorMonthPhase &&
+               frequency == other.frequency && rule == other.rule;
+    }
+};
+
+struct ScheduleKeyHash {
+    size_t operator()(const ScheduleKey& key) const {
+        size_t packed = static_cast<size_t>(key.anchorDay) |
+                        (static_cast<size_t>(key.anchorMonthPhase) << 8) |
+                        (static_cast<size_t>(key.frequency) << 16) |
+                        (static_cast<size_t>(key.rule) << 24);
+        return std::hash<size_t>()(packed);
+    }
+};
+
+/**
+ * Immutable, sorted list of execution dates for one ScheduleKey.
+ * Dates are local midnights, as produced by DateUtils::createDate.
+ */
+class ScheduleTable {
+private:
+    std::vector<Date> dates;
+
+public:
+    explicit ScheduleTable(std::vector<Date> dates) : dates(std::move(dates)) {}
+
+    size_t size() const { return dates.size(); }
+    const std::vector<Date>& getDates() const { return dates; }
+
+    /**
+     * Check whether the table can answer "next date after" for the given date.
+     */
+    bool covers(Date date) const {
+        return !dates.empty() && date >= dates.front() && date < dates.back();
+    }
+
+    /**
+     * Find the first scheduled date strictly after the given date.
+     * Returns false if the date is past the end of the table.
+     */
+    bool nextAfter(Date after, Date& out) const {
+        auto it = std::upper_bound(dates.begin(), dates.end(), after);
+        if (it == dates.end()) {
+            return false;
+        }
+        out = *it;
+        return true;
+    }
+
+    /**
+     * Copy up to count scheduled dates strictly after the given date.
+     */
+    std::vector<Date> nextDates(Date after, size_t count) const {
+        auto first = std::upper_bound(dates.begin(), dates.end(), after);
+        size_t available = static_cast<size_t>(dates.end() - first);
+        auto last = first + static_cast<std::ptrdiff_t>(std::min(count, available));
+        return std::vector<Date>(first, last);
+    }
+};
+
+/**
+ * Cached schedule generator.
+ * Builds one ScheduleTable per (anchor, frequency, business-day rule) the
+ * first time it is asked for, then answers next-date and forecast
+ * queries with a binary search instead of repeated calendar arithmetic.
+ * Dates outside [firstYear, lastYear] fall back to DateUtils.
+ */
+class ScheduleGenerator {
+private:
+    int firstYear;
+    int lastYear;
+    mutable std::mutex cacheMutex;
+    mutable std::unordered_map<ScheduleKey, std::shared_ptr<const ScheduleTable>, ScheduleKeyHash> cache;
+
+public:
+    /**
+     * Constructor.
+     * @param firstYear First calendar year covered by generated tables
+     * @param lastYear Last calendar year covered by generated tables
+     */
+    explicit ScheduleGenerator(int firstYear = 2000, int lastYear = 2100)
+        : firstYear(firstYear), lastYear(lastYear) {}
+
+    /**
+     * Build the schedule key for an SIP anchored on the given start date.
+     */
+    static ScheduleKey makeKey(Date anchorDate, SIPFrequency frequency, BusinessDayRule rule) {
+        std::tm tm = DateUtils::toLocalTime(anchorDate);
+        if (frequency == SIPFrequency::WEEKLY) {
+            return ScheduleKey(tm.tm_wday, 0, frequency, rule);
+        }
+        int phase = frequency == SIPFrequency::QUARTERLY ? tm.tm_mon % 3 : 0;
+        return ScheduleKey(tm.tm_mday, phase, frequency, rule);
+    }
+
+    /**
+     * Get (building on first use) the table for a key.
+     */
+    std::shared_ptr<const ScheduleTable> getTable(const ScheduleKey& key) const {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            return it->second;
+        }
+        auto table = std::make_shared<const ScheduleTable>(buildDates(key));
+        cache.emplace(key, table);
+        return table;
+    }
+
+    /**
+     * Next execution date strictly after current for an SIP anchored on anchorDate.
+     */
+    Date nextExecutionDate(Date anchorDate, Date current,
+                           SIPFrequency frequency, BusinessDayRule rule) const {
+        auto table = getTable(makeKey(anchorDate, frequency, rule));
+        Date next;
+        if (table->covers(current) && table->nextAfter(current, next)) {
+            return next;
+        }
+        return advance(current, frequency);
+    }
+
+    /**
+     * The next count execution dates strictly after the given date (forecasting).
+     */
+    std::vector<Date> upcomingExecutionDates(Date anchorDate, Date after, SIPFrequency frequency,
+                                             BusinessDayRule rule, size_t count) const {
+        auto table = getTable(makeKey(anchorDate, frequency, rule));
+        std::vector<Date> result;
+        if (table->covers(after)) {
+            result = table->nextDates(after, count);
+        }
+        Date last = result.empty() ? after : result.back();
+        while (result.size() < count) {
+            last = advance(last, frequency);
+            result.push_back(last);
+        }
+        return result;
+    }
+
+    /**
+     * Number of tables built so far.
+     */
+    size_t cachedTableCount() const {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        return cache.size();
+    }
+
+private:
+    static Date advance(Date date, SIPFrequency frequency) {
+        switch (frequency) {
+            case SIPFrequency::WEEKLY:
+                return DateUtils::addWeeks(date, 1);
+            case SIPFrequency::QUARTERLY:
+                return DateUtils::addQuarters(date, 1);
+            case SIPFrequency::MONTHLY:
+            default:
+                return DateUtils::addMonths(date, 1);
+        }
+    }
+
+    /**
+     * Shift a day number according to the business-day rule (weekends only).
+     */
+    static int adjustForBusinessDay(int days, BusinessDayRule rule) {
+        int weekday = DateUtils::dayOfWeekFromDays(days);
+        if (rule == BusinessDayRule::NONE || (weekday != 0 && weekday != 6)) {
+            return days;
+        }
+        int following = days + (weekday == 6 ? 2 : 1);
+        int preceding = days - (weekday == 6 ? 1 : 2);
+        switch (rule) {
+            case BusinessDayRule::FOLLOWING:
+                return following;
+            case BusinessDayRule::PRECEDING:
+                return preceding;
+            case BusinessDayRule::MODIFIED_FOLLOWING: {
+                int y1, m1, d1, y2, m2, d2;
+                DateUtils::civilFromDays(days, y1, m1, d1);
+                DateUtils::civilFromDays(following, y2, m2, d2);
+                return m1 == m2 ? following : preceding;
+            }
+            default:
+                return days;
+        }
+    }
+
+    static Date toDate(int days) {
+        int year, month, day;
+        DateUtils::civilFromDays(days, year, month, day);
+        return DateUtils::createDate(year, month, day);
+    }
+
+    std::vector<Date> buildDates(const ScheduleKey& key) const {
+        std::vector<Date> dates;
+        if (key.frequency == SIPFrequency::WEEKLY) {
+            int first = DateUtils::daysFromCivil(firstYear, 1, 1);
+            int last = DateUtils::daysFromCivil(lastYear, 12, 31);
+            first += (key.anchorDay - DateUtils::dayOfWeekFromDays(first) + 7) % 7;
+            dates.reserve(static_cast<size_t>((last - first) / 7 + 1));
+            for (int days = first; days <= last; days += 7) {
+                dates.push_back(toDate(adjustForBusinessDay(days, key.rule)));
+            }
+            return dates;
+        }
+
+        int step = key.frequency == SIPFrequency::QUARTERLY ? 3 : 1;
+        dates.reserve(static_cast<size_t>((lastYear - firstYear + 1) * 12 / step));
+        for (int year = firstYear; year <= lastYear; ++year) {
+            for (int month = 1 + key.anchorMonthPhase % step; month <= 12; month += step) {
+                int day = std::min(key.anchorDay, DateUtils::getDaysInMonth(year, month));
+                int days = DateUtils::daysFromCivil(year, month, day);
+                dates.push_back(toDate(adjustForBusinessDay(days, key.rule)));
+            }
+        }
+        return dates;
+    }
+};
+
+} // namespace sip
+
+#endif // SCHEDULE_GENERATOR_H
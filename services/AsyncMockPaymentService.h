@@ -0,0 +1,367 @@
+#ifndef ASYNC_MOCK_PAYMENT_SERVICE_H
+#define ASYNC_MOCK_PAYMENT_SERVICE_H
+
+#include "IPaymentService.h"
+#include "../utils/Exceptions.h"
+#include "../utils/IdempotencyStore.h"
+#include "../utils/RandomSource.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sip {
+
+/**
+ * How long the mock gateway takes to complete a payment.
+ *   FIXED     - always medianMs
+ *   LOGNORMAL - lognormal around medianMs with log-space spread sigma
+ *   LONG_TAIL - LOGNORMAL, but a tailProbability share of payments take
+ *               tailMultiplier times as long (timeouts, retries upstream)
+ */
+enum class LatencyDistribution { FIXED, LOGNORMAL, LONG_TAIL };
+
+struct PaymentLatency {
+    LatencyDistribution distribution;
+    double medianMs;
+    double sigma;
+    double tailProbability;
+    double tailMultiplier;
+
+    static PaymentLatency fixed(double ms) {
+        return PaymentLatency{LatencyDistribution::FIXED, ms, 0.0, 0.0, 1.0};
+    }
+
+    static PaymentLatency lognormal(double medianMs, double sigma) {
+        return PaymentLatency{LatencyDistribution::LOGNORMAL, medianMs, sigma, 0.0, 1.0};
+    }
+
+    static PaymentLatency longTail(double medianMs, double sigma, double tailProbability, double tailMultiplier) {
+        return PaymentLatency{LatencyDistribution::LONG_TAIL, medianMs, sigma, tailProbability, tailMultiplier};
+    }
+
+    double sampleMs(PhiloxStream& random) const {
+        if (distribution == LatencyDistribution::FIXED) {
+            return medianMs;
+        }
+        double ms = medianMs * std::exp(sigma * random.nextNormal());
+        if (distribution == LatencyDistribution::LONG_TAIL && random.nextUniform() < tailProbability) {
+            ms *= tailMultiplier;
+        }
+        return ms;
+    }
+};
+
+/**
+ * Behaviour of AsyncMockPaymentService. Rates are probabilities per payment.
+ */
+struct PaymentGatewayProfile {
+    PaymentLatency latency;
+    double failureRate;
+    double duplicateRate;   // Callback delivered a second time, one more latency later
+    double reorderRate;     // Callback held back by reorderDelayMs, landing after later payments
+    double reorderDelayMs;
+    unsigned workerThreads;
+
+    PaymentGatewayProfile()
+        : latency(PaymentLatency::lognormal(2.0, 0.5)), failureRate(0.0), duplicateRate(0.0),
+          reorderRate(0.0), reorderDelayMs(20.0), workerThreads(4) {}
+};
+
+/**
+ * Counters since the gateway was created.
+ */
+struct PaymentGatewayStats {
+    uint64_t initiated;
+    uint64_t roundTrips;          // initiatePayment and initiatePayments calls
+    uint64_t callbacksDelivered;  // Including duplicates
+    uint64_t failures;
+    uint64_t duplicates;
+    uint64_t reordered;
+    uint64_t callbackErrors;      // Callbacks that threw
+    size_t maxOutstanding;        // Most callbacks waiting at once
+
+    PaymentGatewayStats()
+        : initiated(0), roundTrips(0), callbacksDelivered(0), failures(0), duplicates(0), reordered(0),
+          callbackErrors(0), maxOutstanding(0) {}
+};
+
+/**
+ * Mock payment gateway that completes payments asynchronously, like a real
+ * one: initiatePayment returns at once and the callback (then the completion
+ * handler) runs later on one of a pool of worker threads, after a latency
+ * drawn from the profile. Callbacks can arrive concurrently, out of order
+ * and more than once, so callers must be thread-safe and idempotent.
+ * initiatePayments queues a whole batch in one call, as one round trip.
+ *
+ * Outcomes, latencies and injected faults are drawn on the initiating
+ * thread from a RandomSource, so a seeded run makes the same decisions for
+ * the same sequence of payments.
+ */
+class AsyncMockPaymentService : public IPaymentService {
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Completion {
+        Clock::time_point due;
+        uint64_t sequence;  // Initiation order, breaks ties
+        std::string transactionId;
+        PaymentStatus status;
+        PaymentCallback callback;                  // Single payments
+        std::shared_ptr<IPaymentBatchSink> sink;   // Batched payments, with index
+        size_t index;
+    };
+
+    // A payment's drawn outcome and injected faults
+    struct Outcome {
+        PaymentStatus status;
+        double latencyMs;
+        double duplicateMs;  // 0 if not duplicated
+        bool reordered;
+    };
+
+    struct LaterFirst {
+        bool operator()(const Completion& a, const Completion& b) const {
+            return a.due != b.due ? a.due > b.due : a.sequence > b.sequence;
+        }
+    };
+
+    PaymentGatewayProfile profile;
+    std::shared_ptr<RandomSource> random;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;  // Workers: new completion or stopping
+    std::condition_variable idle;  // waitForIdle: nothing queued or running
+    std::priority_queue<Completion, std::vector<Completion>, LaterFirst> completions;
+    size_t running;
+    bool stopping;
+    uint64_t nextSequence;
+    PaymentGatewayStats stats;
+    PaymentCallback completionHandler;
+    IdempotencyStore processedCallbacks;  // For onPaymentCallback idempotency
+    std::vector<std::thread> workers;
+
+    static Clock::duration toDuration(double ms) {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(ms));
+    }
+
+    Outcome drawOutcome(PhiloxStream& stream) const {
+        Outcome outcome;
+        outcome.status = stream.nextUniform() < profile.failureRate ? PaymentStatus::FAILURE : PaymentStatus::SUCCESS;
+        outcome.latencyMs = profile.latency.sampleMs(stream);
+        outcome.reordered = stream.nextUniform() < profile.reorderRate;
+        if (outcome.reordered) {
+            outcome.latencyMs += profile.reorderDelayMs;
+        }
+        bool duplicated = stream.nextUniform() < profile.duplicateRate;
+        outcome.duplicateMs = duplicated ? outcome.latencyMs + profile.latency.sampleMs(stream) : 0.0;
+        return outcome;
+    }
+
+    /**
+     * Queue a payment's callback (twice if duplicated). Caller holds mutex.
+     * @return Sequence number of its first callback
+     */
+    uint64_t enqueue(const Outcome& outcome, Clock::time_point now, const std::string& transactionId,
+                     const PaymentCallback& callback, const std::shared_ptr<IPaymentBatchSink>& sink, size_t index) {
+        uint64_t sequence = nextSequence++;
+        completions.push(Completion{now + toDuration(outcome.latencyMs), sequence, transactionId, outcome.status,
+                                    callback, sink, index});
+        if (outcome.duplicateMs > 0.0) {
+            completions.push(Completion{now + toDuration(outcome.duplicateMs), nextSequence++, transactionId,
+                                        outcome.status, callback, sink, index});
+            stats.duplicates++;
+        }
+        stats.initiated++;
+        stats.failures += outcome.status == PaymentStatus::FAILURE ? 1 : 0;
+        stats.reordered += outcome.reordered ? 1 : 0;
+        return sequence;
+    }
+
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            if (completions.empty()) {
+                wake.wait(lock);
+                continue;
+            }
+            Clock::time_point due = completions.top().due;
+            if (Clock::now() < due) {
+                wake.wait_until(lock, due);
+                continue;
+            }
+            Completion completion = completions.top();
+            completions.pop();
+            if (!completions.empty()) {
+                wake.notify_one();  // Hand the next completion to another worker
+            }
+            running++;
+            PaymentCallback handler = completionHandler;
+            lock.unlock();
+
+            bool failed = false;
+            try {
+                if (completion.sink) {
+                    completion.sink->onPaymentResult(completion.index, completion.transactionId, completion.status);
+                } else if (completion.callback) {
+                    completion.callback(completion.transactionId, completion.status);
+                }
+                if (handler) {
+                    handler(completion.transactionId, completion.status);
+                }
+            } catch (...) {
+                failed = true;  // A worker must survive a failing callback
+            }
+
+            lock.lock();
+            running--;
+            stats.callbacksDelivered++;
+            stats.callbackErrors += failed ? 1 : 0;
+            if (completions.empty() && running == 0) {
+                idle.notify_all();
+            }
+        }
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param random Source of outcomes and latencies; a randomly seeded one if null
+     */
+    explicit AsyncMockPaymentService(const PaymentGatewayProfile& profile = PaymentGatewayProfile(),
+                                     std::shared_ptr<RandomSource> random = nullptr)
+        : profile(profile),
+          random(random ? std::move(random) : std::make_shared<RandomSource>()),
+          running(0), stopping(false), nextSequence(0), processedCallbacks(callbackRetryWindow()) {
+        if (profile.workerThreads == 0) {
+            throw ValidationException("Payment gateway needs at least one worker thread");
+        }
+        if (!(profile.latency.medianMs >= 0.0) || !(profile.latency.sigma >= 0.0) ||
+            !(profile.latency.tailMultiplier >= 1.0) || !(profile.reorderDelayMs >= 0.0)) {
+            throw ValidationException("Payment latencies must be non-negative");
+        }
+        for (unsigned t = 0; t < profile.workerThreads; ++t) {
+            workers.emplace_back([this]() { work(); });
+        }
+    }
+
+    /**
+     * Stops the workers after the callbacks they are running; callbacks not
+     * yet due are dropped (call waitForIdle first to deliver everything).
+     */
+    ~AsyncMockPaymentService() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    AsyncMockPaymentService(const AsyncMockPaymentService&) = delete;
+    AsyncMockPaymentService& operator=(const AsyncMockPaymentService&) = delete;
+
+    void initiatePayment(const std::string& transactionId,
+                         double amount,
+                         PaymentCallback callback) override {
+        (void)amount;
+        Outcome outcome = drawOutcome(random->threadStream());
+        Clock::time_point now = Clock::now();
+        bool earliest;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            uint64_t sequence = enqueue(outcome, now, transactionId, callback, nullptr, 0);
+            earliest = completions.top().sequence == sequence;
+            stats.roundTrips++;
+            stats.maxOutstanding = std::max(stats.maxOutstanding, completions.size() + running);
+        }
+        if (earliest) {
+            wake.notify_one();  // Workers are parked on a later deadline, or idle
+        }
+    }
+
+    /**
+     * Outcomes are drawn outside the lock and the whole batch is queued
+     * under one acquisition; completions share the sink rather than holding
+     * a callback each.
+     */
+    void initiatePayments(const PaymentRequest* requests, size_t count,
+                          std::shared_ptr<IPaymentBatchSink> sink) override {
+        if (count == 0) {
+            return;
+        }
+        PhiloxStream& stream = random->threadStream();
+        std::vector<Outcome> outcomes(count);
+        for (size_t i = 0; i < count; ++i) {
+            outcomes[i] = drawOutcome(stream);
+        }
+        Clock::time_point now = Clock::now();
+        bool earliest;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            uint64_t first = nextSequence;
+            for (size_t i = 0; i < count; ++i) {
+                enqueue(outcomes[i], now, requests[i].transactionId, PaymentCallback(), sink, i);
+            }
+            earliest = completions.top().sequence >= first;
+            stats.roundTrips++;
+            stats.maxOutstanding = std::max(stats.maxOutstanding, completions.size() + running);
+        }
+        if (earliest) {
+            wake.notify_one();
+        }
+    }
+
+    void onPaymentCallback(const std::string& transactionId,
+                           PaymentStatus status) override {
+        if (!processedCallbacks.tryRecord(transactionId)) {
+            return;  // Already processed
+        }
+        PaymentCallback handler;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            handler = completionHandler;
+        }
+        if (handler) {
+            handler(transactionId, status);
+        }
+    }
+
+    void setPaymentCompletionHandler(PaymentCallback handler) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        completionHandler = handler;
+    }
+
+    /**
+     * Block until every callback initiated so far (duplicates included)
+     * has been delivered. Must not be called from a callback.
+     */
+    void waitForIdle() {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this]() { return completions.empty() && running == 0; });
+    }
+
+    // Callbacks queued or running
+    size_t getOutstandingCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return completions.size() + running;
+    }
+
+    PaymentGatewayStats getStats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+};
+
+} // namespace sip
+
+#endif // ASYNC_MOCK_PAYMENT_SERVICE_H
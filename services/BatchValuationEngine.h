@@ -0,0 +1,303 @@
+#ifndef BATCH_VALUATION_ENGINE_H
+#define BATCH_VALUATION_ENGINE_H
+
+#include "IPortfolioService.h"
+#include "IMarketPriceService.h"
+#include "../models/NavSnapshot.h"
+#include "../repositories/ISIPRepository.h"
+#include "../repositories/ITransactionRepository.h"
+#include "../repositories/IPortfolioSnapshotRepository.h"
+#include "../utils/IdInterner.h"
+#include "../utils/ParallelFor.h"
+#include "../utils/RepositoryLock.h"
+#include "../utils/ValuationKernel.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Every SIP holding in the system, stored column-wise and grouped by user.
+ * Holdings of user u occupy [userOffsets[u], userOffsets[u + 1]).
+ */
+struct HoldingColumns {
+    std::vector<std::string> userIds;
+    std::vector<uint32_t> userOffsets;
+    std::vector<uint32_t> fundHandles;
+    std::vector<double> units;
+    std::vector<double> invested;
+    std::vector<uint8_t> states;
+    size_t fundHandleLimit;  // One past the largest fund handle in fundHandles
+
+    HoldingColumns() : fundHandleLimit(0) {}
+
+    size_t userCount() const { return userIds.size(); }
+    size_t holdingCount() const { return fundHandles.size(); }
+};
+
+/**
+ * Output of one batch valuation run. summaries[i] belongs to userIds[i].
+ */
+struct BatchValuationResult {
+    std::vector<std::string> userIds;
+    std::vector<PortfolioSummary> summaries;
+    size_t holdingCount;
+    size_t fundCount;         // Funds priced in the snapshot
+    unsigned threadCount;
+    double gatherSeconds;     // Walking the repositories into HoldingColumns
+    double snapshotSeconds;   // One NAV lookup per fund
+    double valuationSeconds;  // Parallel per-user valuation
+    double recordSeconds;     // Appending to the snapshot repository (runNightly only)
+
+    BatchValuationResult()
+        : holdingCount(0), fundCount(0), threadCount(0),
+          gatherSeconds(0), snapshotSeconds(0), valuationSeconds(0), recordSeconds(0) {}
+
+    double totalSeconds() const {
+        return gatherSeconds + snapshotSeconds + valuationSeconds + recordSeconds;
+    }
+
+    double usersPerSecond() const {
+        double seconds = totalSeconds();
+        return seconds > 0 ? static_cast<double>(userIds.size()) / seconds : 0.0;
+    }
+
+    double holdingsPerSecond() const {
+        double seconds = totalSeconds();
+        return seconds > 0 ? static_cast<double>(holdingCount) / seconds : 0.0;
+    }
+};
+
+/**
+ * Nightly revaluation of every user's portfolio.
+ *
+ * Instead of calling getPortfolioSummary once per user, the engine walks all
+ * SIPs once into HoldingColumns, prices each fund once into a NavSnapshot,
+ * and then values users in parallel through ValuationKernel. Holdings are
+ * grouped by user, not by fund: the snapshot already prices each fund once,
+ * and a user's holdings in one run let one worker total them alone. Workers
+ * only read the columns and the snapshot and write disjoint slots, so no
+ * locking is needed. With a repository lock, the repository reads hold it.
+ * Results match PortfolioServiceImpl::getPortfolioSummary.
+ */
+class BatchValuationEngine {
+private:
+    std::shared_ptr<ISIPRepository> sipRepository;
+    std::shared_ptr<ITransactionRepository> transactionRepository;
+    std::shared_ptr<IMarketPriceService> marketPriceService;
+    std::shared_ptr<IPortfolioSnapshotRepository> snapshotRepository;  // Optional
+    std::shared_ptr<std::mutex> repositoryMutex;                        // Optional
+    unsigned threadCount;
+
+    typedef std::chrono::steady_clock Clock;
+
+    static double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param threadCount Worker threads for valuation (0 = one per core)
+     * @param snapshotRepo Where runNightly records each user's daily value
+     * @param repositoryLock If set, held while the SIP and transaction
+     *                       repositories are read (see SIPScheduler::getRepositoryMutex)
+     */
+    BatchValuationEngine(std::shared_ptr<ISIPRepository> sipRepo,
+                         std::shared_ptr<ITransactionRepository> txnRepo,
+                         std::shared_ptr<IMarketPriceService> marketSvc,
+                         unsigned threadCount = 0,
+                         std::shared_ptr<IPortfolioSnapshotRepository> snapshotRepo = nullptr,
+                         std::shared_ptr<std::mutex> repositoryLock = nullptr)
+        : sipRepository(std::move(sipRepo)),
+          transactionRepository(std::move(txnRepo)),
+          marketPriceService(std::move(marketSvc)),
+          snapshotRepository(std::move(snapshotRepo)),
+          repositoryMutex(std::move(repositoryLock)),
+          threadCount(threadCount) {}
+
+    /**
+     * Walk every SIP once and lay out its holding column-wise, grouped by user.
+     * The walk is serial; the per-SIP transaction totals are then looked up
+     * in parallel.
+     */
+    HoldingColumns gatherHoldings() const {
+        HoldingColumns columns;
+        std::vector<std::string> sipIds;
+        std::unique_lock<std::mutex> lock = RepositoryLock::acquire(repositoryMutex);
+        size_t expected = sipRepository->count();
+        sipIds.reserve(expected);
+        columns.fundHandles.reserve(expected);
+        columns.states.reserve(expected);
+
+        // The repository hands over each user's SIPs together, so users need no regrouping
+        sipRepository->forEachSIPByUser([&](const SIPRecordView& view) {
+            if (columns.userIds.empty() || columns.userIds.back() != view.cold.userId) {
+                columns.userIds.push_back(view.cold.userId);
+                columns.userOffsets.push_back(static_cast<uint32_t>(columns.fundHandles.size()));
+            }
+            sipIds.push_back(view.cold.id);
+            columns.fundHandles.push_back(view.hot.fundHandle);
+            columns.states.push_back(view.hot.state);
+            columns.fundHandleLimit = std::max(columns.fundHandleLimit,
+                                               static_cast<size_t>(view.hot.fundHandle) + 1);
+        });
+        columns.userOffsets.push_back(static_cast<uint32_t>(columns.fundHandles.size()));
+
+        // Const lookups only, so workers can share the repository
+        const ITransactionRepository& transactions = *transactionRepository;
+        columns.units.resize(sipIds.size());
+        columns.invested.resize(sipIds.size());
+        ParallelFor::run(sipIds.size(), threadCount,
+            [&transactions, &sipIds, &columns](unsigned, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    SIPTransactionTotals totals = transactions.getSuccessfulTotalsBySipId(sipIds[i]);
+                    columns.units[i] = totals.totalUnits;
+                    columns.invested[i] = totals.totalInvested;
+                }
+            });
+        return columns;
+    }
+
+    /**
+     * Price every fund referenced by the holdings exactly once.
+     * Funds without a price are left at NAV 0, as in getPortfolioSummary.
+     */
+    NavSnapshot captureNavSnapshot(const HoldingColumns& holdings) const {
+        NavSnapshot snapshot;
+        std::vector<uint8_t> priced;
+        for (uint32_t handle : holdings.fundHandles) {
+            if (handle < priced.size() && priced[handle]) {
+                continue;
+            }
+            if (handle >= priced.size()) {
+                priced.resize(static_cast<size_t>(handle) + 1, 0);
+            }
+            priced[handle] = 1;
+            snapshot.setNav(handle, marketPriceService->getNAVByHandle(handle));
+        }
+        return snapshot;
+    }
+
+    /**
+     * Value every user against the given snapshot, in parallel.
+     * summaries must already have holdings.userCount() entries.
+     */
+    void valueHoldings(const HoldingColumns& holdings, const NavSnapshot& snapshot,
+                       std::vector<PortfolioSummary>& summaries) const {
+        // The kernel indexes NAVs by fund handle without bounds checks, so pad
+        // a snapshot that predates some of the funds in these holdings
+        const std::vector<double>* navs = &snapshot.navs;
+        std::vector<double> padded;
+        if (snapshot.navs.size() < holdings.fundHandleLimit) {
+            padded = snapshot.navs;
+            padded.resize(holdings.fundHandleLimit, 0.0);
+            navs = &padded;
+        }
+
+        std::vector<double> currentValue(holdings.holdingCount());
+        ParallelFor::run(holdings.userCount(), threadCount,
+            [&holdings, navs, &currentValue, &summaries](unsigned, size_t begin, size_t end) {
+                size_t first = holdings.userOffsets[begin];
+                size_t last = holdings.userOffsets[end];
+                ValuationKernel::Columns columns;
+                columns.count = last - first;
+                columns.units = holdings.units.data() + first;
+                columns.fundIndex = holdings.fundHandles.data() + first;
+                columns.navs = navs->data();
+                columns.invested = holdings.invested.data() + first;
+                columns.currentValue = currentValue.data() + first;
+                columns.gainLoss = nullptr;
+                columns.gainLossPercentage = nullptr;
+                ValuationKernel::value(columns);
+
+                for (size_t u = begin; u < end; ++u) {
+                    PortfolioSummary summary;
+                    for (uint32_t i = holdings.userOffsets[u]; i < holdings.userOffsets[u + 1]; ++i) {
+                        summary.totalInvested += holdings.invested[i];
+                        summary.totalCurrentValue += currentValue[i];
+                        summary.totalUnits += holdings.units[i];
+                        switch (static_cast<SIPState>(holdings.states[i])) {
+                            case SIPState::ACTIVE:
+                                summary.activeSIPCount++;
+                                break;
+                            case SIPState::PAUSED:
+                                summary.pausedSIPCount++;
+                                break;
+                            case SIPState::STOPPED:
+                                summary.stoppedSIPCount++;
+                                break;
+                        }
+                    }
+                    summary.gainLoss = summary.totalCurrentValue - summary.totalInvested;
+                    if (summary.totalInvested > 0) {
+                        summary.gainLossPercentage = (summary.gainLoss / summary.totalInvested) * 100.0;
+                    }
+                    summaries[u] = summary;
+                }
+            });
+    }
+
+    /**
+     * Revalue every user's portfolio against current NAVs.
+     */
+    BatchValuationResult run() const {
+        BatchValuationResult result;
+
+        Clock::time_point start = Clock::now();
+        HoldingColumns holdings = gatherHoldings();
+        result.gatherSeconds = secondsSince(start);
+
+        start = Clock::now();
+        NavSnapshot snapshot = captureNavSnapshot(holdings);
+        result.snapshotSeconds = secondsSince(start);
+
+        start = Clock::now();
+        result.summaries.resize(holdings.userCount());
+        valueHoldings(holdings, snapshot, result.summaries);
+        result.valuationSeconds = secondsSince(start);
+
+        size_t fundCount = 0;
+        for (double nav : snapshot.navs) {
+            if (nav != 0.0) {
+                ++fundCount;
+            }
+        }
+        result.fundCount = fundCount;
+        result.holdingCount = holdings.holdingCount();
+        result.threadCount = ParallelFor::resolveThreadCount(threadCount);
+        result.userIds = std::move(holdings.userIds);
+        return result;
+    }
+
+    /**
+     * The nightly job: revalue everything, then append each user's value for
+     * valuationDate to the snapshot repository (if one is configured).
+     */
+    BatchValuationResult runNightly(Date valuationDate) const {
+        BatchValuationResult result = run();
+        if (!snapshotRepository) {
+            return result;
+        }
+
+        Clock::time_point start = Clock::now();
+        std::vector<double> currentValues(result.summaries.size());
+        std::vector<double> investedAmounts(result.summaries.size());
+        for (size_t u = 0; u < result.summaries.size(); ++u) {
+            currentValues[u] = result.summaries[u].totalCurrentValue;
+            investedAmounts[u] = result.summaries[u].totalInvested;
+        }
+        snapshotRepository->appendAll(valuationDate, result.userIds, currentValues, investedAmounts);
+        result.recordSeconds = secondsSince(start);
+        return result;
+    }
+};
+
+} // namespace sip
+
+#endif // BATCH_VALUATION_ENGINE_H
@@ -0,0 +1,111 @@
+#ifndef CORPORATE_ACTION_SERVICE_H
+#define CORPORATE_ACTION_SERVICE_H
+
+#include "IMarketPriceService.h"
+#include "../repositories/IHoldingRepository.h"
+#include "../repositories/INavHistoryRepository.h"
+#include "../repositories/ISIPRepository.h"
+#include "../repositories/ITransactionRepository.h"
+#include "../utils/Exceptions.h"
+#include "../utils/RepositoryLock.h"
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sip {
+
+/**
+ * A unit split or bonus issue. unitMultiplier is units after / units before,
+ * and the NAV is divided by the same amount, so every holding keeps its value.
+ */
+struct CorporateAction {
+    std::string fundId;
+    double unitMultiplier;
+
+    CorporateAction(const std::string& fundId, double unitMultiplier)
+        : fundId(fundId), unitMultiplier(unitMultiplier) {}
+
+    // Each unit becomes unitsPerUnit units (1:10 split = 10)
+    static CorporateAction split(const std::string& fundId, int unitsPerUnit) {
+        return CorporateAction(fundId, unitsPerUnit);
+    }
+
+    // bonusUnits free units for every heldUnits units held (1:2 bonus = 1, 2)
+    static CorporateAction bonus(const std::string& fundId, int bonusUnits, int heldUnits) {
+        return CorporateAction(fundId, 1.0 + static_cast<double>(bonusUnits) / heldUnits);
+    }
+};
+
+/**
+ * Applies splits and bonus issues: the NAVs of all affected funds change as
+ * one price update, their recorded NAV history is rescaled to match, and the
+ * units of the funds' transactions and holdings are rescaled. Amounts
+ * invested are unchanged. With a repository lock (SIPScheduler's) the whole
+ * batch runs under it, so installments and payment callbacks see the funds
+ * either wholly before or wholly after the actions.
+ */
+class CorporateActionService {
+private:
+    std::shared_ptr<IMarketPriceService> marketPriceService;
+    std::shared_ptr<ISIPRepository> sipRepository;
+    std::shared_ptr<ITransactionRepository> transactionRepository;
+    std::shared_ptr<IHoldingRepository> holdingRepository;  // Optional
+    std::shared_ptr<INavHistoryRepository> navHistory;      // Optional
+    std::shared_ptr<std::mutex> repositoryMutex;            // Optional
+
+public:
+    /**
+     * Constructor.
+     * @param repositoryLock If set, held while an action batch is applied
+     *                       (see SIPScheduler::getRepositoryMutex)
+     */
+    CorporateActionService(std::shared_ptr<IMarketPriceService> marketSvc,
+                           std::shared_ptr<ISIPRepository> sipRepo,
+                           std::shared_ptr<ITransactionRepository> txnRepo,
+                           std::shared_ptr<IHoldingRepository> holdingRepo = nullptr,
+                           std::shared_ptr<INavHistoryRepository> navHistoryRepo = nullptr,
+                           std::shared_ptr<std::mutex> repositoryLock = nullptr)
+        : marketPriceService(std::move(marketSvc)),
+          sipRepository(std::move(sipRepo)),
+          transactionRepository(std::move(txnRepo)),
+          holdingRepository(std::move(holdingRepo)),
+          navHistory(std::move(navHistoryRepo)),
+          repositoryMutex(std::move(repositoryLock)) {}
+
+    /**
+     * Apply a batch of corporate actions.
+     * @throws ValidationException if a multiplier is not positive
+     * @throws FundNotFoundException if a fund has no NAV (nothing is changed)
+     */
+    void apply(const std::vector<CorporateAction>& actions) {
+        std::vector<std::string> fundIds;
+        std::vector<double> navFactors;
+        for (const CorporateAction& action : actions) {
+            if (!(action.unitMultiplier > 0) || !std::isfinite(action.unitMultiplier)) {
+                throw ValidationException("Unit multiplier must be positive");
+            }
+            fundIds.push_back(action.fundId);
+            navFactors.push_back(1.0 / action.unitMultiplier);
+        }
+
+        std::unique_lock<std::mutex> lock = RepositoryLock::acquire(repositoryMutex);
+        marketPriceService->adjustNAVs(fundIds, navFactors);
+        if (navHistory) {
+            navHistory->adjustNAVs(fundIds, navFactors);
+        }
+        for (const CorporateAction& action : actions) {
+            for (const SIP& sip : sipRepository->getByFundId(action.fundId)) {
+                transactionRepository->scaleUnits(sip.getId(), action.unitMultiplier);
+            }
+            if (holdingRepository) {
+                holdingRepository->scaleUnits(action.fundId, action.unitMultiplier);
+            }
+        }
+    }
+};
+
+} // namespace sip
+
+#endif // CORPORATE_ACTION_SERVICE_H
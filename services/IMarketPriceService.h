@@ -1,7 +1,10 @@
 #ifndef IMARKET_PRICE_SERVICE_H
 #define IMARKET_PRICE_SERVICE_H
 
+#include "../models/NavChange.h"
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace sip {
 
@@ -22,6 +25,14 @@ public:
      */
     virtual double getCurrentNAV(const std::string& fundId) const = 0;
 
+    /**
+     * Get the current NAV by fund handle (see IdInterner::funds()), for hot
+     * paths that already hold handles. Never blocks behind NAV updates.
+     * 
+     * @return Current NAV, or 0 if the fund has no price
+     */
+    virtual double getNAVByHandle(uint32_t fundHandle) const = 0;
+
     /**
      * Update the NAV for a fund (for mock/testing purposes).
      * 
@@ -29,6 +40,48 @@ public:
      * @param nav New NAV value
      */
     virtual void updateNAV(const std::string& fundId, double nav) = 0;
+
+    /**
+     * Update the NAVs of many funds as one change (a daily NAV file):
+     * readers see either none or all of them. navs[i] belongs to fundIds[i].
+     * 
+     * @throws ValidationException if the columns differ in length or any NAV
+     *         is not positive; nothing is updated in that case
+     */
+    virtual void updateNAVs(const std::vector<std::string>& fundIds, const std::vector<double>& navs) = 0;
+
+    /**
+     * updateNAVs for funds already interned (IdInterner::funds()), without
+     * id lookups: navs[i] belongs to fundHandles[i].
+     * 
+     * @throws ValidationException as for updateNAVs; nothing is updated
+     */
+    virtual void setNAVsByHandle(const std::vector<uint32_t>& fundHandles, const std::vector<double>& navs) = 0;
+
+    /**
+     * Multiply the NAVs of many funds as one change: factors[i] applies to
+     * fundIds[i] (e.g. 0.1 after a 1:10 split).
+     * 
+     * @throws FundNotFoundException if a fund has no NAV
+     * @throws ValidationException if the columns differ in length or any
+     *         factor is not positive; nothing is updated in either case
+     */
+    virtual void adjustNAVs(const std::vector<std::string>& fundIds, const std::vector<double>& factors) = 0;
+
+    /**
+     * Subscribe to NAV changes, e.g. to refresh cached values of only the
+     * funds that moved. The listener is called asynchronously, on a
+     * background thread, with the funds whose NAV changed in each update;
+     * a subscriber that falls behind receives consecutive updates merged.
+     * 
+     * @return Subscription ID for unsubscribeNavChanges
+     */
+    virtual uint64_t subscribeNavChanges(NavChangeListener listener) = 0;
+
+    /**
+     * Stop a subscription. A batch already in delivery may still arrive.
+     */
+    virtual void unsubscribeNavChanges(uint64_t subscriptionId) = 0;
 };
 
 } // namespace sip
@@ -2,6 +2,9 @@
 #define IPAYMENT_SERVICE_H
 
 #include "../models/Enums.h"
+#include <chrono>
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <functional>
 
@@ -13,6 +16,29 @@ namespace sip {
  */
 using PaymentCallback = std::function<void(const std::string& transactionId, PaymentStatus status)>;
 
+/**
+ * One payment of a batch.
+ */
+struct PaymentRequest {
+    std::string transactionId;
+    double amount;
+};
+
+/**
+ * Receives the outcomes of a batch of payments. Called once per payment
+ * (more than once if the gateway redelivers), in any order and possibly
+ * concurrently from several threads.
+ */
+class IPaymentBatchSink {
+public:
+    virtual ~IPaymentBatchSink() = default;
+
+    /**
+     * @param index Position of the payment in the batch passed to initiatePayments
+     */
+    virtual void onPaymentResult(size_t index, const std::string& transactionId, PaymentStatus status) = 0;
+};
+
 /**
  * Service interface for payment operations.
  * This is a mock interface - actual payment is handled by external service.
@@ -21,6 +47,14 @@ class IPaymentService {
 public:
     virtual ~IPaymentService() = default;
 
+    /**
+     * How long a gateway may redeliver a callback. Records kept to reject
+     * duplicate callbacks must last at least this long.
+     */
+    static std::chrono::hours callbackRetryWindow() {
+        return std::chrono::hours(24);
+    }
+
     /**
      * Initiate a payment for the given amount.
      * 
@@ -32,6 +66,24 @@ public:
                                   double amount,
                                   PaymentCallback callback) = 0;
 
+    /**
+     * Initiate a batch of payments in one gateway round trip. Each outcome
+     * is reported to the sink with the payment's index in the batch, then
+     * to the completion handler, as for initiatePayment.
+     *
+     * The default sends the payments one at a time; gateways with a batch
+     * endpoint override it.
+     */
+    virtual void initiatePayments(const PaymentRequest* requests, size_t count,
+                                  std::shared_ptr<IPaymentBatchSink> sink) {
+        for (size_t i = 0; i < count; ++i) {
+            initiatePayment(requests[i].transactionId, requests[i].amount,
+                [sink, i](const std::string& transactionId, PaymentStatus status) {
+                    sink->onPaymentResult(i, transactionId, status);
+                });
+        }
+    }
+
     /**
      * Process payment callback (for handling external callbacks).
      * 
@@ -49,6 +49,24 @@ struct SIPPortfolioItem {
           currentInstallmentAmount(0), nextInstallmentAmount(0) {}
 };
 
+/**
+ * Consolidated holding in one fund, across all of a user's SIPs into it.
+ */
+struct FundHoldingItem {
+    std::string fundId;
+    std::string fundName;
+    double totalInvested;
+    double totalUnits;
+    double currentValue;
+    double currentNav;
+    double gainLoss;
+    double gainLossPercentage;
+
+    FundHoldingItem()
+        : totalInvested(0), totalUnits(0), currentValue(0), currentNav(0),
+          gainLoss(0), gainLossPercentage(0) {}
+};
+
 /**
  * Service interface for portfolio operations.
  */
@@ -62,6 +80,9 @@ public:
     // Get portfolio summary for a user
     virtual PortfolioSummary getPortfolioSummary(const std::string& userId) const = 0;
 
+    // Get a user's holdings consolidated per fund, ordered by fund ID
+    virtual std::vector<FundHoldingItem> getUserHoldings(const std::string& userId) const = 0;
+
     // Filter user's SIPs by state
     virtual std::vector<SIPPortfolioItem> filterByState(const std::string& userId, SIPState state) const = 0;
 
@@ -44,11 +44,17 @@ public:
     // Calculate current installment amount (considering step-up)
     virtual double calculateCurrentInstallmentAmount(const std::string& sipId) const = 0;
 
+    // Total the next `futureInstallments` installments will invest (considering step-up)
+    virtual double forecastInvestment(const std::string& sipId, int futureInstallments) const = 0;
+
     // Update SIP after successful payment
     virtual void onPaymentSuccess(const std::string& sipId) = 0;
 
     // Update next execution date
     virtual void updateNextExecutionDate(const std::string& sipId) = 0;
+
+    // Forecast the next `count` execution dates, starting with the pending one
+    virtual std::vector<Date> getUpcomingExecutionDates(const std::string& sipId, int count) const = 0;
 };
 
 } // namespace sip
@@ -0,0 +1,342 @@
+#ifndef MARKET_SIMULATOR_H
+#define MARKET_SIMULATOR_H
+
+#include "MockMarketPriceService.h"
+#include "../models/Enums.h"
+#include "../models/ReturnAssumption.h"
+#include "../repositories/IMutualFundRepository.h"
+#include "../repositories/INavHistoryRepository.h"
+#include "../utils/DateUtils.h"
+#include "../utils/Exceptions.h"
+#include "../utils/IdInterner.h"
+#include "../utils/PathKernel.h"
+#include "../utils/Philox.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Outcome of MarketSimulator::advance.
+ */
+struct MarketSimulationResult {
+    int days;
+    size_t fundCount;
+    double elapsedSeconds;
+
+    MarketSimulationResult() : days(0), fundCount(0), elapsedSeconds(0) {}
+};
+
+/**
+ * Daily geometric Brownian motion for every priced fund, published to a
+ * MockMarketPriceService (one NAV version per day) and, if given, recorded in
+ * the NAV history as the simulated date advances.
+ *
+ * Each fund's daily log return mixes a shock shared by its category with its
+ * own noise:
+ *
+ *   log(nav' / nav) = (mu - sigma^2/2) dt + sigma sqrt(dt) (sqrt(rho) Z_category + sqrt(1 - rho) e_fund)
+ *
+ * with mu = log(1 + expectedReturn), sigma the category's volatility,
+ * dt = 1/365 (every calendar day is a step) and rho the within-category
+ * correlation. The category shocks Z are correlated through the Cholesky
+ * factor of the category correlation matrix.
+ *
+ * Funds are laid out one contiguous block per category, so a day is one
+ * PathKernel step per category (AVX2 when available). Random numbers come
+ * from Philox with the counter derived from (fund position, day number): the
+ * path depends only on the seed, the fund set and the dates - advancing a
+ * year at once or a day at a time gives the same NAVs.
+ */
+class MarketSimulator {
+public:
+    static const uint64_t kDefaultSeed = 0x6B7D2026ULL;
+
+private:
+    static const size_t kCategories = kFundCategoryCount;
+
+    std::shared_ptr<MockMarketPriceService> marketPriceService;
+    std::shared_ptr<IMutualFundRepository> fundRepository;
+    std::shared_ptr<INavHistoryRepository> navHistoryRepository;  // Optional
+    uint64_t seed;
+    ReturnAssumption assumptions[kCategories];
+    double fundCorrelation;
+    double correlation[kCategories][kCategories];
+    double cholesky[kCategories][kCategories];  // Lower triangular
+
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * Priced funds grouped by category. Compact columns (fundIds, handles,
+     * navs) hold funds [begin[c], begin[c + 1]) of category c; the simulated
+     * column holds them from paddedBegin[c], each block rounded up to whole
+     * Philox quads.
+     */
+    struct Universe {
+        std::vector<std::string> fundIds;
+        std::vector<uint32_t> handles;
+        std::vector<double> navs;
+        std::vector<double> paddedNavs;
+        size_t begin[kCategories + 1];
+        size_t paddedBegin[kCategories + 1];
+    };
+
+    Universe loadUniverse() const {
+        std::vector<MutualFund> funds = fundRepository->getAll();
+        std::vector<std::string> ids;
+        ids.reserve(funds.size());
+        for (const MutualFund& fund : funds) {
+            ids.push_back(fund.getId());
+        }
+        std::vector<uint32_t> handles(ids.size());
+        IdInterner::funds().internAll(ids, handles.data());
+        std::vector<double> navs = marketPriceService->getStoredNAVs(handles);
+
+        Universe universe;
+        universe.begin[0] = 0;
+        universe.paddedBegin[0] = 0;
+        for (size_t c = 0; c < kCategories; ++c) {
+            for (size_t i = 0; i < funds.size(); ++i) {
+                if (static_cast<size_t>(funds[i].getCategory()) == c && navs[i] > 0) {
+                    universe.fundIds.push_back(ids[i]);
+                    universe.handles.push_back(handles[i]);
+                    universe.navs.push_back(navs[i]);
+                }
+            }
+            universe.begin[c + 1] = universe.fundIds.size();
+            size_t size = universe.begin[c + 1] - universe.begin[c];
+            universe.paddedBegin[c + 1] = universe.paddedBegin[c] + (size + 3) / 4 * 4;
+        }
+        universe.paddedNavs.assign(universe.paddedBegin[kCategories], 1.0);
+        for (size_t c = 0; c < kCategories; ++c) {
+            std::copy(universe.navs.begin() + static_cast<std::ptrdiff_t>(universe.begin[c]),
+                      universe.navs.begin() + static_cast<std::ptrdiff_t>(universe.begin[c + 1]),
+                      universe.paddedNavs.begin() + static_cast<std::ptrdiff_t>(universe.paddedBegin[c]));
+        }
+        return universe;
+    }
+
+    /**
+     * Correlated category shocks for one day: Z = L e with e drawn from
+     * Philox counters that fund draws never use.
+     */
+    void categoryShocks(uint64_t step, double* shocks) const {
+        double independent[(kCategories + 3) / 4 * 4];
+        for (size_t b = 0; b < (kCategories + 3) / 4; ++b) {
+            Philox4x32::Block block = Philox4x32::generate(UINT64_MAX - b, step, seed);
+            Philox4x32::toNormals(block, independent + 4 * b);
+        }
+        for (size_t i = 0; i < kCategories; ++i) {
+            double z = 0.0;
+            for (size_t j = 0; j <= i; ++j) {
+                z += cholesky[i][j] * independent[j];
+            }
+            shocks[i] = z;
+        }
+    }
+
+    /**
+     * Cholesky factor of a correlation matrix.
+     * @throws ValidationException if the matrix is not positive definite
+     */
+    static void factor(const double (&matrix)[kCategories][kCategories], double (&lower)[kCategories][kCategories]) {
+        for (size_t i = 0; i < kCategories; ++i) {
+            for (size_t j = 0; j < kCategories; ++j) {
+                lower[i][j] = 0.0;
+            }
+        }
+        for (size_t j = 0; j < kCategories; ++j) {
+            double diagonal = matrix[j][j];
+            for (size_t k = 0; k < j; ++k) {
+                diagonal -= lower[j][k] * lower[j][k];
+            }
+            if (!(diagonal > 1e-12)) {
+                throw ValidationException("Category correlations must form a positive definite matrix");
+            }
+            lower[j][j] = std::sqrt(diagonal);
+            for (size_t i = j + 1; i < kCategories; ++i) {
+                double sum = matrix[i][j];
+                for (size_t k = 0; k < j; ++k) {
+                    sum -= lower[i][k] * lower[j][k];
+                }
+                lower[i][j] = sum / lower[j][j];
+            }
+        }
+    }
+
+    static size_t categoryIndex(FundCategory category) {
+        size_t index = static_cast<size_t>(category);
+        if (index >= kCategories) {
+            throw ValidationException("Unknown fund category");
+        }
+        return index;
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param navHistoryRepo If set, every simulated day is recorded in it
+     * @param seed The same seed, funds and dates always give the same NAVs
+     */
+    MarketSimulator(std::shared_ptr<MockMarketPriceService> marketSvc,
+                    std::shared_ptr<IMutualFundRepository> fundRepo,
+                    std::shared_ptr<INavHistoryRepository> navHistoryRepo = nullptr,
+                    uint64_t seed = kDefaultSeed)
+        : marketPriceService(std::move(marketSvc)),
+          fundRepository(std::move(fundRepo)),
+          navHistoryRepository(std::move(navHistoryRepo)),
+          seed(seed),
+          fundCorrelation(0.7) {
+        // Equity-like categories move together; debt mostly on its own
+        static const double kDefaultCorrelation[kCategories][kCategories] = {
+            // EQUITY DEBT  HYBRID ELSS
+            {1.00, 0.05, 0.80, 0.90},  // EQUITY
+            {0.05, 1.00, 0.30, 0.05},  // DEBT
+            {0.80, 0.30, 1.00, 0.75},  // HYBRID
+            {0.90, 0.05, 0.75, 1.00},  // ELSS
+        };
+        for (size_t c = 0; c < kCategories; ++c) {
+            assumptions[c] = ReturnAssumption::defaultFor(static_cast<FundCategory>(c));
+            for (size_t k = 0; k < kCategories; ++k) {
+                correlation[c][k] = kDefaultCorrelation[c][k];
+            }
+        }
+        factor(correlation, cholesky);
+    }
+
+    void setReturnAssumption(FundCategory category, ReturnAssumption assumption) {
+        size_t index = categoryIndex(category);
+        if (assumption.expectedReturn <= -1.0 || assumption.volatility < 0.0) {
+            throw ValidationException("Expected return must be above -100% and volatility non-negative");
+        }
+        assumptions[index] = assumption;
+    }
+
+    ReturnAssumption getReturnAssumption(FundCategory category) const {
+        return assumptions[categoryIndex(category)];
+    }
+
+    /**
+     * Correlation between the daily shocks of two categories.
+     * @throws ValidationException if rho is outside (-1, 1) or the matrix
+     *         would no longer be positive definite (nothing is changed)
+     */
+    void setCategoryCorrelation(FundCategory a, FundCategory b, double rho) {
+        size_t i = categoryIndex(a), j = categoryIndex(b);
+        if (i == j) {
+            throw ValidationException("A category's correlation with itself is always 1");
+        }
+        if (!(rho > -1.0 && rho < 1.0)) {
+            throw ValidationException("Correlation must be between -1 and 1");
+        }
+        double candidate[kCategories][kCategories];
+        std::copy(&correlation[0][0], &correlation[0][0] + kCategories * kCategories, &candidate[0][0]);
+        candidate[i][j] = rho;
+        candidate[j][i] = rho;
+        factor(candidate, cholesky);  // Throws before anything is assigned
+        std::copy(&candidate[0][0], &candidate[0][0] + kCategories * kCategories, &correlation[0][0]);
+    }
+
+    double getCategoryCorrelation(FundCategory a, FundCategory b) const {
+        return correlation[categoryIndex(a)][categoryIndex(b)];
+    }
+
+    /**
+     * Share of a fund's daily variance that comes from its category's shock
+     * (0 = funds move independently, 1 = in lockstep).
+     */
+    void setFundCorrelation(double rho) {
+        if (!(rho >= 0.0 && rho <= 1.0)) {
+            throw ValidationException("Fund correlation must be between 0 and 1");
+        }
+        fundCorrelation = rho;
+    }
+
+    double getFundCorrelation() const {
+        return fundCorrelation;
+    }
+
+    /**
+     * Simulate the days after `from` up to and including from + days,
+     * starting from the funds' current NAVs. Each day is recorded in the NAV
+     * history first and then published as one price update.
+     * @throws ValidationException if days is not positive, or if the history
+     *         rejects a day (e.g. it already has later NAVs); days before it
+     *         stay published
+     */
+    MarketSimulationResult advance(Date from, int days) {
+        if (days <= 0) {
+            throw ValidationException("Number of days to simulate must be positive");
+        }
+        Clock::time_point start = Clock::now();
+        Universe universe = loadUniverse();
+        MarketSimulationResult result;
+        result.days = days;
+        result.fundCount = universe.fundIds.size();
+        if (universe.fundIds.empty()) {
+            result.elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+            return result;
+        }
+
+        const double dt = 1.0 / 365.0;
+        double drift[kCategories];
+        double commonScale[kCategories];
+        double diffusion[kCategories];
+        for (size_t c = 0; c < kCategories; ++c) {
+            double sigma = assumptions[c].volatility;
+            drift[c] = (std::log1p(assumptions[c].expectedReturn) - 0.5 * sigma * sigma) * dt;
+            commonScale[c] = sigma * std::sqrt(dt) * std::sqrt(fundCorrelation);
+            diffusion[c] = sigma * std::sqrt(dt) * std::sqrt(1.0 - fundCorrelation);
+        }
+
+        size_t widest = 0;
+        for (size_t c = 0; c < kCategories; ++c) {
+            widest = std::max(widest, universe.paddedBegin[c + 1] - universe.paddedBegin[c]);
+        }
+        std::vector<double> radiusUniforms(widest / 2);
+        std::vector<double> angleUniforms(widest / 2);
+        PathKernel::Step kernelStep;
+        kernelStep.radiusUniforms = radiusUniforms.data();
+        kernelStep.angleUniforms = angleUniforms.data();
+        kernelStep.installment = 0.0;
+
+        int firstDay = DateUtils::toDayNumber(from) + 1;
+        for (int day = firstDay; day < firstDay + days; ++day) {
+            uint64_t step = static_cast<uint64_t>(static_cast<uint32_t>(day));
+            double shocks[kCategories];
+            categoryShocks(step, shocks);
+            for (size_t c = 0; c < kCategories; ++c) {
+                size_t width = universe.paddedBegin[c + 1] - universe.paddedBegin[c];
+                if (width == 0) {
+                    continue;
+                }
+                PathKernel::fillUniforms(universe.paddedBegin[c] / 4, width / 4, step, seed,
+                                         radiusUniforms.data(), angleUniforms.data());
+                kernelStep.pairs = width / 2;
+                kernelStep.drift = drift[c] + commonScale[c] * shocks[c];
+                kernelStep.diffusion = diffusion[c];
+                kernelStep.values = universe.paddedNavs.data() + universe.paddedBegin[c];
+                PathKernel::advance(kernelStep);
+                std::copy(kernelStep.values, kernelStep.values + (universe.begin[c + 1] - universe.begin[c]),
+                          universe.navs.begin() + static_cast<std::ptrdiff_t>(universe.begin[c]));
+            }
+
+            if (navHistoryRepository) {
+                navHistoryRepository->appendAll(DateUtils::fromDayNumber(day), universe.fundIds, universe.navs);
+            }
+            marketPriceService->setNAVsByHandle(universe.handles, universe.navs);
+        }
+
+        result.elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return result;
+    }
+};
+
+} // namespace sip
+
+#endif // MARKET_SIMULATOR_H
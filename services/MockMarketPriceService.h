@@ -2,64 +2,210 @@
 #define MOCK_MARKET_PRICE_SERVICE_H
 
 #include "IMarketPriceService.h"
+#include "ScenarioTransform.h"
 #include "../utils/Exceptions.h"
+#include "../utils/IdInterner.h"
+#include "../utils/NavChangeDispatcher.h"
+#include "../utils/NavKernel.h"
+#include "../utils/NavTable.h"
+#include "../utils/RandomSource.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
 #include <unordered_map>
-#include <random>
 
 namespace sip {
 
 /**
  * Mock implementation of IMarketPriceService.
  * Provides configurable NAV values for testing.
+ *
+ * NAVs live in a NavTable keyed by fund handle: every update publishes a
+ * new immutable version, so readers (by handle, wait-free) always see one
+ * consistent set of prices and a bulk update (updateNAVs) is never half applied.
+ * While anyone is subscribed, the funds each update wrote are compared
+ * with the previous version (every fund, for whole-table transforms) and
+ * those that changed are queued for the subscribers.
  */
 class MockMarketPriceService : public IMarketPriceService {
 private:
-    std::unordered_map<std::string, double> navData;
+    NavTable navTable;
     bool enablePriceFluctuation;
     double fluctuationRange;  // +/- percentage for price fluctuation
+    std::shared_ptr<RandomSource> random;
+    NavChangeDispatcher navChanges;  // Declared after navTable: stops before the table goes away
+
+    void publishChanges(const NavSnapshot& previous, const NavSnapshot& published,
+                        const NavTable::WrittenHandles& written) {
+        if (!navChanges.hasSubscribers()) {
+            return;
+        }
+        NavChangeBatch batch;
+        batch.firstVersion = published.version;
+        batch.version = published.version;
+        // A write to most of the table is cheaper to diff in full than to sort
+        if (!written.everything && written.count <= published.navs.size() / 8) {
+            for (size_t i = 0; i < written.count; ++i) {
+                uint32_t handle = written.handles[i];
+                if (published.getNav(handle) != previous.getNav(handle)) {
+                    batch.changes.push_back(NavChange{handle, published.getNav(handle)});
+                }
+            }
+            std::sort(batch.changes.begin(), batch.changes.end(),
+                      [](const NavChange& a, const NavChange& b) { return a.fundHandle < b.fundHandle; });
+            batch.changes.erase(std::unique(batch.changes.begin(), batch.changes.end(),
+                                            [](const NavChange& a, const NavChange& b) {
+                                                return a.fundHandle == b.fundHandle;
+                                            }),
+                                batch.changes.end());
+            navChanges.publish(std::move(batch));
+            return;
+        }
+        const double* before = previous.navs.data();
+        const double* after = published.navs.data();
+        size_t common = std::min(previous.navs.size(), published.navs.size());
+        size_t changed = published.navs.size() - common;
+        for (size_t handle = 0; handle < common; ++handle) {
+            changed += after[handle] != before[handle] ? 1 : 0;
+        }
+        batch.changes.reserve(changed);
+        for (size_t handle = 0; handle < published.navs.size(); ++handle) {
+            if (handle >= common || after[handle] != before[handle]) {
+                batch.changes.push_back(NavChange{static_cast<uint32_t>(handle), after[handle]});
+            }
+        }
+        navChanges.publish(std::move(batch));
+    }
+
+    double applyFluctuation(double baseNav) const {
+        if (enablePriceFluctuation) {
+            // Apply random fluctuation
+            baseNav *= (1.0 + random->threadStream().nextUniform(-fluctuationRange, fluctuationRange));
+        }
+        return baseNav;
+    }
 
 public:
     /**
      * Constructor.
      * @param enableFluctuation If true, prices will fluctuate slightly each call
      * @param range Fluctuation range as percentage (e.g., 0.02 = +/-2%)
+     * @param random Source of the fluctuations; a randomly seeded one if null
      */
-    MockMarketPriceService(bool enableFluctuation = false, double range = 0.02)
-        : enablePriceFluctuation(enableFluctuation), fluctuationRange(range) {}
+    MockMarketPriceService(bool enableFluctuation = false, double range = 0.02,
+                           std::shared_ptr<RandomSource> random = nullptr)
+        : enablePriceFluctuation(enableFluctuation), fluctuationRange(range),
+          random(random ? std::move(random) : std::make_shared<RandomSource>()) {
+        navTable.setPublishObserver([this](const NavSnapshot& previous, const NavSnapshot& published,
+                                           const NavTable::WrittenHandles& written) {
+            publishChanges(previous, published, written);
+        });
+    }
+
+    MockMarketPriceService(const MockMarketPriceService&) = delete;
+    MockMarketPriceService& operator=(const MockMarketPriceService&) = delete;
 
     double getCurrentNAV(const std::string& fundId) const override {
-        auto it = navData.find(fundId);
-        if (it == navData.end()) {
-            throw FundNotFoundException(fundId);
-        }
-        
-        double baseNav = it->second;
-        
-        if (enablePriceFluctuation) {
-            // Apply random fluctuation
-            static std::random_device rd;
-            static std::mt19937 gen(rd());
-            std::uniform_real_distribution<> dis(-fluctuationRange, fluctuationRange);
-            baseNav *= (1.0 + dis(gen));
-        }
-        
-        return baseNav;
+        return applyFluctuation(getStoredNAV(fundId));
+    }
+
+    double getNAVByHandle(uint32_t fundHandle) const override {
+        double baseNav = navTable.getNav(fundHandle);
+        return baseNav > 0 ? applyFluctuation(baseNav) : 0.0;
     }
 
     void updateNAV(const std::string& fundId, double nav) override {
-        if (nav <= 0) {
+        if (!(nav > 0)) {
             throw ValidationException("NAV must be positive");
         }
-        navData[fundId] = nav;
+        navTable.set(IdInterner::funds().intern(fundId), nav);
+    }
+
+    void updateNAVs(const std::vector<std::string>& fundIds, const std::vector<double>& navs) override {
+        if (navs.size() != fundIds.size()) {
+            throw ValidationException("NAV batch columns must have one entry per fund");
+        }
+        for (double nav : navs) {
+            if (!(nav > 0) || !std::isfinite(nav)) {
+                throw ValidationException("NAV must be positive");
+            }
+        }
+        std::vector<uint32_t> handles(fundIds.size());
+        IdInterner::funds().internAll(fundIds, handles.data());
+        navTable.setAll(handles.data(), navs.data(), handles.size());
+    }
+
+    void setNAVsByHandle(const std::vector<uint32_t>& handles, const std::vector<double>& navs) override {
+        if (navs.size() != handles.size()) {
+            throw ValidationException("NAV batch columns must have one entry per fund");
+        }
+        for (double nav : navs) {
+            if (!(nav > 0) || !std::isfinite(nav)) {
+                throw ValidationException("NAV must be positive");
+            }
+        }
+        navTable.setAll(handles.data(), navs.data(), handles.size());
+    }
+
+    void adjustNAVs(const std::vector<std::string>& fundIds, const std::vector<double>& factors) override {
+        if (factors.size() != fundIds.size()) {
+            throw ValidationException("NAV batch columns must have one entry per fund");
+        }
+        for (double factor : factors) {
+            if (!(factor > 0) || !std::isfinite(factor)) {
+                throw ValidationException("NAV adjustment factor must be positive");
+            }
+        }
+        std::vector<uint32_t> handles(fundIds.size());
+        IdInterner& funds = IdInterner::funds();
+        for (size_t i = 0; i < fundIds.size(); ++i) {
+            handles[i] = funds.find(fundIds[i]);
+        }
+        navTable.update(handles.data(), handles.size(), [&](NavSnapshot& next) {
+            for (size_t i = 0; i < handles.size(); ++i) {
+                if (next.getNav(handles[i]) <= 0) {
+                    throw FundNotFoundException(fundIds[i]);
+                }
+            }
+            for (size_t i = 0; i < handles.size(); ++i) {
+                next.navs[handles[i]] *= factors[i];
+            }
+        });
+    }
+
+    uint64_t subscribeNavChanges(NavChangeListener listener) override {
+        return navChanges.subscribe(std::move(listener));
+    }
+
+    void unsubscribeNavChanges(uint64_t subscriptionId) override {
+        navChanges.unsubscribe(subscriptionId);
+    }
+
+    /**
+     * Wait until every NAV change published so far has reached the
+     * subscribers. Must not be called from a listener.
+     */
+    void flushNavChanges() {
+        navChanges.flush();
+    }
+
+    const NavChangeDispatcher& getNavChangeDispatcher() const {
+        return navChanges;
     }
 
     /**
      * Set NAV for multiple funds at once.
      */
     void setNAVs(const std::unordered_map<std::string, double>& navs) {
+        std::vector<uint32_t> handles;
+        std::vector<double> values;
+        IdInterner& funds = IdInterner::funds();
         for (const auto& pair : navs) {
-            navData[pair.first] = pair.second;
+            handles.push_back(funds.intern(pair.first));
+            values.push_back(pair.second);
         }
+        navTable.setAll(handles.data(), values.data(), handles.size());
     }
 
     /**
@@ -80,11 +226,26 @@ public:
      * Get the stored NAV (without fluctuation).
      */
     double getStoredNAV(const std::string& fundId) const {
-        auto it = navData.find(fundId);
-        if (it == navData.end()) {
+        uint32_t handle = IdInterner::funds().find(fundId);
+        double nav = handle == IdInterner::kInvalidHandle ? 0.0 : navTable.getNav(handle);
+        if (nav <= 0) {
             throw FundNotFoundException(fundId);
         }
-        return it->second;
+        return nav;
+    }
+
+    /**
+     * Stored NAVs (without fluctuation) of many funds, all from one version.
+     * 0 for a fund with no NAV.
+     */
+    std::vector<double> getStoredNAVs(const std::vector<uint32_t>& handles) const {
+        std::vector<double> navs(handles.size());
+        navTable.read([&](const NavSnapshot& snapshot) {
+            for (size_t i = 0; i < handles.size(); ++i) {
+                navs[i] = snapshot.getNav(handles[i]);
+            }
+        });
+        return navs;
     }
 
     /**
@@ -92,9 +253,50 @@ public:
      * @param percentage Change as decimal (e.g., 0.05 = 5% increase, -0.03 = 3% decrease)
      */
     void simulateMarketMovement(double percentage) {
-        for (auto& pair : navData) {
-            pair.second *= (1.0 + percentage);
+        double factor = 1.0 + percentage;
+        if (!(factor > 0) || !std::isfinite(factor)) {
+            throw ValidationException("Market movement must be greater than -100%");
         }
+        navTable.update([factor](NavSnapshot& next) {
+            NavKernel::scale(next.navs.data(), next.navs.size(), factor);
+        });
+    }
+
+    /**
+     * Apply market, category and fund shocks to the live NAVs as one update.
+     * @param categoriesByHandle See ScenarioTransform::categoriesByHandle
+     * @throws ValidationException if a shock is -100% or worse (nothing is updated)
+     */
+    void applyScenario(const MarketScenario& scenario, const std::vector<uint8_t>& categoriesByHandle) {
+        navTable.update([&](NavSnapshot& next) { ScenarioTransform::applyTo(scenario, next, categoriesByHandle); });
+    }
+
+    /**
+     * Replay a sequence of daily moves as one update: the days are
+     * compounded first (ScenarioTransform::compound), so the NAVs are touched once.
+     */
+    void replayScenarios(const std::vector<MarketScenario>& days, const std::vector<uint8_t>& categoriesByHandle) {
+        applyScenario(ScenarioTransform::compound("replay", days, categoriesByHandle), categoriesByHandle);
+    }
+
+    /**
+     * Number of NAV versions published so far (each update is one).
+     */
+    uint64_t getVersion() const {
+        return navTable.getVersion();
+    }
+
+    /**
+     * Number of funds with a NAV.
+     */
+    size_t getFundCount() const {
+        size_t count = 0;
+        navTable.read([&count](const NavSnapshot& snapshot) {
+            for (double nav : snapshot.navs) {
+                count += nav > 0 ? 1 : 0;
+            }
+        });
+        return count;
     }
 };
 
@@ -2,8 +2,11 @@
 #define MOCK_PAYMENT_SERVICE_H
 
 #include "IPaymentService.h"
+#include "../utils/IdempotencyStore.h"
+#include "../utils/RandomSource.h"
+#include <algorithm>
+#include <memory>
 #include <unordered_map>
-#include <random>
 
 namespace sip {
 
@@ -14,9 +17,10 @@ namespace sip {
 class MockPaymentService : public IPaymentService {
 private:
     PaymentCallback completionHandler;
-    std::unordered_map<std::string, bool> processedCallbacks;  // For idempotency
+    IdempotencyStore processedCallbacks;  // For idempotency, over the gateway retry window
     double successRate;  // Probability of payment success (0.0 to 1.0)
     bool autoComplete;   // If true, immediately calls callback; if false, waits for manual trigger
+    std::shared_ptr<RandomSource> random;
     
     // Pending payments waiting for manual completion
     std::unordered_map<std::string, std::pair<double, PaymentCallback>> pendingPayments;
@@ -26,9 +30,12 @@ public:
      * Constructor.
      * @param successRate Probability of success (default 1.0 = always succeed)
      * @param autoComplete If true, immediately processes payments
+     * @param random Source of the payment outcomes; a randomly seeded one if null
      */
-    MockPaymentService(double successRate = 1.0, bool autoComplete = true)
-        : successRate(successRate), autoComplete(autoComplete) {}
+    MockPaymentService(double successRate = 1.0, bool autoComplete = true,
+                       std::shared_ptr<RandomSource> random = nullptr)
+        : processedCallbacks(callbackRetryWindow()), successRate(successRate), autoComplete(autoComplete),
+          random(random ? std::move(random) : std::make_shared<RandomSource>()) {}
 
     void initiatePayment(const std::string& transactionId, 
                           double amount,
@@ -48,13 +55,28 @@ public:
         }
     }
 
+    void initiatePayments(const PaymentRequest* requests, size_t count,
+                          std::shared_ptr<IPaymentBatchSink> sink) override {
+        if (!autoComplete) {
+            // Pending payments keep a callback each, as for single payments
+            IPaymentService::initiatePayments(requests, count, std::move(sink));
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            PaymentStatus status = simulatePaymentResult();
+            sink->onPaymentResult(i, requests[i].transactionId, status);
+            if (completionHandler) {
+                completionHandler(requests[i].transactionId, status);
+            }
+        }
+    }
+
     void onPaymentCallback(const std::string& transactionId, 
                             PaymentStatus status) override {
         // Check idempotency
-        if (processedCallbacks.find(transactionId) != processedCallbacks.end()) {
+        if (!processedCallbacks.tryRecord(transactionId)) {
             return;  // Already processed
         }
-        processedCallbacks[transactionId] = true;
 
         // Call completion handler
         if (completionHandler) {
@@ -112,16 +134,12 @@ public:
      * Check if a callback was already processed.
      */
     bool isCallbackProcessed(const std::string& transactionId) const {
-        return processedCallbacks.find(transactionId) != processedCallbacks.end();
+        return processedCallbacks.contains(transactionId);
     }
 
 private:
     PaymentStatus simulatePaymentResult() {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::uniform_real_distribution<> dis(0.0, 1.0);
-        
-        return (dis(gen) < successRate) ? PaymentStatus::SUCCESS : PaymentStatus::FAILURE;
+        return (random->threadStream().nextUniform() < successRate) ? PaymentStatus::SUCCESS : PaymentStatus::FAILURE;
     }
 };
 
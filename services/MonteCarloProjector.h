@@ -0,0 +1,318 @@
+#ifndef MONTE_CARLO_PROJECTOR_H
+#define MONTE_CARLO_PROJECTOR_H
+
+#include "IMarketPriceService.h"
+#include "../models/Enums.h"
+#include "../models/ReturnAssumption.h"
+#include "../repositories/IMutualFundRepository.h"
+#include "../repositories/ISIPRepository.h"
+#include "../repositories/ITransactionRepository.h"
+#include "../utils/Exceptions.h"
+#include "../utils/ParallelFor.h"
+#include "../utils/PathKernel.h"
+#include "../utils/RepositoryLock.h"
+#include "../utils/StepUpEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Everything a projection needs, independent of where it came from.
+ */
+struct ProjectionParameters {
+    double currentValue;       // Corpus today (units held x current NAV)
+    double investedSoFar;      // Amount already invested
+    double baseAmount;
+    double stepUpPercentage;
+    int installmentsPaid;      // Next installment is installmentsPaid + 1
+    SIPFrequency frequency;
+    bool contributing;         // false: only the existing corpus is projected
+    ReturnAssumption returns;
+    int years;
+    size_t paths;
+
+    ProjectionParameters()
+        : currentValue(0), investedSoFar(0), baseAmount(0), stepUpPercentage(0),
+          installmentsPaid(0), frequency(SIPFrequency::MONTHLY), contributing(true),
+          returns(ReturnAssumption{0.0, 0.0}), years(0), paths(0) {}
+};
+
+/**
+ * Projected corpus at the end of one year: the 10th, 50th and 90th
+ * percentile across simulated paths, and the total invested by then.
+ */
+struct ProjectionBand {
+    int year;
+    double invested;
+    double p10;
+    double p50;
+    double p90;
+};
+
+/**
+ * Outcome of a projection; bands[i] is the end of year i + 1.
+ */
+struct ProjectionResult {
+    std::vector<ProjectionBand> bands;
+    size_t paths;
+    int stepsPerYear;
+    unsigned threadCount;
+    double elapsedSeconds;
+
+    ProjectionResult() : paths(0), stepsPerYear(0), threadCount(0), elapsedSeconds(0) {}
+};
+
+/**
+ * Monte Carlo projection of an SIP's future corpus for goal planning.
+ *
+ * Each path invests the SIP's installments (stepped up as the scheduler
+ * would) and grows the corpus by a lognormal return per period, drawn from
+ * the fund category's ReturnAssumption. Paths are simulated in blocks of
+ * kBlockPaths, one column per path, and each step of a block is one
+ * PathKernel call (AVX2 when available). Random numbers come from Philox
+ * with the counter derived from (path, step), so results depend only on the
+ * seed - not on the thread count or how blocks are split between threads.
+ */
+class MonteCarloProjector {
+public:
+    static const size_t kBlockPaths = 256;
+    static const uint64_t kDefaultSeed = 0x5EED2026ULL;
+
+private:
+    std::shared_ptr<ISIPRepository> sipRepository;
+    std::shared_ptr<ITransactionRepository> transactionRepository;
+    std::shared_ptr<IMutualFundRepository> fundRepository;
+    std::shared_ptr<IMarketPriceService> marketPriceService;
+    std::shared_ptr<std::mutex> repositoryMutex;  // Optional
+    unsigned threadCount;
+    uint64_t seed;
+    ReturnAssumption assumptions[kFundCategoryCount];
+
+    typedef std::chrono::steady_clock Clock;
+
+    static int stepsPerYear(SIPFrequency frequency) {
+        switch (frequency) {
+            case SIPFrequency::WEEKLY: return 52;
+            case SIPFrequency::QUARTERLY: return 4;
+            case SIPFrequency::MONTHLY:
+            default: return 12;
+        }
+    }
+
+    /**
+     * Simulate blocks [beginBlock, endBlock), writing each path's value at
+     * every year end into yearEndValues[year * paths + path].
+     */
+    void simulateBlocks(size_t beginBlock, size_t endBlock, size_t paths, int periodsPerYear,
+                        double startValue, const std::vector<double>& installments,
+                        double drift, double diffusion, std::vector<double>& yearEndValues) const {
+        const size_t blockPaths = kBlockPaths;
+        std::vector<double> values(blockPaths);
+        std::vector<double> radiusUniforms(blockPaths / 2);
+        std::vector<double> angleUniforms(blockPaths / 2);
+        const int steps = static_cast<int>(installments.size());
+
+        PathKernel::Step kernelStep;
+        kernelStep.pairs = blockPaths / 2;
+        kernelStep.radiusUniforms = radiusUniforms.data();
+        kernelStep.angleUniforms = angleUniforms.data();
+        kernelStep.drift = drift;
+        kernelStep.diffusion = diffusion;
+        kernelStep.values = values.data();
+
+        for (size_t blockIndex = beginBlock; blockIndex < endBlock; ++blockIndex) {
+            size_t firstPath = blockIndex * blockPaths;
+            size_t lanes = std::min(blockPaths, paths - firstPath);
+            std::fill(values.begin(), values.end(), startValue);
+
+            for (int step = 0; step < steps; ++step) {
+                PathKernel::fillUniforms(firstPath / 4, blockPaths / 4, static_cast<uint64_t>(step), seed,
+                                         radiusUniforms.data(), angleUniforms.data());
+                kernelStep.installment = installments[static_cast<size_t>(step)];
+                PathKernel::advance(kernelStep);
+                if ((step + 1) % periodsPerYear == 0) {
+                    size_t year = static_cast<size_t>((step + 1) / periodsPerYear - 1);
+                    std::copy(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(lanes),
+                              yearEndValues.begin() + static_cast<std::ptrdiff_t>(year * paths + firstPath));
+                }
+            }
+        }
+    }
+
+    /**
+     * Value at quantile q of [first, last) (nearest rank), partially sorting
+     * the range. Elements before `from` must already be partitioned below
+     * the result, which lets increasing quantiles reuse earlier passes.
+     */
+    static double* percentile(double* first, double* from, double* last, double q) {
+        size_t count = static_cast<size_t>(last - first);
+        double* nth = first + static_cast<size_t>(q * static_cast<double>(count - 1) + 0.5);
+        // With few paths nth can land on an earlier result, which is already in place
+        std::nth_element(std::min(from, nth), nth, last);
+        return nth;
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param threadCount Worker threads per projection (0 = one per core)
+     * @param seed Base seed; the same seed always gives the same bands
+     * @param repositoryLock If set, held while repositories are read
+     *                       (see SIPScheduler::getRepositoryMutex)
+     */
+    MonteCarloProjector(std::shared_ptr<ISIPRepository> sipRepo,
+                        std::shared_ptr<ITransactionRepository> txnRepo,
+                        std::shared_ptr<IMutualFundRepository> fundRepo,
+                        std::shared_ptr<IMarketPriceService> marketSvc,
+                        unsigned threadCount = 0,
+                        uint64_t seed = kDefaultSeed,
+                        std::shared_ptr<std::mutex> repositoryLock = nullptr)
+        : sipRepository(std::move(sipRepo)),
+          transactionRepository(std::move(txnRepo)),
+          fundRepository(std::move(fundRepo)),
+          marketPriceService(std::move(marketSvc)),
+          repositoryMutex(std::move(repositoryLock)),
+          threadCount(threadCount),
+          seed(seed) {
+        for (size_t c = 0; c < kFundCategoryCount; ++c) {
+            assumptions[c] = ReturnAssumption::defaultFor(static_cast<FundCategory>(c));
+        }
+    }
+
+    void setReturnAssumption(FundCategory category, ReturnAssumption assumption) {
+        size_t index = static_cast<size_t>(category);
+        if (index >= kFundCategoryCount) {
+            throw ValidationException("Unknown fund category");
+        }
+        if (assumption.expectedReturn <= -1.0 || assumption.volatility < 0.0) {
+            throw ValidationException("Expected return must be above -100% and volatility non-negative");
+        }
+        assumptions[index] = assumption;
+    }
+
+    ReturnAssumption getReturnAssumption(FundCategory category) const {
+        size_t index = static_cast<size_t>(category);
+        return index < kFundCategoryCount ? assumptions[index] : assumptions[0];
+    }
+
+    /**
+     * Project an SIP from its current state: units already bought valued at
+     * today's NAV, then the remaining installments over the given number of
+     * years. Paused and stopped SIPs only grow their existing corpus.
+     */
+    ProjectionResult projectSIP(const std::string& sipId, int years, size_t paths) const {
+        std::unique_lock<std::mutex> lock = RepositoryLock::acquire(repositoryMutex);
+        auto sip = sipRepository->getById(sipId);
+        if (!sip) {
+            throw SIPNotFoundException(sipId);
+        }
+        auto fund = fundRepository->getById(sip->getFundId());
+        if (!fund) {
+            throw FundNotFoundException(sip->getFundId());
+        }
+
+        SIPTransactionTotals totals = transactionRepository->getSuccessfulTotalsBySipId(sipId);
+        ProjectionParameters parameters;
+        parameters.currentValue = totals.totalUnits * marketPriceService->getCurrentNAV(sip->getFundId());
+        parameters.investedSoFar = totals.totalInvested;
+        parameters.baseAmount = sip->getBaseAmount();
+        parameters.stepUpPercentage = sip->getStepUpPercentage();
+        parameters.installmentsPaid = sip->getInstallmentCount();
+        parameters.frequency = sip->getFrequency();
+        parameters.contributing = sip->getState() == SIPState::ACTIVE;
+        parameters.returns = getReturnAssumption(fund->getCategory());
+        parameters.years = years;
+        parameters.paths = paths;
+        RepositoryLock::release(lock);
+        return project(parameters);
+    }
+
+    /**
+     * Run the simulation. A year is stepsPerYear periods of the SIP's
+     * frequency (52 weeks, 12 months or 4 quarters); each period invests the
+     * installment and then applies exp((mu - sigma^2/2) dt + sigma sqrt(dt) Z)
+     * with mu = log(1 + expectedReturn).
+     */
+    ProjectionResult project(const ProjectionParameters& parameters) const {
+        if (parameters.years <= 0 || parameters.years > 100) {
+            throw ValidationException("Projection horizon must be between 1 and 100 years");
+        }
+        if (parameters.paths == 0) {
+            throw ValidationException("Projection needs at least one path");
+        }
+
+        Clock::time_point start = Clock::now();
+        ProjectionResult result;
+        result.paths = parameters.paths;
+        result.stepsPerYear = stepsPerYear(parameters.frequency);
+        result.threadCount = ParallelFor::resolveThreadCount(threadCount);
+
+        const int periodsPerYear = result.stepsPerYear;
+        const int steps = parameters.years * periodsPerYear;
+        std::vector<double> installments(static_cast<size_t>(steps), 0.0);
+        if (parameters.contributing) {
+            for (int step = 0; step < steps; ++step) {
+                installments[static_cast<size_t>(step)] = StepUpEngine::steppedUpAmount(
+                    parameters.baseAmount, parameters.stepUpPercentage,
+                    parameters.installmentsPaid + step + 1);
+            }
+        }
+
+        const double dt = 1.0 / periodsPerYear;
+        const double sigma = parameters.returns.volatility;
+        const double drift = (std::log1p(parameters.returns.expectedReturn) - 0.5 * sigma * sigma) * dt;
+        const double diffusion = sigma * std::sqrt(dt);
+
+        const size_t paths = parameters.paths;
+        const size_t blockPaths = kBlockPaths;
+        std::vector<double> yearEndValues(static_cast<size_t>(parameters.years) * paths);
+        size_t blocks = (paths + blockPaths - 1) / blockPaths;
+        ParallelFor::run(blocks, threadCount,
+            [&](unsigned, size_t begin, size_t end) {
+                simulateBlocks(begin, end, paths, periodsPerYear, parameters.currentValue,
+                               installments, drift, diffusion, yearEndValues);
+            });
+
+        result.bands.resize(static_cast<size_t>(parameters.years));
+        ParallelFor::run(result.bands.size(), threadCount,
+            [&](unsigned, size_t begin, size_t end) {
+                for (size_t year = begin; year < end; ++year) {
+                    double* first = yearEndValues.data() + year * paths;
+                    double* last = first + paths;
+                    ProjectionBand& band = result.bands[year];
+                    band.year = static_cast<int>(year) + 1;
+                    double* p10 = percentile(first, first, last, 0.10);
+                    double* p50 = percentile(first, p10 + 1, last, 0.50);
+                    double* p90 = percentile(first, p50 + 1, last, 0.90);
+                    band.p10 = *p10;
+                    band.p50 = *p50;
+                    band.p90 = *p90;
+                }
+            });
+
+        double invested = parameters.investedSoFar;
+        for (size_t year = 0; year < result.bands.size(); ++year) {
+            for (int period = 0; period < periodsPerYear; ++period) {
+                invested += installments[year * static_cast<size_t>(periodsPerYear) + static_cast<size_t>(period)];
+            }
+            result.bands[year].invested = invested;
+        }
+
+        result.elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return result;
+    }
+};
+
+const size_t MonteCarloProjector::kBlockPaths;
+const uint64_t MonteCarloProjector::kDefaultSeed;
+
+} // namespace sip
+
+#endif // MONTE_CARLO_PROJECTOR_H
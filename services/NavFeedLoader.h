@@ -0,0 +1,197 @@
+#ifndef NAV_FEED_LOADER_H
+#define NAV_FEED_LOADER_H
+
+#include "IMarketPriceService.h"
+#include "../repositories/INavHistoryRepository.h"
+#include "../utils/DateUtils.h"
+#include "../utils/IdInterner.h"
+#include "../utils/NavFeedParser.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Outcome of loading one daily NAV file.
+ */
+struct NavFeedLoadResult {
+    size_t publishedCount;   // NAVs applied to the price service
+    size_t unpricedCount;    // Schemes listed without a NAV
+    size_t malformedCount;   // Scheme lines that could not be parsed
+    size_t unmappedCount;    // Priced schemes skipped for want of a fund mapping
+    double parseSeconds;
+    double publishSeconds;   // History append plus the price swap
+
+    NavFeedLoadResult()
+        : publishedCount(0), unpricedCount(0), malformedCount(0), unmappedCount(0), parseSeconds(0),
+          publishSeconds(0) {}
+};
+
+/**
+ * Loads the daily scheme NAV file (see NavFeedParser) into the price service.
+ *
+ * The whole file is published with one IMarketPriceService::setNAVsByHandle
+ * call, so readers see either yesterday's catalogue or today's, never a mix.
+ * Fund handles are remembered by line position: a file that lists the same
+ * schemes in the same order as the last one is published without interning.
+ * Scheme codes are used as fund ids unless a scheme mapping is set, in which
+ * case only mapped schemes are published, under their fund ids, and the rest
+ * are skipped (so unknown codes never reach the price service or the fund
+ * id interner). With a history repository the NAVs are
+ * also recorded against their own dates (a scheme that did not publish today
+ * keeps its last date) in one batch; history is written first, so a file
+ * the history rejects is neither recorded nor published.
+ */
+class NavFeedLoader {
+private:
+    std::shared_ptr<IMarketPriceService> marketPriceService;
+    std::shared_ptr<INavHistoryRepository> navHistory;  // Optional
+    std::unordered_map<std::string, std::string> fundIdBySchemeCode;  // Empty: codes are fund ids
+    std::vector<std::string> lastFundIds;  // Fund ids published last time, in feed order
+    std::vector<uint32_t> lastHandles;     // lastHandles[i] is the handle of lastFundIds[i]
+
+    typedef std::chrono::steady_clock Clock;
+
+    static double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    /**
+     * Record the feed in history with one appendAll, so a NAV the history
+     * rejects leaves every date of the file unrecorded.
+     */
+    void recordHistory(const NavFeed& feed) {
+        // Files are grouped by date, so each run of equal days is converted once
+        std::vector<Date> dates(feed.size());
+        for (size_t i = 0; i < feed.size(); ++i) {
+            dates[i] = i > 0 && feed.days[i] == feed.days[i - 1] ? dates[i - 1]
+                                                                 : DateUtils::fromDayNumber(feed.days[i]);
+        }
+        navHistory->appendAll(dates, feed.schemeCodes, feed.navs);
+    }
+
+    /**
+     * Fund handle of every fund id, reusing the last load's handle where
+     * the same id is at the same position; the rest are interned in one batch.
+     */
+    std::vector<uint32_t> fundHandles(const std::vector<std::string>& fundIds) {
+        std::vector<uint32_t> handles(fundIds.size());
+        std::vector<size_t> misses;
+        for (size_t i = 0; i < fundIds.size(); ++i) {
+            if (i < lastFundIds.size() && lastFundIds[i] == fundIds[i]) {
+                handles[i] = lastHandles[i];
+            } else {
+                misses.push_back(i);
+            }
+        }
+        if (misses.empty()) {
+            return handles;
+        }
+        if (misses.size() == fundIds.size()) {
+            // A new file layout: intern it whole
+            IdInterner::funds().internAll(fundIds, handles.data());
+            lastFundIds = fundIds;
+            lastHandles = handles;
+            return handles;
+        }
+
+        std::vector<std::string> missedIds(misses.size());
+        std::vector<uint32_t> missedHandles(misses.size());
+        for (size_t m = 0; m < misses.size(); ++m) {
+            missedIds[m] = fundIds[misses[m]];
+        }
+        IdInterner::funds().internAll(missedIds, missedHandles.data());
+        if (lastFundIds.size() < fundIds.size()) {
+            lastFundIds.resize(fundIds.size());
+            lastHandles.resize(fundIds.size());
+        }
+        for (size_t m = 0; m < misses.size(); ++m) {
+            handles[misses[m]] = missedHandles[m];
+            lastFundIds[misses[m]] = std::move(missedIds[m]);
+            lastHandles[misses[m]] = missedHandles[m];
+        }
+        return handles;
+    }
+
+    /**
+     * The mapped schemes of a feed, renamed to their fund ids.
+     */
+    NavFeed mapSchemes(const NavFeed& feed) const {
+        NavFeed mapped;
+        mapped.unpricedCount = feed.unpricedCount;
+        mapped.malformedCount = feed.malformedCount;
+        for (size_t i = 0; i < feed.size(); ++i) {
+            auto it = fundIdBySchemeCode.find(feed.schemeCodes[i]);
+            if (it != fundIdBySchemeCode.end()) {
+                mapped.schemeCodes.push_back(it->second);
+                mapped.navs.push_back(feed.navs[i]);
+                mapped.days.push_back(feed.days[i]);
+            }
+        }
+        return mapped;
+    }
+
+    NavFeedLoadResult publish(const NavFeed& parsed, double parseSeconds) {
+        NavFeed mapped;
+        if (!fundIdBySchemeCode.empty()) {
+            mapped = mapSchemes(parsed);
+        }
+        const NavFeed& feed = fundIdBySchemeCode.empty() ? parsed : mapped;
+
+        NavFeedLoadResult result;
+        result.unmappedCount = parsed.size() - feed.size();
+        result.unpricedCount = feed.unpricedCount;
+        result.malformedCount = feed.malformedCount;
+        result.parseSeconds = parseSeconds;
+
+        auto start = Clock::now();
+        if (navHistory) {
+            recordHistory(feed);
+        }
+        marketPriceService->setNAVsByHandle(fundHandles(feed.schemeCodes), feed.navs);
+        result.publishSeconds = secondsSince(start);
+        result.publishedCount = feed.size();
+        return result;
+    }
+
+public:
+    NavFeedLoader(std::shared_ptr<IMarketPriceService> marketSvc,
+                  std::shared_ptr<INavHistoryRepository> navHistoryRepo = nullptr)
+        : marketPriceService(std::move(marketSvc)), navHistory(std::move(navHistoryRepo)) {}
+
+    /**
+     * Publish only the listed schemes, each under its fund id
+     * (fundIdBySchemeCode[schemeCode]). An empty mapping restores the
+     * default of using scheme codes as fund ids.
+     */
+    void setSchemeMapping(std::unordered_map<std::string, std::string> mapping) {
+        fundIdBySchemeCode = std::move(mapping);
+    }
+
+    /**
+     * Parse and publish a NAV file.
+     * @throws SIPSystemException if the file cannot be read
+     * @throws ValidationException if the history rejects a NAV (nothing is published)
+     */
+    NavFeedLoadResult loadFile(const std::string& path) {
+        auto start = Clock::now();
+        NavFeed feed = NavFeedParser::parseFile(path);
+        return publish(feed, secondsSince(start));
+    }
+
+    /**
+     * Parse and publish NAV file contents already in memory.
+     */
+    NavFeedLoadResult load(const char* data, size_t size) {
+        auto start = Clock::now();
+        NavFeed feed = NavFeedParser::parse(data, size);
+        return publish(feed, secondsSince(start));
+    }
+};
+
+} // namespace sip
+
+#endif // NAV_FEED_LOADER_H
@@ -0,0 +1,188 @@
+#ifndef ORDER_AGGREGATOR_H
+#define ORDER_AGGREGATOR_H
+
+#include "../models/PurchaseOrder.h"
+#include "../utils/ChunkedWriter.h"
+#include "../utils/Exceptions.h"
+#include "../utils/IdGenerator.h"
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Rolls successful installments up into one purchase order per fund per
+ * cut-off, so downstream order volume scales with distinct funds rather
+ * than SIPs.
+ *
+ * Installments collect per fund until closeOrders; each fund's collection
+ * then becomes an open order (written out with writeOrderFile) until the
+ * AMC's allotment comes back, when allocate splits the allotted units
+ * across the order's installments pro rata in one pass over their amounts.
+ *
+ * Thread-safe.
+ */
+class OrderAggregator {
+private:
+    // Installments of one fund, as parallel arrays
+    struct Collection {
+        std::vector<OrderMember> members;
+        std::vector<double> amounts;
+        double total;
+
+        Collection() : total(0.0) {}
+    };
+
+    struct OpenOrder {
+        PurchaseOrder order;
+        Collection installments;
+    };
+
+    mutable std::mutex mutex;
+    std::map<std::string, Collection> pending;  // By fund ID, so orders come out in fund order
+    std::unordered_map<std::string, OpenOrder> openOrders;
+    size_t pendingCount;
+
+public:
+    OrderAggregator() : pendingCount(0) {}
+
+    /**
+     * Add a successful installment to its fund's next order.
+     */
+    void addInstallment(const std::string& fundId, const OrderMember& member, double amount) {
+        if (!(amount > 0.0)) {
+            throw ValidationException("Order installment amount must be positive");
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        Collection& collection = pending[fundId];
+        collection.members.push_back(member);
+        collection.amounts.push_back(amount);
+        collection.total += amount;
+        pendingCount++;
+    }
+
+    // Installments not yet in an order
+    size_t getPendingInstallmentCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return pendingCount;
+    }
+
+    /**
+     * Turn every fund's pending installments into one open order.
+     * @return The new orders, in fund ID order
+     */
+    std::vector<PurchaseOrder> closeOrders(Date cutOff) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<PurchaseOrder> orders;
+        orders.reserve(pending.size());
+        for (auto& entry : pending) {
+            OpenOrder open;
+            open.order = PurchaseOrder{IdGenerator::generateSimple("ORDER"), entry.first, cutOff, entry.second.total,
+                                       entry.second.members.size()};
+            open.installments.members.swap(entry.second.members);
+            open.installments.amounts.swap(entry.second.amounts);
+            open.installments.total = entry.second.total;
+            orders.push_back(open.order);
+            openOrders.emplace(open.order.id, std::move(open));
+        }
+        pending.clear();
+        pendingCount = 0;
+        return orders;
+    }
+
+    /**
+     * Orders closed but not yet allotted.
+     */
+    std::vector<PurchaseOrder> getOpenOrders() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<PurchaseOrder> orders;
+        orders.reserve(openOrders.size());
+        for (const auto& entry : openOrders) {
+            orders.push_back(entry.second.order);
+        }
+        return orders;
+    }
+
+    /**
+     * Split an order's allotted units across its installments in proportion
+     * to their amounts, and close the order.
+     * @param allottedUnits Units the AMC allotted against the whole order
+     */
+    OrderAllocation allocate(const std::string& orderId, double nav, double allottedUnits) {
+        if (!(nav > 0.0) || !(allottedUnits >= 0.0)) {
+            throw ValidationException("Allotment NAV must be positive and units non-negative");
+        }
+        OpenOrder open;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = openOrders.find(orderId);
+            if (it == openOrders.end()) {
+                throw ValidationException("Unknown purchase order: " + orderId);
+            }
+            open = std::move(it->second);
+            openOrders.erase(it);
+        }
+        OrderAllocation allocation;
+        allocation.order = open.order;
+        allocation.nav = nav;
+        allocation.allottedUnits = allottedUnits;
+        // Each installment's share is its amount times the order's units per rupee
+        double unitsPerRupee = allottedUnits / open.order.amount;
+        allocation.units.resize(open.installments.amounts.size());
+        for (size_t i = 0; i < allocation.units.size(); ++i) {
+            allocation.units[i] = open.installments.amounts[i] * unitsPerRupee;
+        }
+        allocation.members.swap(open.installments.members);
+        allocation.amounts.swap(open.installments.amounts);
+        return allocation;
+    }
+
+    /**
+     * Allocate an order allotted at `nav` with no rounding: amount / nav units.
+     */
+    OrderAllocation allocate(const std::string& orderId, double nav) {
+        double amount;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = openOrders.find(orderId);
+            if (it == openOrders.end()) {
+                throw ValidationException("Unknown purchase order: " + orderId);
+            }
+            amount = it->second.order.amount;
+        }
+        if (!(nav > 0.0)) {
+            throw ValidationException("Allotment NAV must be positive");
+        }
+        return allocate(orderId, nav, amount / nav);
+    }
+
+    /**
+     * Write orders as CSV (orderId,fundId,cutOff,amount,installments), one
+     * row per order, through one chunk buffer (ChunkedWriter).
+     * @return Rows written
+     */
+    static size_t writeOrderFile(const std::vector<PurchaseOrder>& orders, std::ostream& out,
+                                 size_t chunkSize = 64 * 1024) {
+        ChunkedWriter chunks(out, chunkSize);
+        chunks.writeRecord([](BufferWriter& writer) {
+            writer.append("orderId,fundId,cutOff,amount,installments\n");
+        });
+        for (const PurchaseOrder& order : orders) {
+            chunks.writeRecord([&order](BufferWriter& writer) {
+                writer.append(order.id).append(',')
+                      .append(order.fundId).append(',')
+                      .appendDate(order.cutOff).append(',')
+                      .appendFixed(order.amount, 2).append(',')
+                      .appendInt(static_cast<long long>(order.installmentCount)).append('\n');
+            });
+        }
+        return orders.size();
+    }
+};
+
+} // namespace sip
+
+#endif // ORDER_AGGREGATOR_H
@@ -6,15 +6,25 @@
 #include "../repositories/ISIPRepository.h"
 #include "../repositories/ITransactionRepository.h"
 #include "../repositories/IMutualFundRepository.h"
+#include "../repositories/IHoldingRepository.h"
 #include "../utils/Exceptions.h"
+#include "../utils/StepUpEngine.h"
+#include "../utils/IdInterner.h"
+#include "../utils/RepositoryLock.h"
+#include "../utils/ValuationKernel.h"
+#include <algorithm>
+#include <iterator>
+#include <map>
 #include <memory>
-#include <cmath>
+#include <mutex>
+#include <unordered_map>
 
 namespace sip {
 
 /**
  * Implementation of IPortfolioService.
- * Provides portfolio view and analytics operations.
+ * Provides portfolio view and analytics operations. With a repository
+ * lock, each operation holds it while it reads the repositories.
  */
 class PortfolioServiceImpl : public IPortfolioService {
 private:
@@ -22,117 +32,188 @@ private:
     std::shared_ptr<ITransactionRepository> transactionRepository;
     std::shared_ptr<IMutualFundRepository> fundRepository;
     std::shared_ptr<IMarketPriceService> marketPriceService;
+    std::shared_ptr<IHoldingRepository> holdingRepository;  // Optional
+    std::shared_ptr<std::mutex> repositoryMutex;            // Optional
 
     /**
-     * Calculate stepped-up amount using compound growth formula.
-     * Formula: baseAmount * (1 + stepUpPercentage/100)^(installmentNumber - 1)
+     * Build SIPPortfolioItems for a list of SIPs.
+     * Each distinct fund is priced once, and the units x NAV valuation runs
+     * column-wise through ValuationKernel.
      */
-    static double calculateSteppedUpAmount(double baseAmount, double stepUpPercentage, int installmentNumber) {
-        if (stepUpPercentage <= 0 || installmentNumber <= 1) {
-            return baseAmount;
-        }
-        double factor = std::pow(1.0 + stepUpPercentage / 100.0, installmentNumber - 1);
-        return baseAmount * factor;
-    }
+    std::vector<SIPPortfolioItem> buildPortfolioItems(const std::vector<SIP>& sips) const {
+        std::vector<SIPPortfolioItem> items(sips.size());
+        std::vector<double> units(sips.size());
+        std::vector<double> invested(sips.size());
+        std::vector<uint32_t> fundIndex(sips.size());
+        std::vector<double> navs;
+        std::unordered_map<std::string, uint32_t> fundSlots;
 
-    /**
-     * Build a SIPPortfolioItem from an SIP and its transactions.
-     */
-    SIPPortfolioItem buildPortfolioItem(const SIP& sip) const {
-        SIPPortfolioItem item;
-        item.sip = sip;
-
-        // Get fund name
-        auto fund = fundRepository->getById(sip.getFundId());
-        if (fund) {
-            item.fundName = fund->getName();
-        } else {
-            item.fundName = "Unknown Fund";
-        }
+        for (size_t i = 0; i < sips.size(); ++i) {
+            const SIP& sip = sips[i];
+            SIPPortfolioItem& item = items[i];
+            item.sip = sip;
 
-        // Get current NAV
-        try {
-            item.currentNav = marketPriceService->getCurrentNAV(sip.getFundId());
-        } catch (const std::exception&) {
-            item.currentNav = 0.0;
-        }
+            // Get fund name
+            auto fund = fundRepository->getById(sip.getFundId());
+            if (fund) {
+                item.fundName = fund->getName();
+            } else {
+                item.fundName = "Unknown Fund";
+            }
 
-        // Calculate totals from successful transactions
-        std::vector<Transaction> transactions = transactionRepository->getSuccessfulBySipId(sip.getId());
-        
-        item.totalInvested = 0.0;
-        item.totalUnits = 0.0;
-        
-        for (const auto& txn : transactions) {
-            item.totalInvested += txn.getAmount();
-            item.totalUnits += txn.getUnits();
-        }
+            // Get current NAV, once per fund
+            auto slot = fundSlots.emplace(sip.getFundId(), static_cast<uint32_t>(navs.size()));
+            if (slot.second) {
+                double nav;
+                try {
+                    nav = marketPriceService->getCurrentNAV(sip.getFundId());
+                } catch (const std::exception&) {
+                    nav = 0.0;
+                }
+                navs.push_back(nav);
+            }
+            fundIndex[i] = slot.first->second;
+            item.currentNav = navs[fundIndex[i]];
+
+            // Totals of successful transactions, maintained by the repository
+            SIPTransactionTotals totals = transactionRepository->getSuccessfulTotalsBySipId(sip.getId());
+            item.totalInvested = totals.totalInvested;
+            item.totalUnits = totals.totalUnits;
+            units[i] = totals.totalUnits;
+            invested[i] = totals.totalInvested;
 
-        // Calculate current value
-        item.currentValue = item.totalUnits * item.currentNav;
+            // Calculate current installment amount (for next payment)
+            int nextInstallment = sip.getInstallmentCount() + 1;
+            item.currentInstallmentAmount = StepUpEngine::steppedUpAmount(
+                sip.getBaseAmount(), sip.getStepUpPercentage(), nextInstallment);
 
-        // Calculate gain/loss
-        item.gainLoss = item.currentValue - item.totalInvested;
-        if (item.totalInvested > 0) {
-            item.gainLossPercentage = (item.gainLoss / item.totalInvested) * 100.0;
-        } else {
-            item.gainLossPercentage = 0.0;
+            // Calculate next installment amount (one after current)
+            item.nextInstallmentAmount = StepUpEngine::steppedUpAmount(
+                sip.getBaseAmount(), sip.getStepUpPercentage(), nextInstallment + 1);
         }
 
-        // Calculate current installment amount (for next payment)
-        int nextInstallment = sip.getInstallmentCount() + 1;
-        item.currentInstallmentAmount = calculateSteppedUpAmount(
-            sip.getBaseAmount(), sip.getStepUpPercentage(), nextInstallment);
+        // Current value, gain/loss and gain/loss percentage for all items at once
+        std::vector<double> currentValue(sips.size());
+        std::vector<double> gainLoss(sips.size());
+        std::vector<double> gainLossPercentage(sips.size());
+        ValuationKernel::Columns columns;
+        columns.count = sips.size();
+        columns.units = units.data();
+        columns.fundIndex = fundIndex.data();
+        columns.navs = navs.data();
+        columns.invested = invested.data();
+        columns.currentValue = currentValue.data();
+        columns.gainLoss = gainLoss.data();
+        columns.gainLossPercentage = gainLossPercentage.data();
+        ValuationKernel::value(columns);
 
-        // Calculate next installment amount (one after current)
-        item.nextInstallmentAmount = calculateSteppedUpAmount(
-            sip.getBaseAmount(), sip.getStepUpPercentage(), nextInstallment + 1);
+        for (size_t i = 0; i < items.size(); ++i) {
+            items[i].currentValue = currentValue[i];
+            items[i].gainLoss = gainLoss[i];
+            items[i].gainLossPercentage = gainLossPercentage[i];
+        }
+        return items;
+    }
+
+    /**
+     * Consolidate a user's SIPs per fund from per-SIP transaction totals.
+     * Used when no holding repository is configured.
+     */
+    std::vector<Holding> consolidateHoldings(const std::string& userId) const {
+        std::map<std::string, Holding> byFund;
+        sipRepository->forEachByUserId(userId, [this, &userId, &byFund](const SIPRecordView& view) {
+            SIPTransactionTotals totals = transactionRepository->getSuccessfulTotalsBySipId(view.cold.id);
+            if (totals.successfulCount == 0) {
+                return;
+            }
+            auto it = byFund.find(view.cold.fundId);
+            if (it == byFund.end()) {
+                it = byFund.emplace(view.cold.fundId, Holding(userId, view.cold.fundId)).first;
+            }
+            Holding& holding = it->second;
+            holding.setUnits(holding.getUnits() + totals.totalUnits);
+            holding.setInvestedAmount(holding.getInvestedAmount() + totals.totalInvested);
+            holding.setPurchaseCount(holding.getPurchaseCount() + totals.successfulCount);
+        });
 
-        return item;
+        std::vector<Holding> holdings;
+        holdings.reserve(byFund.size());
+        for (auto& pair : byFund) {
+            holdings.push_back(std::move(pair.second));
+        }
+        return holdings;
     }
 
 public:
+    /**
+     * Constructor.
+     * @param holdingRepo Consolidated holdings maintained by the scheduler.
+     *                    If null, getUserHoldings aggregates SIP totals instead.
+     * @param repositoryLock If set, held while repositories are read
+     *                       (see SIPScheduler::getRepositoryMutex)
+     */
     PortfolioServiceImpl(std::shared_ptr<ISIPRepository> sipRepo,
                          std::shared_ptr<ITransactionRepository> txnRepo,
                          std::shared_ptr<IMutualFundRepository> fundRepo,
-                         std::shared_ptr<IMarketPriceService> marketSvc)
+                         std::shared_ptr<IMarketPriceService> marketSvc,
+                         std::shared_ptr<IHoldingRepository> holdingRepo = nullptr,
+                         std::shared_ptr<std::mutex> repositoryLock = nullptr)
         : sipRepository(std::move(sipRepo)),
           transactionRepository(std::move(txnRepo)),
           fundRepository(std::move(fundRepo)),
-          marketPriceService(std::move(marketSvc)) {}
+          marketPriceService(std::move(marketSvc)),
+          holdingRepository(std::move(holdingRepo)),
+          repositoryMutex(std::move(repositoryLock)) {}
 
     std::vector<SIPPortfolioItem> getUserPortfolio(const std::string& userId) const override {
-        std::vector<SIPPortfolioItem> portfolio;
-        std::vector<SIP> sips = sipRepository->getByUserId(userId);
-        
-        for (const auto& sip : sips) {
-            portfolio.push_back(buildPortfolioItem(sip));
-        }
-        
-        return portfolio;
+        std::unique_lock<std::mutex> lock = RepositoryLock::acquire(repositoryMutex);
+        return buildPortfolioItems(sipRepository->getByUserId(userId));
     }
 
     PortfolioSummary getPortfolioSummary(const std::string& userId) const override {
-        PortfolioSummary summary;
-        std::vector<SIPPortfolioItem> portfolio = getUserPortfolio(userId);
-        
-        for (const auto& item : portfolio) {
-            summary.totalInvested += item.totalInvested;
-            summary.totalCurrentValue += item.currentValue;
-            summary.totalUnits += item.totalUnits;
-            
-            switch (item.sip.getState()) {
+        // Fused pipeline: stream over the user's SIP records and per-SIP totals,
+        // accumulating in place instead of building SIPPortfolioItems
+        struct Accumulator {
+            const PortfolioServiceImpl* service;
+            PortfolioSummary summary;
+            // Small direct-mapped NAV cache: a user's SIPs usually span few funds
+            uint32_t navFundHandles[16];
+            double navValues[16];
+        } acc;
+        acc.service = this;
+        const uint32_t emptySlot = IdInterner::kInvalidHandle;
+        std::fill(std::begin(acc.navFundHandles), std::end(acc.navFundHandles), emptySlot);
+
+        std::unique_lock<std::mutex> lock = RepositoryLock::acquire(repositoryMutex);
+        sipRepository->forEachByUserId(userId, [&acc](const SIPRecordView& view) {
+            SIPTransactionTotals totals =
+                acc.service->transactionRepository->getSuccessfulTotalsBySipId(view.cold.id);
+
+            size_t slot = view.hot.fundHandle & 15u;
+            if (acc.navFundHandles[slot] != view.hot.fundHandle) {
+                acc.navFundHandles[slot] = view.hot.fundHandle;
+                acc.navValues[slot] = acc.service->marketPriceService->getNAVByHandle(view.hot.fundHandle);
+            }
+
+            acc.summary.totalInvested += totals.totalInvested;
+            acc.summary.totalCurrentValue += totals.totalUnits * acc.navValues[slot];
+            acc.summary.totalUnits += totals.totalUnits;
+
+            switch (view.hot.getState()) {
                 case SIPState::ACTIVE:
-                    summary.activeSIPCount++;
+                    acc.summary.activeSIPCount++;
                     break;
                 case SIPState::PAUSED:
-                    summary.pausedSIPCount++;
+                    acc.summary.pausedSIPCount++;
                     break;
                 case SIPState::STOPPED:
-                    summary.stoppedSIPCount++;
+                    acc.summary.stoppedSIPCount++;
                     break;
             }
-        }
+        });
+        RepositoryLock::release(lock);
+
+        PortfolioSummary& summary = acc.summary;
         
         // Calculate overall gain/loss
         summary.gainLoss = summary.totalCurrentValue - summary.totalInvested;
@@ -143,51 +224,87 @@ public:
         return summary;
     }
 
-    std::vector<SIPPortfolioItem> filterByState(const std::string& userId, SIPState state) const override {
-        std::vector<SIPPortfolioItem> portfolio;
-        std::vector<SIP> sips = sipRepository->getByUserIdAndState(userId, state);
-        
-        for (const auto& sip : sips) {
-            portfolio.push_back(buildPortfolioItem(sip));
+    std::vector<FundHoldingItem> getUserHoldings(const std::string& userId) const override {
+        std::unique_lock<std::mutex> lock = RepositoryLock::acquire(repositoryMutex);
+        std::vector<Holding> holdings = holdingRepository ? holdingRepository->getByUserId(userId)
+                                                          : consolidateHoldings(userId);
+
+        // One NAV per fund: holding i is valued against navs[i]
+        std::vector<FundHoldingItem> items(holdings.size());
+        std::vector<double> units(holdings.size());
+        std::vector<double> invested(holdings.size());
+        std::vector<uint32_t> fundIndex(holdings.size());
+        std::vector<double> navs(holdings.size());
+        for (size_t i = 0; i < holdings.size(); ++i) {
+            FundHoldingItem& item = items[i];
+            item.fundId = holdings[i].getFundId();
+            auto fund = fundRepository->getById(item.fundId);
+            item.fundName = fund ? fund->getName() : "Unknown Fund";
+            try {
+                item.currentNav = marketPriceService->getCurrentNAV(item.fundId);
+            } catch (const std::exception&) {
+                item.currentNav = 0.0;
+            }
+            item.totalUnits = holdings[i].getUnits();
+            item.totalInvested = holdings[i].getInvestedAmount();
+            units[i] = item.totalUnits;
+            invested[i] = item.totalInvested;
+            fundIndex[i] = static_cast<uint32_t>(i);
+            navs[i] = item.currentNav;
         }
-        
-        return portfolio;
+        RepositoryLock::release(lock);
+
+        std::vector<double> currentValue(holdings.size());
+        std::vector<double> gainLoss(holdings.size());
+        std::vector<double> gainLossPercentage(holdings.size());
+        ValuationKernel::Columns columns;
+        columns.count = holdings.size();
+        columns.units = units.data();
+        columns.fundIndex = fundIndex.data();
+        columns.navs = navs.data();
+        columns.invested = invested.data();
+        columns.currentValue = currentValue.data();
+        columns.gainLoss = gainLoss.data();
+        columns.gainLossPercentage = gainLossPercentage.data();
+        ValuationKernel::value(columns);
+
+        for (size_t i = 0; i < items.size(); ++i) {
+            items[i].currentValue = currentValue[i];
+            items[i].gainLoss = gainLoss[i];
+            items[i].gainLossPercentage = gainLossPercentage[i];
+        }
+        return items;
+    }
+
+    std::vector<SIPPortfolioItem> filterByState(const std::string& userId, SIPState state) const override {
+        std::unique_lock<std::mutex> lock = RepositoryLock::acquire(repositoryMutex);
+        return buildPortfolioItems(sipRepository->getByUserIdAndState(userId, state));
     }
 
     std::vector<Transaction> getTransactionHistory(const std::string& sipId) const override {
+        std::unique_lock<std::mutex> lock = RepositoryLock::acquire(repositoryMutex);
         return transactionRepository->getBySipId(sipId);
     }
 
     double calculateTotalInvested(const std::string& sipId) const override {
-        std::vector<Transaction> transactions = transactionRepository->getSuccessfulBySipId(sipId);
-        
-        double total = 0.0;
-        for (const auto& txn : transactions) {
-            total += txn.getAmount();
-        }
-        
-        return total;
+        std::unique_lock<std::mutex> lock = RepositoryLock::acquire(repositoryMutex);
+        return transactionRepository->getSuccessfulTotalsBySipId(sipId).totalInvested;
     }
 
     double calculateTotalUnits(const std::string& sipId) const override {
-        std::vector<Transaction> transactions = transactionRepository->getSuccessfulBySipId(sipId);
-        
-        double total = 0.0;
-        for (const auto& txn : transactions) {
-            total += txn.getUnits();
-        }
-        
-        return total;
+        std::unique_lock<std::mutex> lock = RepositoryLock::acquire(repositoryMutex);
+        return transactionRepository->getSuccessfulTotalsBySipId(sipId).totalUnits;
     }
 
     double calculateCurrentValue(const std::string& sipId) const override {
+        std::unique_lock<std::mutex> lock = RepositoryLock::acquire(repositoryMutex);
         // Get SIP to find fund ID
         auto sip = sipRepository->getById(sipId);
         if (!sip) {
             throw SIPNotFoundException(sipId);
         }
         
-        double totalUnits = calculateTotalUnits(sipId);
+        double totalUnits = transactionRepository->getSuccessfulTotalsBySipId(sipId).totalUnits;
         double currentNav = marketPriceService->getCurrentNAV(sip->getFundId());
         
         return totalUnits * currentNav;
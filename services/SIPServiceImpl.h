@@ -6,10 +6,11 @@
 #include "../repositories/ISIPRepository.h"
 #include "../repositories/IUserRepository.h"
 #include "../utils/Exceptions.h"
+#include "../utils/StepUpEngine.h"
 #include "../utils/DateUtils.h"
 #include "../utils/IdGenerator.h"
+#include "../scheduler/ScheduleGenerator.h"
 #include <memory>
-#include <cmath>
 
 namespace sip {
 
@@ -22,6 +23,8 @@ private:
     std::shared_ptr<ISIPRepository> sipRepository;
     std::shared_ptr<IUserRepository> userRepository;
     std::shared_ptr<IMutualFundService> fundService;
+    std::shared_ptr<ScheduleGenerator> scheduleGenerator;
+    BusinessDayRule businessDayRule;
 
     void validateSIPExists(const std::string& sipId, SIP& outSip) const {
         auto sip = sipRepository->getById(sipId);
@@ -34,10 +37,14 @@ private:
 public:
     SIPServiceImpl(std::shared_ptr<ISIPRepository> sipRepo,
                    std::shared_ptr<IUserRepository> userRepo,
-                   std::shared_ptr<IMutualFundService> fundSvc)
+                   std::shared_ptr<IMutualFundService> fundSvc,
+                   std::shared_ptr<ScheduleGenerator> scheduleGen = std::make_shared<ScheduleGenerator>(),
+                   BusinessDayRule rule = BusinessDayRule::NONE)
         : sipRepository(std::move(sipRepo)),
           userRepository(std::move(userRepo)),
-          fundService(std::move(fundSvc)) {}
+          fundService(std::move(fundSvc)),
+          scheduleGenerator(std::move(scheduleGen)),
+          businessDayRule(rule) {}
 
     SIP createSIP(const std::string& userId, const std::string& fundId,
                   double amount, SIPFrequency frequency, Date startDate,
@@ -146,9 +153,16 @@ public:
 
     double calculateCurrentInstallmentAmount(const std::string& sipId) const override {
         SIP sip = getSIPById(sipId);
-        return calculateSteppedUpAmount(sip.getBaseAmount(), 
-                                        sip.getStepUpPercentage(), 
-                                        sip.getInstallmentCount() + 1);
+        return StepUpEngine::steppedUpAmount(sip.getBaseAmount(), 
+                                             sip.getStepUpPercentage(), 
+                                             sip.getInstallmentCount() + 1);
+    }
+
+    double forecastInvestment(const std::string& sipId, int futureInstallments) const override {
+        SIP sip = getSIPById(sipId);
+        int nextInstallment = sip.getInstallmentCount() + 1;
+        return StepUpEngine::cumulativeAmountBetween(sip.getBaseAmount(), sip.getStepUpPercentage(),
+                                                     nextInstallment, nextInstallment + futureInstallments - 1);
     }
 
     void onPaymentSuccess(const std::string& sipId) override {
@@ -162,38 +176,26 @@ public:
         SIP sip;
         validateSIPExists(sipId, sip);
         
-        Date nextDate = calculateNextExecutionDate(sip.getNextExecutionDate(), sip.getFrequency());
+        Date nextDate = scheduleGenerator->nextExecutionDate(
+            sip.getStartDate(), sip.getNextExecutionDate(), sip.getFrequency(), businessDayRule);
         sip.setNextExecutionDate(nextDate);
         sipRepository->update(sip);
     }
 
-private:
-    /**
-     * Calculate stepped-up amount using compound growth formula.
-     * Formula: baseAmount * (1 + stepUpPercentage/100)^(installmentNumber - 1)
-     */
-    static double calculateSteppedUpAmount(double baseAmount, double stepUpPercentage, int installmentNumber) {
-        if (stepUpPercentage <= 0 || installmentNumber <= 1) {
-            return baseAmount;
-        }
-        double factor = std::pow(1.0 + stepUpPercentage / 100.0, installmentNumber - 1);
-        return baseAmount * factor;
-    }
-
-    /**
-     * Calculate the next execution date based on frequency.
-     */
-    static Date calculateNextExecutionDate(Date currentDate, SIPFrequency frequency) {
-        switch (frequency) {
-            case SIPFrequency::WEEKLY:
-                return DateUtils::addWeeks(currentDate, 1);
-            case SIPFrequency::MONTHLY:
-                return DateUtils::addMonths(currentDate, 1);
-            case SIPFrequency::QUARTERLY:
-                return DateUtils::addQuarters(currentDate, 1);
-            default:
-                return DateUtils::addMonths(currentDate, 1);
+    std::vector<Date> getUpcomingExecutionDates(const std::string& sipId, int count) const override {
+        SIP sip = getSIPById(sipId);
+        if (count <= 0) {
+            return std::vector<Date>();
         }
+        // The pending installment itself comes first, followed by the table entries after it
+        std::vector<Date> dates;
+        dates.reserve(static_cast<size_t>(count));
+        dates.push_back(sip.getNextExecutionDate());
+        std::vector<Date> later = scheduleGenerator->upcomingExecutionDates(
+            sip.getStartDate(), sip.getNextExecutionDate(), sip.getFrequency(),
+            businessDayRule, static_cast<size_t>(count - 1));
+        dates.insert(dates.end(), later.begin(), later.end());
+        return dates;
     }
 };
 
@@ -0,0 +1,177 @@
+#ifndef SCENARIO_ENGINE_H
+#define SCENARIO_ENGINE_H
+
+#include "BatchValuationEngine.h"
+#include "ScenarioTransform.h"
+#include "../models/MarketScenario.h"
+#include "../repositories/IMutualFundRepository.h"
+#include "../utils/RepositoryLock.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sip {
+
+/**
+ * One scenario's outcome in a stress test; summaries[i] belongs to
+ * StressTestResult::userIds[i].
+ */
+struct ScenarioResult {
+    std::string name;
+    std::vector<PortfolioSummary> summaries;
+    double totalBaseValue;
+    double totalScenarioValue;
+    double elapsedSeconds;
+
+    ScenarioResult() : totalBaseValue(0), totalScenarioValue(0), elapsedSeconds(0) {}
+};
+
+/**
+ * All users valued at current NAVs (baseSummaries) and under each scenario.
+ */
+struct StressTestResult {
+    std::vector<std::string> userIds;
+    std::vector<PortfolioSummary> baseSummaries;
+    std::vector<ScenarioResult> scenarios;
+    double gatherSeconds;
+
+    StressTestResult() : gatherSeconds(0) {}
+};
+
+/**
+ * What-if valuation under hypothetical market moves.
+ *
+ * Scenarios are applied as an overlay: a shocked copy of a NavSnapshot that
+ * only the caller sees. Live prices (IMarketPriceService) and repositories
+ * are only read, never written, so any number of scenarios can be evaluated
+ * concurrently, including while real prices are being updated. With a
+ * repository lock, repository reads hold it.
+ */
+class ScenarioEngine {
+private:
+    std::shared_ptr<ISIPRepository> sipRepository;
+    std::shared_ptr<ITransactionRepository> transactionRepository;
+    std::shared_ptr<IMutualFundRepository> fundRepository;
+    std::shared_ptr<IMarketPriceService> marketPriceService;
+    std::shared_ptr<std::mutex> repositoryMutex;  // Optional
+    BatchValuationEngine batchEngine;
+
+    typedef std::chrono::steady_clock Clock;
+
+    static double totalValue(const std::vector<PortfolioSummary>& summaries) {
+        double total = 0.0;
+        for (const auto& summary : summaries) {
+            total += summary.totalCurrentValue;
+        }
+        return total;
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param threadCount Worker threads per valuation (0 = one per core)
+     * @param repositoryLock If set, held while repositories are read
+     *                       (see SIPScheduler::getRepositoryMutex)
+     */
+    ScenarioEngine(std::shared_ptr<ISIPRepository> sipRepo,
+                   std::shared_ptr<ITransactionRepository> txnRepo,
+                   std::shared_ptr<IMutualFundRepository> fundRepo,
+                   std::shared_ptr<IMarketPriceService> marketSvc,
+                   unsigned threadCount = 0,
+                   std::shared_ptr<std::mutex> repositoryLock = nullptr)
+        : sipRepository(sipRepo),
+          transactionRepository(txnRepo),
+          fundRepository(std::move(fundRepo)),
+          marketPriceService(marketSvc),
+          repositoryMutex(repositoryLock),
+          batchEngine(std::move(sipRepo), std::move(txnRepo), std::move(marketSvc), threadCount, nullptr,
+                      std::move(repositoryLock)) {}
+
+    /**
+     * Category of every fund in the repository, by handle. Build it once per
+     * catalog and pass it to applyScenario and evaluateUser; funds missing
+     * from it only receive fund-level or market-wide shocks.
+     */
+    std::vector<uint8_t> fundCategories() const {
+        std::unique_lock<std::mutex> lock = RepositoryLock::acquire(repositoryMutex);
+        return ScenarioTransform::categoriesByHandle(fundRepository->getAll());
+    }
+
+    /**
+     * Shocked copy of a snapshot.
+     * @param categories See fundCategories
+     */
+    static NavSnapshot applyScenario(const NavSnapshot& base, const MarketScenario& scenario,
+                                     const std::vector<uint8_t>& categories) {
+        NavSnapshot shocked = base;
+        ScenarioTransform::applyTo(scenario, shocked, categories);
+        return shocked;
+    }
+
+    /**
+     * One user's portfolio summary under a scenario.
+     * @param categories See fundCategories
+     */
+    PortfolioSummary evaluateUser(const std::string& userId, const MarketScenario& scenario,
+                                  const std::vector<uint8_t>& categories) const {
+        HoldingColumns holdings;
+        holdings.userIds.push_back(userId);
+        holdings.userOffsets.push_back(0);
+        std::unique_lock<std::mutex> lock = RepositoryLock::acquire(repositoryMutex);
+        sipRepository->forEachByUserId(userId, [this, &holdings](const SIPRecordView& view) {
+            SIPTransactionTotals totals = transactionRepository->getSuccessfulTotalsBySipId(view.cold.id);
+            holdings.fundHandles.push_back(view.hot.fundHandle);
+            holdings.units.push_back(totals.totalUnits);
+            holdings.invested.push_back(totals.totalInvested);
+            holdings.states.push_back(view.hot.state);
+            holdings.fundHandleLimit = std::max(holdings.fundHandleLimit,
+                                                static_cast<size_t>(view.hot.fundHandle) + 1);
+        });
+        RepositoryLock::release(lock);
+        holdings.userOffsets.push_back(static_cast<uint32_t>(holdings.holdingCount()));
+
+        NavSnapshot shocked = applyScenario(batchEngine.captureNavSnapshot(holdings), scenario, categories);
+        std::vector<PortfolioSummary> summaries(1);
+        batchEngine.valueHoldings(holdings, shocked, summaries);
+        return summaries[0];
+    }
+
+    /**
+     * Value every user at current NAVs and under each scenario. Holdings are
+     * gathered and priced once; each scenario is one overlay and one
+     * parallel valuation pass.
+     */
+    StressTestResult runStressTest(const std::vector<MarketScenario>& scenarios) const {
+        StressTestResult result;
+        Clock::time_point start = Clock::now();
+        HoldingColumns holdings = batchEngine.gatherHoldings();
+        NavSnapshot base = batchEngine.captureNavSnapshot(holdings);
+        result.baseSummaries.resize(holdings.userCount());
+        batchEngine.valueHoldings(holdings, base, result.baseSummaries);
+        result.gatherSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        double baseValue = totalValue(result.baseSummaries);
+
+        // One catalog read for all scenarios
+        std::vector<uint8_t> categories = fundCategories();
+        result.scenarios.reserve(scenarios.size());
+        for (const auto& scenario : scenarios) {
+            start = Clock::now();
+            ScenarioResult outcome;
+            outcome.name = scenario.getName();
+            outcome.summaries.resize(holdings.userCount());
+            batchEngine.valueHoldings(holdings, applyScenario(base, scenario, categories), outcome.summaries);
+            outcome.totalBaseValue = baseValue;
+            outcome.totalScenarioValue = totalValue(outcome.summaries);
+            outcome.elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+            result.scenarios.push_back(std::move(outcome));
+        }
+        result.userIds = std::move(holdings.userIds);
+        return result;
+    }
+};
+
+} // namespace sip
+
+#endif // SCENARIO_ENGINE_H
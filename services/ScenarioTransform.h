@@ -0,0 +1,138 @@
+#ifndef SCENARIO_TRANSFORM_H
+#define SCENARIO_TRANSFORM_H
+
+#include "../models/MarketScenario.h"
+#include "../models/MutualFund.h"
+#include "../models/NavSnapshot.h"
+#include "../utils/Exceptions.h"
+#include "../utils/IdInterner.h"
+#include "../utils/NavKernel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Applies MarketScenarios to NAV snapshots.
+ *
+ * applyTo shocks a whole NavSnapshot in one vectorized pass, given each
+ * fund handle's category (see categoriesByHandle). Build the categories
+ * once and reuse them for every scenario valued against the same catalog.
+ */
+class ScenarioTransform {
+public:
+    // Category code for handles that are not a known fund; they get the market shock
+    enum : uint8_t { kUncategorized = static_cast<uint8_t>(kFundCategoryCount) };
+
+    /**
+     * Shock every priced NAV in a snapshot. categories[handle] is the fund's
+     * category code (kUncategorized, or handles past the end, for the market shock).
+     * @throws ValidationException if a shock is -100% or worse (nothing is changed)
+     */
+    static void applyTo(const MarketScenario& scenario, NavSnapshot& snapshot,
+                        const std::vector<uint8_t>& categories) {
+        double factors[kFundCategoryCount + 1];
+        for (size_t c = 0; c < kFundCategoryCount; ++c) {
+            factors[c] = checkedFactor(scenario.shockForCategory(static_cast<FundCategory>(c)));
+        }
+        factors[kUncategorized] = checkedFactor(scenario.getMarketShock());
+
+        // Fund shocks replace the category's, so compute them from the unshocked NAV
+        std::vector<std::pair<uint32_t, double>> fundNavs;
+        IdInterner& funds = IdInterner::funds();
+        for (const auto& pair : scenario.getFundShocks()) {
+            double factor = checkedFactor(pair.second);
+            uint32_t handle = funds.find(pair.first);
+            if (handle < snapshot.navs.size()) {
+                fundNavs.emplace_back(handle, snapshot.navs[handle] * factor);
+            }
+        }
+
+        size_t grouped = std::min(categories.size(), snapshot.navs.size());
+        NavKernel::scaleByGroup(snapshot.navs.data(), categories.data(), grouped, factors);
+        NavKernel::scale(snapshot.navs.data() + grouped, snapshot.navs.size() - grouped, factors[kUncategorized]);
+        for (const auto& fundNav : fundNavs) {
+            snapshot.navs[fundNav.first] = fundNav.second;
+        }
+    }
+
+    /**
+     * One scenario equivalent to applying days in order (e.g. a year of
+     * daily moves): every shock is the compounded product of the daily ones,
+     * so a replay costs one applyTo. Equal to the day-by-day result up to
+     * rounding. categories is as for applyTo.
+     */
+    static MarketScenario compound(const std::string& name, const std::vector<MarketScenario>& days,
+                                   const std::vector<uint8_t>& categories) {
+        double market = 1.0;
+        double category[kFundCategoryCount];
+        std::fill(category, category + kFundCategoryCount, 1.0);
+        std::unordered_map<std::string, double> fundFactors;
+        for (const MarketScenario& day : days) {
+            market *= 1.0 + day.getMarketShock();
+            for (size_t c = 0; c < kFundCategoryCount; ++c) {
+                category[c] *= 1.0 + day.shockForCategory(static_cast<FundCategory>(c));
+            }
+            for (const auto& pair : day.getFundShocks()) {
+                fundFactors.emplace(pair.first, 1.0);
+            }
+        }
+
+        // A fund shocked on any day follows its own path on every day
+        IdInterner& funds = IdInterner::funds();
+        for (auto& pair : fundFactors) {
+            uint32_t handle = funds.find(pair.first);
+            uint8_t code = handle < categories.size() ? categories[handle] : static_cast<uint8_t>(kUncategorized);
+            for (const MarketScenario& day : days) {
+                auto it = day.getFundShocks().find(pair.first);
+                double shock = it != day.getFundShocks().end() ? it->second
+                             : code < kFundCategoryCount ? day.shockForCategory(static_cast<FundCategory>(code))
+                             : day.getMarketShock();
+                pair.second *= 1.0 + shock;
+            }
+        }
+
+        MarketScenario result(name);
+        result.shockMarket(market - 1.0);
+        for (size_t c = 0; c < kFundCategoryCount; ++c) {
+            result.shockCategory(static_cast<FundCategory>(c), category[c] - 1.0);
+        }
+        for (const auto& pair : fundFactors) {
+            result.shockFund(pair.first, pair.second - 1.0);
+        }
+        return result;
+    }
+
+    /**
+     * Category code of every fund handle, for applyTo. Handles of unknown funds are kUncategorized.
+     */
+    static std::vector<uint8_t> categoriesByHandle(const std::vector<MutualFund>& funds) {
+        std::vector<uint8_t> categories;
+        IdInterner& interner = IdInterner::funds();
+        for (const MutualFund& fund : funds) {
+            uint32_t handle = interner.intern(fund.getId());
+            if (handle >= categories.size()) {
+                categories.resize(static_cast<size_t>(handle) + 1, static_cast<uint8_t>(kUncategorized));
+            }
+            categories[handle] = static_cast<uint8_t>(fund.getCategory());
+        }
+        return categories;
+    }
+
+private:
+    static double checkedFactor(double shock) {
+        double factor = 1.0 + shock;
+        if (!(factor > 0) || !std::isfinite(factor)) {
+            throw ValidationException("Market shock must be greater than -100%");
+        }
+        return factor;
+    }
+};
+
+} // namespace sip
+
+#endif // SCENARIO_TRANSFORM_H
@@ -0,0 +1,351 @@
+#ifndef XIRR_ENGINE_H
+#define XIRR_ENGINE_H
+
+#include "IMarketPriceService.h"
+#include "../repositories/ISIPRepository.h"
+#include "../repositories/ITransactionRepository.h"
+#include "../utils/Exceptions.h"
+#include "../utils/ParallelFor.h"
+#include "../utils/RepositoryLock.h"
+#include "../utils/XirrSolver.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sip {
+
+/**
+ * XIRR of every user's portfolio, as produced by XirrEngine::computeAllPortfolios.
+ * results[i] belongs to userIds[i].
+ */
+struct BulkXirrResult {
+    std::vector<std::string> userIds;
+    std::vector<XirrResult> results;
+    size_t solvedCount;   // Portfolios that missed the cache and were solved
+    double elapsedSeconds;
+
+    BulkXirrResult() : solvedCount(0), elapsedSeconds(0) {}
+};
+
+/**
+ * Annualised returns (XIRR) for SIPs and portfolios.
+ *
+ * Cash flows are each successful installment (an outflow on its transaction
+ * date) plus the current value as an inflow on the valuation date. An SIP's
+ * cash flows are loaded once and reused until its successful transaction
+ * count or invested total changes; a result is reused until, in addition,
+ * the current value (units x NAV) or valuation date changes. Re-solves start from the previous rate,
+ * so Newton usually converges in a couple of iterations.
+ */
+class XirrEngine {
+private:
+    struct SIPCashFlows {
+        int successfulCount;
+        double totalInvested;
+        std::vector<double> days;     // Transaction dates, days since epoch
+        std::vector<double> amounts;  // Negative: money invested
+    };
+
+    struct SIPEntry {
+        std::shared_ptr<const SIPCashFlows> flows;
+        double currentValue;
+        double asOfDay;
+        XirrResult result;
+
+        SIPEntry() : currentValue(0.0), asOfDay(-1.0) {}
+    };
+
+    struct PortfolioEntry {
+        int successfulCount;
+        double totalInvested;
+        double currentValue;
+        double asOfDay;
+        XirrResult result;
+
+        PortfolioEntry() : successfulCount(0), totalInvested(0.0), currentValue(0.0), asOfDay(-1.0) {}
+    };
+
+    std::shared_ptr<ISIPRepository> sipRepository;
+    std::shared_ptr<ITransactionRepository> transactionRepository;
+    std::shared_ptr<IMarketPriceService> marketPriceService;
+    std::shared_ptr<std::mutex> repositoryMutex;  // Optional, taken before cacheMutex
+    unsigned threadCount;
+
+    mutable std::mutex cacheMutex;
+    mutable std::unordered_map<std::string, SIPEntry> sipCache;
+    mutable std::unordered_map<std::string, PortfolioEntry> portfolioCache;
+
+    static double toDays(Date date) {
+        return std::chrono::duration<double>(date.time_since_epoch()).count() / 86400.0;
+    }
+
+    double navOf(const std::string& fundId) const {
+        try {
+            return marketPriceService->getCurrentNAV(fundId);
+        } catch (const std::exception&) {
+            return 0.0;
+        }
+    }
+
+    /**
+     * Cash flows of an SIP, from the cache if its totals have not moved.
+     * Caller must hold cacheMutex (and the repository lock, if any).
+     */
+    std::shared_ptr<const SIPCashFlows> cashFlowsLocked(const std::string& sipId,
+                                                        const SIPTransactionTotals& totals) const {
+        auto it = sipCache.find(sipId);
+        if (it != sipCache.end() && it->second.flows &&
+            it->second.flows->successfulCount == totals.successfulCount &&
+            it->second.flows->totalInvested == totals.totalInvested) {
+            return it->second.flows;
+        }
+
+        auto flows = std::make_shared<SIPCashFlows>();
+        flows->successfulCount = totals.successfulCount;
+        flows->totalInvested = totals.totalInvested;
+        std::vector<Transaction> transactions = transactionRepository->getSuccessfulBySipId(sipId);
+        flows->days.reserve(transactions.size());
+        flows->amounts.reserve(transactions.size());
+        for (const auto& txn : transactions) {
+            flows->days.push_back(toDays(txn.getDate()));
+            flows->amounts.push_back(-txn.getAmount());
+        }
+
+        SIPEntry& entry = sipCache[sipId];
+        entry.flows = flows;
+        entry.asOfDay = -1.0;  // Force a re-solve
+        return flows;
+    }
+
+    /**
+     * Append cash flows to the solver input, with times in years relative to asOfDay.
+     */
+    static void appendFlows(const SIPCashFlows& flows, double asOfDay,
+                            std::vector<double>& years, std::vector<double>& amounts) {
+        for (size_t i = 0; i < flows.days.size(); ++i) {
+            years.push_back((flows.days[i] - asOfDay) / 365.0);
+            amounts.push_back(flows.amounts[i]);
+        }
+    }
+
+    static XirrResult solveFlows(std::vector<double>& years, std::vector<double>& amounts,
+                                 double currentValue, double guess) {
+        years.push_back(0.0);
+        amounts.push_back(currentValue);
+        return XirrSolver::solve(years.data(), amounts.data(), years.size(), guess);
+    }
+
+    static double warmStart(const XirrResult& previous) {
+        return previous.converged ? previous.rate : 0.1;
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param threadCount Worker threads for computeAllPortfolios (0 = one per core)
+     * @param repositoryLock If set, held while repositories are read
+     *                       (see SIPScheduler::getRepositoryMutex)
+     */
+    XirrEngine(std::shared_ptr<ISIPRepository> sipRepo,
+               std::shared_ptr<ITransactionRepository> txnRepo,
+               std::shared_ptr<IMarketPriceService> marketSvc,
+               unsigned threadCount = 0,
+               std::shared_ptr<std::mutex> repositoryLock = nullptr)
+        : sipRepository(std::move(sipRepo)),
+          transactionRepository(std::move(txnRepo)),
+          marketPriceService(std::move(marketSvc)),
+          repositoryMutex(std::move(repositoryLock)),
+          threadCount(threadCount) {}
+
+    /**
+     * XIRR of one SIP, valued at the current NAV on asOfDate.
+     * @throws SIPNotFoundException if the SIP doesn't exist
+     */
+    XirrResult getSIPXirr(const std::string& sipId, Date asOfDate) const {
+        std::unique_lock<std::mutex> repositoryLock = RepositoryLock::acquire(repositoryMutex);
+        auto sip = sipRepository->getById(sipId);
+        if (!sip) {
+            throw SIPNotFoundException(sipId);
+        }
+        SIPTransactionTotals totals = transactionRepository->getSuccessfulTotalsBySipId(sipId);
+        // Units can change without new installments (splits, allotments), so value from the fresh totals
+        double currentValue = totals.totalUnits * navOf(sip->getFundId());
+        double asOfDay = toDays(asOfDate);
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        std::shared_ptr<const SIPCashFlows> flows = cashFlowsLocked(sipId, totals);
+        SIPEntry& entry = sipCache[sipId];
+        if (entry.currentValue == currentValue && entry.asOfDay == asOfDay) {
+            return entry.result;
+        }
+
+        std::vector<double> years, amounts;
+        appendFlows(*flows, asOfDay, years, amounts);
+        entry.result = solveFlows(years, amounts, currentValue, warmStart(entry.result));
+        entry.currentValue = currentValue;
+        entry.asOfDay = asOfDay;
+        return entry.result;
+    }
+
+    /**
+     * XIRR of all of a user's SIPs taken together, valued at current NAVs on asOfDate.
+     */
+    XirrResult getPortfolioXirr(const std::string& userId, Date asOfDate) const {
+        struct Holding {
+            std::string sipId;
+            std::string fundId;
+        };
+        std::vector<Holding> holdings;
+        std::unique_lock<std::mutex> repositoryLock = RepositoryLock::acquire(repositoryMutex);
+        sipRepository->forEachByUserId(userId, [&holdings](const SIPRecordView& view) {
+            holdings.push_back(Holding{view.cold.id, view.cold.fundId});
+        });
+
+        double asOfDay = toDays(asOfDate);
+        std::vector<SIPTransactionTotals> totals;
+        std::vector<double> navs;
+        totals.reserve(holdings.size());
+        navs.reserve(holdings.size());
+        int successfulCount = 0;
+        double totalInvested = 0.0, currentValue = 0.0;
+        for (const auto& holding : holdings) {
+            totals.push_back(transactionRepository->getSuccessfulTotalsBySipId(holding.sipId));
+            navs.push_back(navOf(holding.fundId));
+            successfulCount += totals.back().successfulCount;
+            totalInvested += totals.back().totalInvested;
+            currentValue += totals.back().totalUnits * navs.back();
+        }
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto cached = portfolioCache.find(userId);
+        if (cached != portfolioCache.end() && cached->second.successfulCount == successfulCount &&
+            cached->second.totalInvested == totalInvested &&
+            cached->second.currentValue == currentValue && cached->second.asOfDay == asOfDay) {
+            return cached->second.result;
+        }
+
+        std::vector<double> years, amounts;
+        for (size_t i = 0; i < holdings.size(); ++i) {
+            appendFlows(*cashFlowsLocked(holdings[i].sipId, totals[i]), asOfDay, years, amounts);
+        }
+        XirrResult previous = cached != portfolioCache.end() ? cached->second.result : XirrResult();
+        PortfolioEntry& entry = portfolioCache[userId];
+        entry.successfulCount = successfulCount;
+        entry.totalInvested = totalInvested;
+        entry.currentValue = currentValue;
+        entry.asOfDay = asOfDay;
+        entry.result = solveFlows(years, amounts, currentValue, warmStart(previous));
+        return entry.result;
+    }
+
+    /**
+     * XIRR of every user's portfolio.
+     * Repositories and prices are read on the calling thread (each fund is
+     * priced once); portfolios whose inputs changed are then solved in parallel.
+     */
+    BulkXirrResult computeAllPortfolios(Date asOfDate) const {
+        typedef std::chrono::steady_clock Clock;
+        Clock::time_point start = Clock::now();
+        double asOfDay = toDays(asOfDate);
+
+        struct UserInput {
+            std::vector<std::shared_ptr<const SIPCashFlows>> flows;
+            int successfulCount;
+            double totalInvested;
+            double currentValue;
+            double guess;
+            bool needsSolve;
+        };
+        BulkXirrResult bulk;
+        std::vector<UserInput> inputs;
+        std::unordered_map<std::string, size_t> userSlots;
+        std::unordered_map<uint32_t, double> navByFund;
+
+        std::unique_lock<std::mutex> repositoryLock = RepositoryLock::acquire(repositoryMutex);
+        std::unique_lock<std::mutex> lock(cacheMutex);
+        sipRepository->forEachSIP([&](const SIPRecordView& view) {
+            auto slot = userSlots.emplace(view.cold.userId, inputs.size());
+            if (slot.second) {
+                bulk.userIds.push_back(view.cold.userId);
+                inputs.push_back(UserInput{{}, 0, 0.0, 0.0, 0.1, true});
+            }
+            auto nav = navByFund.find(view.hot.fundHandle);
+            if (nav == navByFund.end()) {
+                nav = navByFund.emplace(view.hot.fundHandle, navOf(view.cold.fundId)).first;
+            }
+            SIPTransactionTotals totals = transactionRepository->getSuccessfulTotalsBySipId(view.cold.id);
+            UserInput& input = inputs[slot.first->second];
+            input.flows.push_back(cashFlowsLocked(view.cold.id, totals));
+            input.successfulCount += totals.successfulCount;
+            input.totalInvested += totals.totalInvested;
+            input.currentValue += totals.totalUnits * nav->second;
+        });
+        RepositoryLock::release(repositoryLock);
+
+        bulk.results.resize(inputs.size());
+        for (size_t u = 0; u < inputs.size(); ++u) {
+            UserInput& input = inputs[u];
+            auto cached = portfolioCache.find(bulk.userIds[u]);
+            if (cached == portfolioCache.end()) {
+                continue;
+            }
+            const PortfolioEntry& entry = cached->second;
+            input.guess = warmStart(entry.result);
+            if (entry.successfulCount == input.successfulCount && entry.totalInvested == input.totalInvested &&
+                entry.currentValue == input.currentValue && entry.asOfDay == asOfDay) {
+                bulk.results[u] = entry.result;
+                input.needsSolve = false;
+            }
+        }
+        lock.unlock();
+
+        ParallelFor::run(inputs.size(), threadCount,
+            [&inputs, &bulk, asOfDay](unsigned, size_t begin, size_t end) {
+                std::vector<double> years, amounts;
+                for (size_t u = begin; u < end; ++u) {
+                    const UserInput& input = inputs[u];
+                    if (!input.needsSolve) {
+                        continue;
+                    }
+                    years.clear();
+                    amounts.clear();
+                    for (const auto& flows : input.flows) {
+                        appendFlows(*flows, asOfDay, years, amounts);
+                    }
+                    bulk.results[u] = solveFlows(years, amounts, input.currentValue, input.guess);
+                }
+            });
+
+        lock.lock();
+        for (size_t u = 0; u < inputs.size(); ++u) {
+            if (!inputs[u].needsSolve) {
+                continue;
+            }
+            PortfolioEntry& entry = portfolioCache[bulk.userIds[u]];
+            entry.successfulCount = inputs[u].successfulCount;
+            entry.totalInvested = inputs[u].totalInvested;
+            entry.currentValue = inputs[u].currentValue;
+            entry.asOfDay = asOfDay;
+            entry.result = bulk.results[u];
+            bulk.solvedCount++;
+        }
+        bulk.elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return bulk;
+    }
+
+    /**
+     * Drop all cached cash flows and results.
+     */
+    void clearCache() {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        sipCache.clear();
+        portfolioCache.clear();
+    }
+};
+
+} // namespace sip
+
+#endif // XIRR_ENGINE_H
@@ -0,0 +1,179 @@
+#ifndef BUFFER_WRITER_H
+#define BUFFER_WRITER_H
+
+#include "DateUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace sip {
+
+/**
+ * Allocation-free text formatter over a caller-supplied buffer.
+ *
+ * Appends never allocate and never overflow: output that does not fit is
+ * dropped, but requiredSize() keeps counting so callers can retry with a buffer
+ * of the right size (the same contract as snprintf). The buffer is kept
+ * NUL-terminated whenever capacity > 0.
+ */
+class BufferWriter {
+private:
+    char* buffer;
+    size_t capacity;
+    size_t length;    // Bytes actually written (excluding NUL)
+    size_t required;  // Bytes the full output needs (excluding NUL)
+
+public:
+    BufferWriter(char* buffer, size_t capacity)
+        : buffer(buffer), capacity(capacity), length(0), required(0) {
+        if (capacity > 0) {
+            buffer[0] = '\0';
+        }
+    }
+
+    const char* data() const { return buffer; }
+    size_t size() const { return length; }
+    size_t requiredSize() const { return required; }
+    bool truncated() const { return required > length; }
+
+    /**
+     * Discard written content and start again at the beginning of the buffer.
+     */
+    void clear() {
+        length = 0;
+        required = 0;
+        if (capacity > 0) {
+            buffer[0] = '\0';
+        }
+    }
+
+    /**
+     * Drop everything after the first `size` bytes written (e.g. a row that
+     * did not fit), as if it had never been appended.
+     */
+    void rewind(size_t size) {
+        if (size < length) {
+            length = size;
+        }
+        required = length;
+        if (capacity > 0) {
+            buffer[length] = '\0';
+        }
+    }
+
+    BufferWriter& append(const char* text, size_t count) {
+        required += count;
+        if (capacity == 0) {
+            return *this;
+        }
+        size_t room = capacity - 1 - length;
+        size_t n = count < room ? count : room;
+        std::memcpy(buffer + length, text, n);
+        length += n;
+        buffer[length] = '\0';
+        return *this;
+    }
+
+    BufferWriter& append(const char* text) {
+        return append(text, std::strlen(text));
+    }
+
+    BufferWriter& append(const std::string& text) {
+        return append(text.data(), text.size());
+    }
+
+    BufferWriter& append(char c) {
+        return append(&c, 1);
+    }
+
+    BufferWriter& appendInt(long long value) {
+        char digits[24];
+        char* end = digits + sizeof(digits);
+        char* p = end;
+        unsigned long long magnitude = value < 0 ? 0ULL - static_cast<unsigned long long>(value)
+                                                 : static_cast<unsigned long long>(value);
+        do {
+            *--p = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (value < 0) {
+            *--p = '-';
+        }
+        return append(p, static_cast<size_t>(end - p));
+    }
+
+    /**
+     * Append a double in fixed notation (std::to_string uses precision 6).
+     */
+    BufferWriter& appendFixed(double value, int precision = 6) {
+        static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+        double magnitude = std::fabs(value);
+        if (!std::isfinite(value) || magnitude >= 1e15 || precision < 0 || precision > 9) {
+            // Rare cases go through snprintf, which is still allocation-free.
+            // DBL_MAX has 309 integer digits; precision is capped so the text always fits.
+            char fallback[352];
+            int n = std::snprintf(fallback, sizeof(fallback), "%.*f", precision < 0 ? 0 : std::min(precision, 17),
+                                  value);
+            return append(fallback, n > 0 ? std::min(static_cast<size_t>(n), sizeof(fallback) - 1) : 0);
+        }
+
+        double scale = powers[precision];
+        uint64_t whole = static_cast<uint64_t>(magnitude);
+        uint64_t fraction = static_cast<uint64_t>(std::llround((magnitude - static_cast<double>(whole)) * scale));
+        if (fraction >= static_cast<uint64_t>(scale)) {
+            ++whole;
+            fraction -= static_cast<uint64_t>(scale);
+        }
+
+        if (std::signbit(value)) {
+            append('-');
+        }
+        appendInt(static_cast<long long>(whole));
+        if (precision > 0) {
+            char digits[10];
+            for (int i = precision - 1; i >= 0; --i) {
+                digits[i] = static_cast<char>('0' + fraction % 10);
+                fraction /= 10;
+            }
+            append('.');
+            append(digits, static_cast<size_t>(precision));
+        }
+        return *this;
+    }
+
+    /**
+     * Append a date as YYYY-MM-DD.
+     */
+    BufferWriter& appendDate(Date date) {
+        char text[16];
+        size_t n = DateUtils::formatDate(date, text, sizeof(text));
+        return append(text, n);
+    }
+};
+
+/**
+ * Materialize anything with a formatTo(BufferWriter&) member as a std::string.
+ * Formats on the stack first and only retries on the heap if the output
+ * did not fit, so the returned string is the only allocation.
+ */
+template <typename T>
+std::string formatToString(const T& value) {
+    char stackBuffer[256];
+    BufferWriter writer(stackBuffer, sizeof(stackBuffer));
+    value.formatTo(writer);
+    if (!writer.truncated()) {
+        return std::string(writer.data(), writer.size());
+    }
+    std::string result(writer.requiredSize() + 1, '\0');
+    BufferWriter retry(&result[0], result.size());
+    value.formatTo(retry);
+    result.resize(retry.size());
+    return result;
+}
+
+} // namespace sip
+
+#endif // BUFFER_WRITER_H
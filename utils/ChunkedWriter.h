@@ -0,0 +1,78 @@
+#ifndef CHUNKED_WRITER_H
+#define CHUNKED_WRITER_H
+
+#include "BufferWriter.h"
+#include <ostream>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Writes text records (CSV rows) to a stream through one reusable chunk
+ * buffer, handed to the stream in large writes.
+ *
+ * Each record is formatted straight into the chunk. A record that does not
+ * fit in the space left is rolled back, the chunk is flushed and the record
+ * formatted again; one larger than the whole chunk grows it. Records are
+ * therefore never truncated, and the writer allocates only when a record
+ * outgrows the chunk.
+ */
+class ChunkedWriter {
+private:
+    std::ostream& out;
+    std::vector<char> chunk;
+    BufferWriter writer;
+
+public:
+    /**
+     * Constructor.
+     * @param out Destination stream
+     * @param chunkSize Bytes buffered between writes to the stream
+     */
+    explicit ChunkedWriter(std::ostream& out, size_t chunkSize = 64 * 1024)
+        : out(out),
+          chunk(chunkSize < 256 ? 256 : chunkSize),
+          writer(chunk.data(), chunk.size()) {}
+
+    ~ChunkedWriter() {
+        flush();
+    }
+
+    ChunkedWriter(const ChunkedWriter&) = delete;
+    ChunkedWriter& operator=(const ChunkedWriter&) = delete;
+
+    /**
+     * Write one record. `format(BufferWriter&)` appends it and may be
+     * called a second time if the record had to be retried.
+     */
+    template <typename Format>
+    void writeRecord(Format format) {
+        size_t start = writer.size();
+        format(writer);
+        if (!writer.truncated()) {
+            return;
+        }
+        size_t needed = writer.requiredSize() - start;
+        writer.rewind(start);
+        flush();
+        if (needed >= chunk.size()) {
+            chunk.assign(needed + 1, '\0');
+            writer = BufferWriter(chunk.data(), chunk.size());
+        }
+        format(writer);
+    }
+
+    /**
+     * Hand buffered records to the stream.
+     */
+    void flush() {
+        if (writer.size() > 0) {
+            out.write(writer.data(), static_cast<std::streamsize>(writer.size()));
+            writer.clear();
+        }
+    }
+};
+
+} // namespace sip
+
+#endif // CHUNKED_WRITER_H
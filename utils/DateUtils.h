@@ -1,11 +1,11 @@
 #ifndef DATE_UTILS_H
 #define DATE_UTILS_H
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <ctime>
 #include <string>
-#include <iomanip>
-#include <sstream>
 
 namespace sip {
 
@@ -23,6 +23,21 @@ public:
         return std::chrono::system_clock::now();
     }
 
+    /**
+     * Break a date into local calendar fields. Reentrant (localtime_r), so
+     * safe on payment callback threads.
+     */
+    static std::tm toLocalTime(Date date) {
+        std::time_t time = std::chrono::system_clock::to_time_t(date);
+        std::tm tm;
+#if defined(_WIN32)
+        localtime_s(&tm, &time);
+#else
+        localtime_r(&time, &tm);
+#endif
+        return tm;
+    }
+
     /**
      * Create a date from year, month, day.
      */
@@ -50,33 +65,32 @@ public:
      * Handles edge cases like 31st -> 28th/30th.
      */
     static Date addMonths(Date date, int months) {
-        std::time_t time = std::chrono::system_clock::to_time_t(date);
-        std::tm* tm = std::localtime(&time);
+        std::tm tm = toLocalTime(date);
         
-        int originalDay = tm->tm_mday;
+        int originalDay = tm.tm_mday;
         
         // Add months
-        tm->tm_mon += months;
+        tm.tm_mon += months;
         
         // Normalize year/month overflow
-        while (tm->tm_mon > 11) {
-            tm->tm_mon -= 12;
-            tm->tm_year++;
+        while (tm.tm_mon > 11) {
+            tm.tm_mon -= 12;
+            tm.tm_year++;
         }
-        while (tm->tm_mon < 0) {
-            tm->tm_mon += 12;
-            tm->tm_year--;
+        while (tm.tm_mon < 0) {
+            tm.tm_mon += 12;
+            tm.tm_year--;
         }
         
         // Handle day overflow (e.g., Jan 31 + 1 month = Feb 28/29)
-        int daysInMonth = getDaysInMonth(tm->tm_year + 1900, tm->tm_mon + 1);
+        int daysInMonth = getDaysInMonth(tm.tm_year + 1900, tm.tm_mon + 1);
         if (originalDay > daysInMonth) {
-            tm->tm_mday = daysInMonth;
+            tm.tm_mday = daysInMonth;
         } else {
-            tm->tm_mday = originalDay;
+            tm.tm_mday = originalDay;
         }
         
-        return std::chrono::system_clock::from_time_t(std::mktime(tm));
+        return std::chrono::system_clock::from_time_t(std::mktime(&tm));
     }
 
     /**
@@ -90,30 +104,23 @@ public:
      * Get day of week (0 = Sunday, 1 = Monday, ..., 6 = Saturday).
      */
     static int getDayOfWeek(Date date) {
-        std::time_t time = std::chrono::system_clock::to_time_t(date);
-        std::tm* tm = std::localtime(&time);
-        return tm->tm_wday;
+        return toLocalTime(date).tm_wday;
     }
 
     /**
      * Get day of month (1-31).
      */
     static int getDayOfMonth(Date date) {
-        std::time_t time = std::chrono::system_clock::to_time_t(date);
-        std::tm* tm = std::localtime(&time);
-        return tm->tm_mday;
+        return toLocalTime(date).tm_mday;
     }
 
     /**
      * Check if two dates are the same day.
      */
     static bool isSameDay(Date date1, Date date2) {
-        std::time_t time1 = std::chrono::system_clock::to_time_t(date1);
-        std::time_t time2 = std::chrono::system_clock::to_time_t(date2);
-        std::tm* tm1 = std::localtime(&time1);
-        int y1 = tm1->tm_year, m1 = tm1->tm_mon, d1 = tm1->tm_mday;
-        std::tm* tm2 = std::localtime(&time2);
-        return y1 == tm2->tm_year && m1 == tm2->tm_mon && d1 == tm2->tm_mday;
+        std::tm tm1 = toLocalTime(date1);
+        std::tm tm2 = toLocalTime(date2);
+        return tm1.tm_year == tm2.tm_year && tm1.tm_mon == tm2.tm_mon && tm1.tm_mday == tm2.tm_mday;
     }
 
     /**
@@ -127,14 +134,39 @@ public:
      * Format date as string (YYYY-MM-DD).
      */
     static std::string formatDate(Date date) {
-        std::time_t time = std::chrono::system_clock::to_time_t(date);
-        std::tm* tm = std::localtime(&time);
-        std::ostringstream oss;
-        oss << std::setfill('0') 
-            << (tm->tm_year + 1900) << "-"
-            << std::setw(2) << (tm->tm_mon + 1) << "-"
-            << std::setw(2) << tm->tm_mday;
-        return oss.str();
+        char buffer[16];
+        size_t length = formatDate(date, buffer, sizeof(buffer));
+        return std::string(buffer, length);
+    }
+
+    /**
+     * Format date as YYYY-MM-DD into a caller-supplied buffer without allocating.
+     * Returns the number of characters written (excluding the NUL terminator),
+     * or 0 if the buffer is smaller than 11 bytes.
+     */
+    static size_t formatDate(Date date, char* buffer, size_t capacity) {
+        if (capacity < 11) {
+            return 0;
+        }
+        std::tm tm = toLocalTime(date);
+        int year = tm.tm_year + 1900;
+        int month = tm.tm_mon + 1;
+        if (year < 0 || year > 9999) {
+            int n = std::snprintf(buffer, capacity, "%d-%02d-%02d", year, month, tm.tm_mday);
+            return n > 0 ? std::min(static_cast<size_t>(n), capacity - 1) : 0;
+        }
+        buffer[0] = static_cast<char>('0' + year / 1000);
+        buffer[1] = static_cast<char>('0' + year / 100 % 10);
+        buffer[2] = static_cast<char>('0' + year / 10 % 10);
+        buffer[3] = static_cast<char>('0' + year % 10);
+        buffer[4] = '-';
+        buffer[5] = static_cast<char>('0' + month / 10);
+        buffer[6] = static_cast<char>('0' + month % 10);
+        buffer[7] = '-';
+        buffer[8] = static_cast<char>('0' + tm.tm_mday / 10);
+        buffer[9] = static_cast<char>('0' + tm.tm_mday % 10);
+        buffer[10] = '\0';
+        return 10;
     }
 
     /**
@@ -146,7 +178,6 @@ public:
         return days[getDayOfWeek(date)];
     }
 
-private:
     /**
      * Get number of days in a month.
      */
@@ -166,6 +197,96 @@ private:
     static bool isLeapYear(int year) {
         return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
     }
+
+    /**
+     * Days since 1970-01-01 for a civil (proleptic Gregorian) date.
+     * Pure arithmetic - no timezone lookups.
+     */
+    static int daysFromCivil(int year, int month, int day) {
+        year -= month <= 2 ? 1 : 0;
+        const int era = (year >= 0 ? year : year - 399) / 400;
+        const int yoe = year - era * 400;
+        const int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    /**
+     * Inverse of daysFromCivil.
+     */
+    static void civilFromDays(int days, int& year, int& month, int& day) {
+        days += 719468;
+        const int era = (days >= 0 ? days : days - 146096) / 146097;
+        const int doe = days - era * 146097;
+        const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const int mp = (5 * doy + 2) / 153;
+        day = doy - (153 * mp + 2) / 5 + 1;
+        month = mp < 10 ? mp + 3 : mp - 9;
+        year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+    }
+
+    /**
+     * Local calendar day of a date, as a daysFromCivil day number.
+     */
+    static int toDayNumber(Date date) {
+        std::tm tm = toLocalTime(date);
+        return daysFromCivil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+    }
+
+    /**
+     * Local midnight of a daysFromCivil day number (inverse of toDayNumber).
+     */
+    static Date fromDayNumber(int days) {
+        int year, month, day;
+        civilFromDays(days, year, month, day);
+        return createDate(year, month, day);
+    }
+
+    /**
+     * fromDayNumber for an ascending run of day numbers (e.g. a time series).
+     * Local midnights are interpolated in whole days between exactly computed
+     * endpoints at most 28 days apart whose spacing shows no UTC-offset change,
+     * so only a handful of mktime calls are made per year of dates.
+     */
+    static void fromDayNumbers(const int* days, size_t count, Date* out) {
+        if (count == 0) {
+            return;
+        }
+        out[0] = fromDayNumber(days[0]);
+        if (count > 1) {
+            out[count - 1] = fromDayNumber(days[count - 1]);
+            fillDayNumbers(days, out, 0, count - 1);
+        }
+    }
+
+    /**
+     * Day of week for a day number from daysFromCivil (0 = Sunday).
+     */
+    static int dayOfWeekFromDays(int days) {
+        return days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6;
+    }
+
+private:
+    /**
+     * Fill out[low+1 .. high-1], given exact out[low] and out[high].
+     */
+    static void fillDayNumbers(const int* days, Date* out, size_t low, size_t high) {
+        if (high - low <= 1) {
+            return;
+        }
+        int span = days[high] - days[low];
+        if (span <= 28 && out[high] - out[low] == std::chrono::hours(24 * span)) {
+            for (size_t i = low + 1; i < high; ++i) {
+                out[i] = out[low] + std::chrono::hours(24 * (days[i] - days[low]));
+            }
+            return;
+        }
+        size_t middle = low + (high - low) / 2;
+        out[middle] = fromDayNumber(days[middle]);
+        fillDayNumbers(days, out, low, middle);
+        fillDayNumbers(days, out, middle, high);
+    }
 };
 
 } // namespace sip
@@ -0,0 +1,78 @@
+#ifndef DECIMAL_PARSER_H
+#define DECIMAL_PARSER_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+namespace sip {
+
+/**
+ * Parses plain decimal numbers ("105.4212", "-3", "0.5") without allocating
+ * or consulting the locale, in the spirit of std::from_chars.
+ *
+ * Numbers with at most 19 digits whose value without the point fits in 2^53
+ * and with at most 22 fraction digits - every NAV and amount in practice - are
+ * computed as digits / 10^fractionDigits, where both operands are exact
+ * doubles, so the one division rounds correctly (Clinger's fast path).
+ * Anything longer falls back to strtod.
+ */
+class DecimalParser {
+public:
+    /**
+     * Parse [first, last) completely: optional sign, digits, optional '.'
+     * and fraction digits. No exponent and no surrounding whitespace.
+     * Returns false (leaving value unchanged) if the text is not such a number.
+     */
+    static bool parse(const char* first, const char* last, double& value) {
+        static const double kPowersOfTen[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+        const char* p = first;
+        bool negative = false;
+        if (p < last && (*p == '-' || *p == '+')) {
+            negative = *p == '-';
+            ++p;
+        }
+
+        // 19 digits always fit in a uint64_t; longer numbers are left to strtod
+        const char* digitsStart = p;
+        uint64_t digits = 0;
+        for (; p < last && isDigit(*p); ++p) {
+            digits = digits * 10 + static_cast<uint64_t>(*p - '0');
+        }
+        size_t digitCount = static_cast<size_t>(p - digitsStart);
+        size_t fractionDigits = 0;
+        if (p < last && *p == '.') {
+            const char* fractionStart = ++p;
+            for (; p < last && isDigit(*p); ++p) {
+                digits = digits * 10 + static_cast<uint64_t>(*p - '0');
+            }
+            fractionDigits = static_cast<size_t>(p - fractionStart);
+            digitCount += fractionDigits;
+        }
+        if (digitCount == 0 || p != last) {
+            return false;
+        }
+
+        if (digitCount <= 19 && digits <= (1ULL << 53) && fractionDigits <= 22) {
+            double result = static_cast<double>(digits) / kPowersOfTen[fractionDigits];
+            value = negative ? -result : result;
+            return true;
+        }
+        // Too many digits for the fast path; the text is known to be well formed
+        std::string text(first, last);
+        value = std::strtod(text.c_str(), nullptr);
+        return true;
+    }
+
+private:
+    static bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+};
+
+} // namespace sip
+
+#endif // DECIMAL_PARSER_H
@@ -0,0 +1,138 @@
+#ifndef EPOCH_DOMAIN_H
+#define EPOCH_DOMAIN_H
+
+#include "Exceptions.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace sip {
+
+/**
+ * Epoch-based reclamation for read-mostly structures published through an
+ * atomic pointer (see NavTable).
+ *
+ * A reader wraps its accesses in a Guard, which announces the global epoch
+ * in the thread's slot: a load and a store, so reads are wait-free. A writer
+ * that unlinks an old version calls advance() and keeps the returned epoch
+ * with it; the version may be freed once oldestActive() is greater, because
+ * every reader that could still see it announced that epoch or an earlier one.
+ *
+ * Slots are claimed on a thread's first read and released when the thread
+ * exits. All operations are sequentially consistent, which is what makes the
+ * announce-then-load / unlink-then-scan handshake safe.
+ */
+class EpochDomain {
+public:
+    static const size_t kMaxReaderThreads = 1024;
+    static const uint64_t kIdle = UINT64_MAX;  // Slot epoch of a thread outside any Guard
+
+    /**
+     * Marks the current thread as reading while the Guard lives. Guards nest.
+     * @throws SIPSystemException if more than kMaxReaderThreads threads read at once
+     */
+    class Guard {
+    public:
+        Guard() {
+            ThreadRecord& record = threadRecord();
+            if (record.depth == 0) {
+                if (!record.slot) {
+                    record.slot = instance().claimSlot();
+                }
+                record.slot->epoch.store(instance().globalEpoch.load());
+            }
+            record.depth++;
+        }
+
+        ~Guard() {
+            ThreadRecord& record = threadRecord();
+            if (--record.depth == 0) {
+                record.slot->epoch.store(kIdle);
+            }
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    static EpochDomain& instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    /**
+     * Start a new epoch. Returns the epoch that was current, to be stored
+     * with a version unlinked just before the call.
+     */
+    uint64_t advance() {
+        return globalEpoch.fetch_add(1);
+    }
+
+    /**
+     * Smallest epoch announced by a reader inside a Guard (kIdle if none).
+     * Versions retired at a smaller epoch can no longer be reached.
+     */
+    uint64_t oldestActive() const {
+        uint64_t oldest = kIdle;
+        size_t used = slotsUsed.load();
+        for (size_t i = 0; i < used; ++i) {
+            uint64_t epoch = slots[i].epoch.load();
+            if (epoch < oldest) {
+                oldest = epoch;
+            }
+        }
+        return oldest;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch;
+        std::atomic<bool> claimed;
+
+        Slot() : epoch(kIdle), claimed(false) {}
+    };
+
+    /**
+     * Per-thread slot and Guard nesting depth; gives the slot back at thread exit.
+     */
+    struct ThreadRecord {
+        Slot* slot;
+        unsigned depth;
+
+        ThreadRecord() : slot(nullptr), depth(0) {}
+
+        ~ThreadRecord() {
+            if (slot) {
+                slot->epoch.store(kIdle);
+                slot->claimed.store(false);
+            }
+        }
+    };
+
+    Slot slots[kMaxReaderThreads];
+    std::atomic<size_t> slotsUsed;  // High-water mark of claimed slots, bounds the scan
+    std::atomic<uint64_t> globalEpoch;
+
+    EpochDomain() : slotsUsed(0), globalEpoch(1) {}
+
+    static ThreadRecord& threadRecord() {
+        thread_local ThreadRecord record;
+        return record;
+    }
+
+    Slot* claimSlot() {
+        for (size_t i = 0; i < kMaxReaderThreads; ++i) {
+            if (!slots[i].claimed.exchange(true)) {
+                size_t used = slotsUsed.load();
+                while (used < i + 1 && !slotsUsed.compare_exchange_weak(used, i + 1)) {
+                }
+                return &slots[i];
+            }
+        }
+        throw SIPSystemException("Too many concurrent reader threads");
+    }
+};
+
+} // namespace sip
+
+#endif // EPOCH_DOMAIN_H
@@ -0,0 +1,93 @@
+#ifndef ID_INTERNER_H
+#define ID_INTERNER_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Thread-safe, append-only mapping between string IDs and dense integer
+ * handles (0, 1, 2, ...). Handles are never reused, so they can index
+ * contiguous arrays (hot records, NAV tables) shared across components.
+ */
+class IdInterner {
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, uint32_t> handleById;
+    std::deque<std::string> idByHandle;  // deque keeps references stable on growth
+
+public:
+    static const uint32_t kInvalidHandle = 0xFFFFFFFFu;
+
+    /**
+     * Get the handle for an ID, assigning the next one if it is new.
+     */
+    uint32_t intern(const std::string& id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = handleById.find(id);
+        if (it != handleById.end()) {
+            return it->second;
+        }
+        uint32_t handle = static_cast<uint32_t>(idByHandle.size());
+        idByHandle.push_back(id);
+        handleById.emplace(id, handle);
+        return handle;
+    }
+
+    /**
+     * intern() for a batch under one lock: handles[i] receives the handle of ids[i].
+     */
+    void internAll(const std::vector<std::string>& ids, uint32_t* handles) {
+        std::lock_guard<std::mutex> lock(mutex);
+        handleById.reserve(handleById.size() + ids.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            auto inserted = handleById.emplace(ids[i], static_cast<uint32_t>(idByHandle.size()));
+            if (inserted.second) {
+                idByHandle.push_back(ids[i]);
+            }
+            handles[i] = inserted.first->second;
+        }
+    }
+
+    /**
+     * Get the handle for an ID, or kInvalidHandle if it was never interned.
+     */
+    uint32_t find(const std::string& id) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = handleById.find(id);
+        if (it == handleById.end()) {
+            return kInvalidHandle;
+        }
+        return it->second;
+    }
+
+    /**
+     * Get the ID for a handle. The reference stays valid for the interner's lifetime.
+     */
+    const std::string& idOf(uint32_t handle) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return idByHandle.at(handle);
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return idByHandle.size();
+    }
+
+    /**
+     * Process-wide fund handle space, shared by repositories and price services.
+     */
+    static IdInterner& funds() {
+        static IdInterner instance;
+        return instance;
+    }
+};
+
+} // namespace sip
+
+#endif // ID_INTERNER_H
@@ -0,0 +1,298 @@
+#ifndef IDEMPOTENCY_STORE_H
+#define IDEMPOTENCY_STORE_H
+
+#include "Exceptions.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Remembers which keys (e.g. transaction IDs of payment callbacks) were seen
+ * within a time window, in bounded memory.
+ *
+ * Keys are reduced to 64-bit hashes and kept in a ring of time buckets: a
+ * key lands in the bucket of the current period, and a bucket is cleared
+ * when its slot comes round again, so memory is proportional to the keys
+ * seen in one window rather than all keys ever seen. With B buckets of width
+ * ttl / (B - 1), a key is remembered for at least ttl and at most
+ * ttl * B / (B - 1).
+ *
+ * Each bucket is an open-addressing set of hashes, optionally fronted by a
+ * Bloom filter so that a new key (the common case) is usually rejected by
+ * bit tests without probing any set. Every operation is O(buckets).
+ * Two different keys share a hash with probability about n^2 / 2^65, in
+ * which case the second would be reported as a duplicate.
+ *
+ * Thread-safe.
+ */
+class IdempotencyStore {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+private:
+    /**
+     * Hashes in open addressing with linear probing; 0 marks an empty slot.
+     */
+    class HashSet {
+    private:
+        std::vector<uint64_t> slots;  // Power-of-two size
+        size_t count;
+
+        void grow() {
+            std::vector<uint64_t> previous;
+            previous.swap(slots);
+            slots.assign(previous.size() * 2, 0);
+            count = 0;
+            for (uint64_t hash : previous) {
+                if (hash != 0) {
+                    insert(hash);
+                }
+            }
+        }
+
+    public:
+        explicit HashSet(size_t expected) : count(0) {
+            size_t capacity = 16;
+            while (capacity < expected * 2) {
+                capacity *= 2;
+            }
+            slots.assign(capacity, 0);
+        }
+
+        bool contains(uint64_t hash) const {
+            size_t mask = slots.size() - 1;
+            for (size_t i = static_cast<size_t>(hash) & mask; slots[i] != 0; i = (i + 1) & mask) {
+                if (slots[i] == hash) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void insert(uint64_t hash) {
+            if ((count + 1) * 2 > slots.size()) {
+                grow();
+            }
+            size_t mask = slots.size() - 1;
+            size_t i = static_cast<size_t>(hash) & mask;
+            while (slots[i] != 0 && slots[i] != hash) {
+                i = (i + 1) & mask;
+            }
+            if (slots[i] == 0) {
+                slots[i] = hash;
+                count++;
+            }
+        }
+
+        // Keeps the capacity: a bucket's next period is likely to be as busy
+        void clear() {
+            if (count > 0) {
+                std::fill(slots.begin(), slots.end(), 0);
+                count = 0;
+            }
+        }
+
+        size_t size() const {
+            return count;
+        }
+
+        size_t memoryBytes() const {
+            return slots.size() * sizeof(uint64_t);
+        }
+    };
+
+    /**
+     * Blocked Bloom filter over hashes: the low bits pick a 512-bit block
+     * (one cache line) and a remix of the hash picks kProbes bits in it, so a
+     * lookup touches a single cache line.
+     */
+    class BloomFilter {
+    private:
+        enum { kProbes = 6, kBlockWords = 8 };
+        std::vector<uint64_t> words;  // Power-of-two number of blocks
+        bool empty;
+
+        size_t blockOf(uint64_t hash) const {
+            return (static_cast<size_t>(hash) & (words.size() / kBlockWords - 1)) * kBlockWords;
+        }
+
+    public:
+        // About 10 bits per expected key: ~1-2% false positives at that load
+        explicit BloomFilter(size_t expected) : empty(true) {
+            size_t bits = 512;
+            while (bits < expected * 10) {
+                bits *= 2;
+            }
+            words.assign(bits / 64, 0);
+        }
+
+        bool mayContain(uint64_t hash) const {
+            const uint64_t* block = &words[blockOf(hash)];
+            uint64_t probes = (hash * 0x9E3779B97F4A7C15ULL) >> 10;
+            for (int k = 0; k < kProbes; ++k, probes >>= 9) {
+                if ((block[(probes >> 6) & 7] & (1ULL << (probes & 63))) == 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void insert(uint64_t hash) {
+            uint64_t* block = &words[blockOf(hash)];
+            uint64_t probes = (hash * 0x9E3779B97F4A7C15ULL) >> 10;
+            for (int k = 0; k < kProbes; ++k, probes >>= 9) {
+                block[(probes >> 6) & 7] |= 1ULL << (probes & 63);
+            }
+            empty = false;
+        }
+
+        void clear() {
+            if (!empty) {
+                std::fill(words.begin(), words.end(), 0);
+                empty = true;
+            }
+        }
+
+        size_t memoryBytes() const {
+            return words.size() * sizeof(uint64_t);
+        }
+    };
+
+    struct Bucket {
+        int64_t period;  // Period whose keys it holds; -1 = never used
+        HashSet keys;
+        BloomFilter bloom;
+
+        Bucket(size_t expected, bool useBloom)
+            : period(-1), keys(expected), bloom(useBloom ? expected : 0) {}
+    };
+
+    Clock::time_point origin;
+    Clock::duration bucketWidth;
+    bool useBloomFilter;
+    mutable std::mutex mutex;
+    std::vector<Bucket> buckets;
+
+    int64_t periodOf(Clock::time_point now) const {
+        return now <= origin ? 0 : static_cast<int64_t>((now - origin) / bucketWidth);
+    }
+
+    bool live(const Bucket& bucket, int64_t current) const {
+        return bucket.period >= 0 && current - bucket.period < static_cast<int64_t>(buckets.size());
+    }
+
+    bool containsHash(uint64_t hash, int64_t current) const {
+        for (const Bucket& bucket : buckets) {
+            if (live(bucket, current) && bucket.keys.size() > 0 &&
+                (!useBloomFilter || bucket.bloom.mayContain(hash)) && bucket.keys.contains(hash)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param ttl How long a key must be remembered (e.g. the gateway's retry window)
+     * @param bucketCount Buckets in the ring (at least 2); more buckets expire keys closer to ttl
+     * @param useBloomFilter Front each bucket with a Bloom filter
+     * @param expectedKeysPerBucket Initial sizing; buckets grow past it if needed
+     */
+    explicit IdempotencyStore(Clock::duration ttl, size_t bucketCount = 8, bool useBloomFilter = true,
+                              size_t expectedKeysPerBucket = 1024)
+        : origin(Clock::now()), bucketWidth(ttl / static_cast<int>(bucketCount > 1 ? bucketCount - 1 : 1)),
+          useBloomFilter(useBloomFilter) {
+        if (bucketCount < 2) {
+            throw ValidationException("Idempotency store needs at least two buckets");
+        }
+        if (bucketWidth <= Clock::duration::zero()) {
+            throw ValidationException("Idempotency window must be positive");
+        }
+        buckets.reserve(bucketCount);
+        for (size_t b = 0; b < bucketCount; ++b) {
+            buckets.push_back(Bucket(expectedKeysPerBucket, useBloomFilter));
+        }
+    }
+
+    /**
+     * 64-bit hash of a key (FNV-1a with a final avalanche). Never 0.
+     */
+    static uint64_t hashKey(const std::string& key) {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        for (unsigned char c : key) {
+            hash = (hash ^ c) * 0x100000001B3ULL;
+        }
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ULL;
+        hash ^= hash >> 33;
+        return hash != 0 ? hash : 1;
+    }
+
+    /**
+     * Record a key unless it was seen within the window.
+     * @return true if the key is new (the caller should process it),
+     *         false for a duplicate
+     */
+    bool tryRecord(const std::string& key, Clock::time_point now = Clock::now()) {
+        uint64_t hash = hashKey(key);
+        int64_t current = periodOf(now);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (containsHash(hash, current)) {
+            return false;
+        }
+        Bucket& bucket = buckets[static_cast<size_t>(current % static_cast<int64_t>(buckets.size()))];
+        if (bucket.period != current) {
+            bucket.keys.clear();
+            bucket.bloom.clear();
+            bucket.period = current;
+        }
+        bucket.keys.insert(hash);
+        if (useBloomFilter) {
+            bucket.bloom.insert(hash);
+        }
+        return true;
+    }
+
+    /**
+     * Whether a key was recorded within the window.
+     */
+    bool contains(const std::string& key, Clock::time_point now = Clock::now()) const {
+        uint64_t hash = hashKey(key);
+        int64_t current = periodOf(now);
+        std::lock_guard<std::mutex> lock(mutex);
+        return containsHash(hash, current);
+    }
+
+    // Keys currently remembered
+    size_t size(Clock::time_point now = Clock::now()) const {
+        int64_t current = periodOf(now);
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t total = 0;
+        for (const Bucket& bucket : buckets) {
+            total += live(bucket, current) ? bucket.keys.size() : 0;
+        }
+        return total;
+    }
+
+    // Bytes held by the sets and Bloom filters
+    size_t memoryBytes() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t total = 0;
+        for (const Bucket& bucket : buckets) {
+            total += bucket.keys.memoryBytes() + (useBloomFilter ? bucket.bloom.memoryBytes() : 0);
+        }
+        return total;
+    }
+};
+
+} // namespace sip
+
+#endif // IDEMPOTENCY_STORE_H
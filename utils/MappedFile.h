@@ -0,0 +1,92 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include "Exceptions.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sip {
+
+/**
+ * Read-only memory mapping of a whole file. The mapping is released when the
+ * object is destroyed; an empty file maps to (nullptr, 0).
+ */
+class MappedFile {
+private:
+    const uint8_t* bytes;
+    size_t length;
+
+public:
+    MappedFile() : bytes(nullptr), length(0) {}
+
+    /**
+     * Map a file.
+     * @throws SIPSystemException if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string& path) : bytes(nullptr), length(0) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw SIPSystemException("Cannot open file: " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw SIPSystemException("Cannot stat file: " + path);
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                ::close(fd);
+                throw SIPSystemException("Cannot map file: " + path);
+            }
+            bytes = static_cast<const uint8_t*>(mapping);
+        }
+        ::close(fd);  // The mapping stays valid after the descriptor is closed
+    }
+
+    ~MappedFile() {
+        if (bytes) {
+            ::munmap(const_cast<uint8_t*>(bytes), length);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) : bytes(other.bytes), length(other.length) {
+        other.bytes = nullptr;
+        other.length = 0;
+    }
+
+    MappedFile& operator=(MappedFile&& other) {
+        if (this != &other) {
+            if (bytes) {
+                ::munmap(const_cast<uint8_t*>(bytes), length);
+            }
+            bytes = other.bytes;
+            length = other.length;
+            other.bytes = nullptr;
+            other.length = 0;
+        }
+        return *this;
+    }
+
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+
+    static bool exists(const std::string& path) {
+        struct stat info;
+        return ::stat(path.c_str(), &info) == 0;
+    }
+};
+
+} // namespace sip
+
+#endif // MAPPED_FILE_H
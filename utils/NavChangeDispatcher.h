@@ -0,0 +1,223 @@
+#ifndef NAV_CHANGE_DISPATCHER_H
+#define NAV_CHANGE_DISPATCHER_H
+
+#include "../models/NavChange.h"
+#include "Exceptions.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Delivers NAV change batches to subscribers on one background thread.
+ *
+ * Publishers never wait for listeners: batches go into a queue of at most
+ * `capacity` entries, and when it is full a new batch is merged into the
+ * newest queued one (latest NAV per fund wins). A slow subscriber therefore
+ * sees fewer, larger batches but never misses a fund's final NAV, and the
+ * queue never holds more than capacity - 1 batches plus one entry per fund.
+ *
+ * A subscriber sees every batch delivered while it is subscribed, in
+ * version order, including batches queued just before it subscribed.
+ * Listeners run without any lock held, so they may subscribe, unsubscribe
+ * or publish prices themselves; an exception from a listener is counted
+ * and dropped.
+ */
+class NavChangeDispatcher {
+private:
+    mutable std::mutex mutex;
+    std::condition_variable wake;     // Dispatcher: work queued or stopping
+    std::condition_variable drained;  // flush(): queue empty and nothing in delivery
+    std::deque<NavChangeBatch> queue;
+    size_t capacity;
+    bool delivering;
+    bool stopping;
+    std::map<uint64_t, std::shared_ptr<NavChangeListener>> listeners;
+    uint64_t nextSubscriptionId;
+    std::atomic<size_t> subscriberCount;
+    uint64_t deliveredBatches;
+    uint64_t mergedBatches;
+    uint64_t failedDeliveries;
+    std::thread worker;  // Started by the first subscription
+
+    static void merge(NavChangeBatch& into, NavChangeBatch& batch) {
+        into.version = batch.version;
+        std::vector<NavChange> merged;
+        merged.reserve(into.changes.size() + batch.changes.size());
+        // Both sides are in handle order; on a tie the newer NAV wins
+        size_t i = 0, j = 0;
+        while (i < into.changes.size() || j < batch.changes.size()) {
+            if (j == batch.changes.size() ||
+                (i < into.changes.size() && into.changes[i].fundHandle < batch.changes[j].fundHandle)) {
+                merged.push_back(into.changes[i++]);
+            } else {
+                if (i < into.changes.size() && into.changes[i].fundHandle == batch.changes[j].fundHandle) {
+                    ++i;
+                }
+                merged.push_back(batch.changes[j++]);
+            }
+        }
+        into.changes.swap(merged);
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            NavChangeBatch batch = std::move(queue.front());
+            queue.pop_front();
+            std::vector<std::shared_ptr<NavChangeListener>> targets;
+            targets.reserve(listeners.size());
+            for (const auto& entry : listeners) {
+                targets.push_back(entry.second);
+            }
+            delivering = true;
+            lock.unlock();
+
+            uint64_t failures = 0;
+            for (const auto& listener : targets) {
+                try {
+                    (*listener)(batch);
+                } catch (...) {
+                    failures++;
+                }
+            }
+
+            lock.lock();
+            delivering = false;
+            deliveredBatches++;
+            failedDeliveries += failures;
+            if (queue.empty()) {
+                drained.notify_all();
+            }
+        }
+    }
+
+public:
+    explicit NavChangeDispatcher(size_t capacity = 64)
+        : capacity(std::max<size_t>(capacity, 1)), delivering(false), stopping(false),
+          nextSubscriptionId(1), subscriberCount(0), deliveredBatches(0), mergedBatches(0),
+          failedDeliveries(0) {}
+
+    /**
+     * Stops the dispatcher thread after the batch in delivery, if any;
+     * batches still queued are discarded.
+     */
+    ~NavChangeDispatcher() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    NavChangeDispatcher(const NavChangeDispatcher&) = delete;
+    NavChangeDispatcher& operator=(const NavChangeDispatcher&) = delete;
+
+    /**
+     * Register a listener for every batch delivered from now on. Batches
+     * already queued but not yet delivered reach it too, so it may first
+     * see changes published before it subscribed.
+     * @return Subscription ID for unsubscribe
+     */
+    uint64_t subscribe(NavChangeListener listener) {
+        if (!listener) {
+            throw ValidationException("NAV change listener must not be empty");
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!worker.joinable()) {
+            worker = std::thread([this]() { run(); });
+        }
+        uint64_t id = nextSubscriptionId++;
+        listeners[id] = std::make_shared<NavChangeListener>(std::move(listener));
+        subscriberCount.store(listeners.size());
+        return id;
+    }
+
+    /**
+     * Remove a listener. A batch already in delivery may still reach it.
+     * @return false if there is no such subscription
+     */
+    bool unsubscribe(uint64_t subscriptionId) {
+        std::lock_guard<std::mutex> lock(mutex);
+        bool removed = listeners.erase(subscriptionId) > 0;
+        subscriberCount.store(listeners.size());
+        return removed;
+    }
+
+    /**
+     * Cheap check for publishers, so they can skip building batches
+     * nobody would receive.
+     */
+    bool hasSubscribers() const {
+        return subscriberCount.load() > 0;
+    }
+
+    /**
+     * Queue a batch for delivery (changes in fund handle order, one per fund).
+     * Never waits for listeners.
+     */
+    void publish(NavChangeBatch batch) {
+        if (batch.changes.empty()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (listeners.empty()) {
+                return;
+            }
+            if (queue.size() >= capacity) {
+                merge(queue.back(), batch);
+                mergedBatches++;
+                return;
+            }
+            queue.push_back(std::move(batch));
+        }
+        wake.notify_one();
+    }
+
+    /**
+     * Wait until every batch published so far has been delivered.
+     * Must not be called from a listener.
+     */
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        drained.wait(lock, [this]() { return stopping || (queue.empty() && !delivering); });
+    }
+
+    // Batches handed to listeners so far
+    uint64_t getDeliveredBatchCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return deliveredBatches;
+    }
+
+    // Batches merged into a queued one because the queue was full
+    uint64_t getMergedBatchCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return mergedBatches;
+    }
+
+    // Listener calls that threw
+    uint64_t getFailedDeliveryCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return failedDeliveries;
+    }
+};
+
+} // namespace sip
+
+#endif // NAV_CHANGE_DISPATCHER_H
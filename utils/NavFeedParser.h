@@ -0,0 +1,233 @@
+#ifndef NAV_FEED_PARSER_H
+#define NAV_FEED_PARSER_H
+
+#include "DateUtils.h"
+#include "DecimalParser.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace sip {
+
+/**
+ * A parsed daily NAV file, column by column: navs[i] and days[i] belong to
+ * schemeCodes[i]. Days are DateUtils::daysFromCivil day numbers.
+ */
+struct NavFeed {
+    std::vector<std::string> schemeCodes;
+    std::vector<double> navs;
+    std::vector<int> days;
+    size_t unpricedCount;   // Scheme lines without a NAV ("N.A.", blank or zero)
+    size_t malformedCount;  // Scheme lines whose code, NAV or date does not parse
+
+    NavFeed() : unpricedCount(0), malformedCount(0) {}
+
+    size_t size() const { return schemeCodes.size(); }
+};
+
+/**
+ * Parser for the semicolon-delimited scheme NAV file published daily by AMFI:
+ *
+ *   Scheme Code;ISIN Div Payout/ ISIN Growth;ISIN Div Reinvestment;Scheme Name;Net Asset Value;Date
+ *   Open Ended Schemes(Equity Scheme - Large Cap Fund)
+ *   <AMC name>
+ *   119551;INF209KA12Z1;INF209KA13Z9;<scheme name>;105.1763;16-Oct-2026
+ *
+ * Lines without a semicolon (blank lines, category and AMC headings) and the
+ * column header are skipped. The code is the first field and the NAV and
+ * date the last two, so a scheme name containing ';' does not shift them.
+ * The input is scanned in place with memchr; NAVs go through DecimalParser
+ * and each distinct date string is converted once.
+ */
+class NavFeedParser {
+public:
+    static NavFeed parse(const char* data, size_t size) {
+        NavFeed feed;
+        size_t estimate = size / 64;  // Shorter than a typical line, to avoid regrowing the columns
+        feed.schemeCodes.reserve(estimate);
+        feed.navs.reserve(estimate);
+        feed.days.reserve(estimate);
+
+        DateCache dates;
+        const char* end = data + size;
+        const char* line = data;
+        while (line < end) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+            if (!lineEnd) {
+                lineEnd = end;
+            }
+            parseLine(line, lineEnd, dates, feed);
+            line = lineEnd + 1;
+        }
+        return feed;
+    }
+
+    /**
+     * Parse a NAV file through a read-only memory mapping.
+     * @throws SIPSystemException if the file cannot be read
+     */
+    static NavFeed parseFile(const std::string& path) {
+        MappedFile file(path);
+        return parse(reinterpret_cast<const char*>(file.data()), file.size());
+    }
+
+    /**
+     * Day number of a "16-Oct-2026" date. Returns false if it is not one.
+     */
+    static bool parseDate(const char* first, const char* last, int& dayNumber) {
+        static const char kMonths[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+        if (last - first != 11 || first[2] != '-' || first[6] != '-') {
+            return false;
+        }
+        int day;
+        int year;
+        if (!parseDigits(first, 2, day) || !parseDigits(first + 7, 4, year)) {
+            return false;
+        }
+        int month = 0;
+        for (int m = 0; m < 12; ++m) {
+            if (std::memcmp(first + 3, kMonths + 3 * m, 3) == 0) {
+                month = m + 1;
+                break;
+            }
+        }
+        if (month == 0 || day < 1 || day > DateUtils::getDaysInMonth(year, month)) {
+            return false;
+        }
+        dayNumber = DateUtils::daysFromCivil(year, month, day);
+        return true;
+    }
+
+private:
+    /**
+     * A file carries only a handful of distinct dates, almost always in runs,
+     * so remembering the last one skips nearly all date conversions.
+     */
+    struct DateCache {
+        char text[11];
+        int dayNumber;
+        bool valid;
+
+        DateCache() : dayNumber(0), valid(false) {}
+    };
+
+    static void parseLine(const char* line, const char* lineEnd, DateCache& dates, NavFeed& feed) {
+        if (lineEnd > line && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+        size_t length = static_cast<size_t>(lineEnd - line);
+        const char* codeEnd = static_cast<const char*>(std::memchr(line, ';', length));
+        if (!codeEnd) {
+            return;  // Blank line or a category / AMC heading
+        }
+        if (startsWith(line, lineEnd, "Scheme Code")) {
+            return;  // Column header
+        }
+
+        // NAV and date are the last two fields
+        const char* dateStart = lastSeparator(codeEnd, lineEnd);
+        const char* navStart = dateStart ? lastSeparator(codeEnd, dateStart - 1) : nullptr;
+        if (!navStart || countSeparators(codeEnd + 1, navStart - 1) < 2) {
+            feed.malformedCount++;
+            return;
+        }
+
+        const char* codeStart = line;
+        trim(codeStart, codeEnd);
+        const char* navEnd = dateStart - 1;
+        trim(navStart, navEnd);
+        const char* dateEnd = lineEnd;
+        trim(dateStart, dateEnd);
+
+        int day;
+        if (!lookupDate(dateStart, dateEnd, dates, day)) {
+            feed.malformedCount++;
+            return;
+        }
+        double nav;
+        if (!DecimalParser::parse(navStart, navEnd, nav)) {
+            if (navStart == navEnd || startsWith(navStart, navEnd, "N.A.") || startsWith(navStart, navEnd, "-")) {
+                feed.unpricedCount++;
+            } else {
+                feed.malformedCount++;
+            }
+            return;
+        }
+        if (!(nav > 0)) {
+            feed.unpricedCount++;
+            return;
+        }
+
+        feed.schemeCodes.emplace_back(codeStart, static_cast<size_t>(codeEnd - codeStart));
+        feed.navs.push_back(nav);
+        feed.days.push_back(day);
+    }
+
+    static bool lookupDate(const char* first, const char* last, DateCache& dates, int& dayNumber) {
+        if (last - first == 11 && dates.valid && std::memcmp(first, dates.text, 11) == 0) {
+            dayNumber = dates.dayNumber;
+            return true;
+        }
+        if (!parseDate(first, last, dayNumber)) {
+            return false;
+        }
+        std::memcpy(dates.text, first, 11);
+        dates.dayNumber = dayNumber;
+        dates.valid = true;
+        return true;
+    }
+
+    // Start of the field after the last ';' in (first, last), or nullptr
+    static const char* lastSeparator(const char* first, const char* last) {
+        for (const char* p = last; p > first; --p) {
+            if (p[-1] == ';') {
+                return p;
+            }
+        }
+        return nullptr;
+    }
+
+    // Number of ';' in [first, last), counting no further than two
+    static int countSeparators(const char* first, const char* last) {
+        int count = 0;
+        while (count < 2 && first < last) {
+            const char* found = static_cast<const char*>(std::memchr(first, ';', static_cast<size_t>(last - first)));
+            if (!found) {
+                break;
+            }
+            count++;
+            first = found + 1;
+        }
+        return count;
+    }
+
+    static void trim(const char*& first, const char*& last) {
+        while (first < last && (*first == ' ' || *first == '\t')) {
+            ++first;
+        }
+        while (last > first && (last[-1] == ' ' || last[-1] == '\t')) {
+            --last;
+        }
+    }
+
+    static bool startsWith(const char* first, const char* last, const char* prefix) {
+        size_t length = std::strlen(prefix);
+        return static_cast<size_t>(last - first) >= length && std::memcmp(first, prefix, length) == 0;
+    }
+
+    static bool parseDigits(const char* text, int count, int& value) {
+        value = 0;
+        for (int i = 0; i < count; ++i) {
+            if (text[i] < '0' || text[i] > '9') {
+                return false;
+            }
+            value = value * 10 + (text[i] - '0');
+        }
+        return true;
+    }
+};
+
+} // namespace sip
+
+#endif // NAV_FEED_PARSER_H
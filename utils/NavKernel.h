@@ -0,0 +1,111 @@
+#ifndef NAV_KERNEL_H
+#define NAV_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIP_NAV_KERNEL_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace sip {
+
+/**
+ * Bulk NAV transforms over a contiguous NAV column (NavSnapshot::navs):
+ *
+ *   scale:        navs[i] *= factor
+ *   scaleByGroup: navs[i] *= groupFactors[groups[i]]   (e.g. one factor per category)
+ *
+ * A NAV of 0 ("no price") stays 0. As in ValuationKernel, each call picks an
+ * AVX2 implementation at runtime when the CPU supports it; both paths do one
+ * multiply per NAV, so their results are bit-identical.
+ */
+class NavKernel {
+public:
+    static void scale(double* navs, size_t count, double factor) {
+#ifdef SIP_NAV_KERNEL_AVX2
+        if (hasAvx2()) {
+            scaleAvx2(navs, count, factor);
+            return;
+        }
+#endif
+        scaleScalar(navs, count, factor);
+    }
+
+    /**
+     * Every groups[i] must be a valid index into groupFactors.
+     */
+    static void scaleByGroup(double* navs, const uint8_t* groups, size_t count, const double* groupFactors) {
+#ifdef SIP_NAV_KERNEL_AVX2
+        if (hasAvx2()) {
+            scaleByGroupAvx2(navs, groups, count, groupFactors);
+            return;
+        }
+#endif
+        scaleByGroupScalar(navs, groups, count, groupFactors);
+    }
+
+    static void scaleScalar(double* navs, size_t count, double factor) {
+        for (size_t i = 0; i < count; ++i) {
+            navs[i] *= factor;
+        }
+    }
+
+    static void scaleByGroupScalar(double* navs, const uint8_t* groups, size_t count, const double* groupFactors) {
+        for (size_t i = 0; i < count; ++i) {
+            navs[i] *= groupFactors[groups[i]];
+        }
+    }
+
+    /**
+     * Name of the implementation the kernels dispatch to.
+     */
+    static const char* implementationName() {
+#ifdef SIP_NAV_KERNEL_AVX2
+        if (hasAvx2()) {
+            return "avx2";
+        }
+#endif
+        return "scalar";
+    }
+
+#ifdef SIP_NAV_KERNEL_AVX2
+    static bool hasAvx2() {
+        static const bool supported = __builtin_cpu_supports("avx2") != 0;
+        return supported;
+    }
+
+    __attribute__((target("avx2")))
+    static void scaleAvx2(double* navs, size_t count, double factor) {
+        const __m256d factors = _mm256_set1_pd(factor);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256d low = _mm256_mul_pd(_mm256_loadu_pd(navs + i), factors);
+            __m256d high = _mm256_mul_pd(_mm256_loadu_pd(navs + i + 4), factors);
+            _mm256_storeu_pd(navs + i, low);
+            _mm256_storeu_pd(navs + i + 4, high);
+        }
+        scaleScalar(navs + i, count - i, factor);
+    }
+
+    __attribute__((target("avx2")))
+    static void scaleByGroupAvx2(double* navs, const uint8_t* groups, size_t count, const double* groupFactors) {
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            int32_t packed;
+            __builtin_memcpy(&packed, groups + i, sizeof(packed));
+            __m128i index = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+            __m256d factors = _mm256_mask_i32gather_pd(zero, groupFactors, index, allLanes, 8);
+            _mm256_storeu_pd(navs + i, _mm256_mul_pd(_mm256_loadu_pd(navs + i), factors));
+        }
+        scaleByGroupScalar(navs + i, groups + i, count - i, groupFactors);
+    }
+#endif
+};
+
+} // namespace sip
+
+#endif // NAV_KERNEL_H
@@ -0,0 +1,189 @@
+#ifndef NAV_TABLE_H
+#define NAV_TABLE_H
+
+#include "EpochDomain.h"
+#include "../models/NavSnapshot.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Concurrent NAV table indexed by fund handle (see IdInterner::funds()).
+ *
+ * Every version is an immutable NavSnapshot. Writers copy the current
+ * version, change the copy and publish it with one atomic pointer swap, so
+ * a batch of changes becomes visible all at once. Readers never lock: they
+ * load the pointer inside an EpochDomain::Guard, and a replaced version is
+ * freed by a later writer once no reader can still be looking at it.
+ *
+ * An optional publish observer sees each new version next to the one it
+ * replaced and the handles the write touched (e.g. to report which NAVs
+ * changed without comparing whole versions).
+ */
+class NavTable {
+public:
+    /**
+     * Handles a write may have changed: handles[0, count), or any handle
+     * when everything is set (whole-table transforms).
+     */
+    struct WrittenHandles {
+        const uint32_t* handles;
+        size_t count;
+        bool everything;
+
+        static WrittenHandles all() { return WrittenHandles{nullptr, 0, true}; }
+        static WrittenHandles only(const uint32_t* handles, size_t count) {
+            return WrittenHandles{handles, count, false};
+        }
+    };
+
+    typedef std::function<void(const NavSnapshot& previous, const NavSnapshot& published,
+                               const WrittenHandles& written)> PublishObserver;
+
+private:
+    struct Retired {
+        const NavSnapshot* snapshot;
+        uint64_t epoch;  // Epoch it was unlinked in
+    };
+
+    std::atomic<const NavSnapshot*> current;
+    std::mutex writeMutex;  // Serializes writers; also guards retired
+    std::vector<Retired> retired;
+    PublishObserver observer;  // Guarded by writeMutex
+
+    void publish(const NavSnapshot* next, const WrittenHandles& written) {
+        const NavSnapshot* previous = current.exchange(next);
+        retired.push_back(Retired{previous, EpochDomain::instance().advance()});
+        if (observer) {
+            observer(*previous, *next, written);  // Only writers reclaim, and this one holds the lock
+        }
+        reclaim();
+    }
+
+    template <typename Mutator>
+    void commit(Mutator& mutate, const WrittenHandles& written) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        std::unique_ptr<NavSnapshot> next(new NavSnapshot(*current.load()));
+        mutate(*next);
+        next->version++;
+        publish(next.release(), written);
+    }
+
+    void reclaim() {
+        uint64_t oldest = EpochDomain::instance().oldestActive();
+        auto reachable = std::partition(retired.begin(), retired.end(),
+            [oldest](const Retired& r) { return r.epoch >= oldest; });
+        for (auto it = reachable; it != retired.end(); ++it) {
+            delete it->snapshot;
+        }
+        retired.erase(reachable, retired.end());
+    }
+
+public:
+    NavTable() : current(new NavSnapshot()) {}
+
+    /**
+     * Frees every version; there must be no concurrent readers left.
+     */
+    ~NavTable() {
+        delete current.load();
+        for (const Retired& r : retired) {
+            delete r.snapshot;
+        }
+    }
+
+    NavTable(const NavTable&) = delete;
+    NavTable& operator=(const NavTable&) = delete;
+
+    // ---- Readers (wait-free) ----
+
+    // NAV of a fund in the current version (0 = no price)
+    double getNav(uint32_t fundHandle) const {
+        EpochDomain::Guard guard;
+        return current.load()->getNav(fundHandle);
+    }
+
+    // Number of versions published so far
+    uint64_t getVersion() const {
+        EpochDomain::Guard guard;
+        return current.load()->version;
+    }
+
+    /**
+     * Run reader(const NavSnapshot&) against one consistent version. The
+     * reference is only valid inside the call.
+     */
+    template <typename Reader>
+    void read(Reader reader) const {
+        EpochDomain::Guard guard;
+        reader(*current.load());
+    }
+
+    // Copy of the current version
+    NavSnapshot snapshot() const {
+        EpochDomain::Guard guard;
+        return *current.load();
+    }
+
+    // ---- Writers ----
+
+    /**
+     * Call observer(previous, published, written) after every version is published,
+     * under the write lock: calls arrive in version order and must not
+     * write to this table. Pass an empty function to remove it.
+     */
+    void setPublishObserver(PublishObserver publishObserver) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        observer = std::move(publishObserver);
+    }
+
+    void set(uint32_t fundHandle, double nav) {
+        update(&fundHandle, 1, [fundHandle, nav](NavSnapshot& next) { next.setNav(fundHandle, nav); });
+    }
+
+    /**
+     * Set many NAVs as one version: navs[i] belongs to fundHandles[i].
+     */
+    void setAll(const uint32_t* fundHandles, const double* navs, size_t count) {
+        update(fundHandles, count, [fundHandles, navs, count](NavSnapshot& next) {
+            uint32_t highest = 0;
+            for (size_t i = 0; i < count; ++i) {
+                highest = std::max(highest, fundHandles[i]);
+            }
+            if (count > 0 && highest >= next.navs.size()) {
+                next.navs.resize(static_cast<size_t>(highest) + 1, 0.0);
+            }
+            for (size_t i = 0; i < count; ++i) {
+                next.navs[fundHandles[i]] = navs[i];
+            }
+        });
+    }
+
+    /**
+     * Publish a new version: mutate(NavSnapshot&) edits a copy of the
+     * current one. If mutate throws, nothing is published.
+     */
+    template <typename Mutator>
+    void update(Mutator mutate) {
+        commit(mutate, WrittenHandles::all());
+    }
+
+    /**
+     * update() for a mutator that only changes the NAVs of
+     * fundHandles[0, count), which the publish observer is told.
+     */
+    template <typename Mutator>
+    void update(const uint32_t* fundHandles, size_t count, Mutator mutate) {
+        commit(mutate, WrittenHandles::only(fundHandles, count));
+    }
+};
+
+} // namespace sip
+
+#endif // NAV_TABLE_H
@@ -0,0 +1,76 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Minimal fork-join helper for batch jobs.
+ */
+class ParallelFor {
+public:
+    /**
+     * Number of worker threads to use when the caller asks for 0 (= "all cores").
+     */
+    static unsigned resolveThreadCount(unsigned requested) {
+        if (requested > 0) {
+            return requested;
+        }
+        unsigned hardware = std::thread::hardware_concurrency();
+        return hardware > 0 ? hardware : 1;
+    }
+
+    /**
+     * Split [0, count) into one contiguous chunk per thread and run
+     * body(chunkIndex, begin, end) on each. The calling thread runs the
+     * first chunk itself. The first exception thrown by any chunk is
+     * rethrown after all threads have joined.
+     */
+    template <typename Body>
+    static void run(size_t count, unsigned threadCount, Body body) {
+        unsigned threads = static_cast<unsigned>(std::min<size_t>(
+            resolveThreadCount(threadCount), std::max<size_t>(count, 1)));
+        if (threads <= 1) {
+            body(0u, static_cast<size_t>(0), count);
+            return;
+        }
+
+        std::vector<std::exception_ptr> errors(threads);
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        size_t chunk = (count + threads - 1) / threads;
+        for (unsigned t = 1; t < threads; ++t) {
+            size_t begin = std::min(count, t * chunk);
+            size_t end = std::min(count, begin + chunk);
+            workers.emplace_back([&body, &errors, t, begin, end]() {
+                try {
+                    body(t, begin, end);
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        try {
+            body(0u, static_cast<size_t>(0), std::min(count, chunk));
+        } catch (...) {
+            errors[0] = std::current_exception();
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+};
+
+} // namespace sip
+
+#endif // PARALLEL_FOR_H
@@ -0,0 +1,437 @@
+#ifndef PATH_KERNEL_H
+#define PATH_KERNEL_H
+
+#include "Philox.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIP_PATH_KERNEL_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace sip {
+
+/**
+ * One time step of a block of lognormal (GBM) paths:
+ *
+ *   z                = standard normal from Box-Muller on (radiusUniform, angleUniform)
+ *   values[i] = (values[i] + installment) * exp(drift + diffusion * z)
+ *
+ * Each uniform pair yields two normals (r cos t and r sin t), so a step over
+ * 2 * pairs paths consumes pairs uniform pairs: path k < pairs uses the
+ * cosine and path pairs + k the sine of pair k.
+ *
+ * exp, log and sin/cos are evaluated with the kernel's own range reduction
+ * and polynomials (about 1e-15 relative error) rather than libm, so the same
+ * arithmetic can run four lanes at a time. advance() picks the AVX2
+ * implementation at runtime when the CPU supports it; the scalar version
+ * performs the same IEEE operations in the same order, so both produce
+ * bit-identical paths.
+ */
+class PathKernel {
+public:
+    struct Step {
+        size_t pairs;
+        const double* radiusUniforms;  // pairs values in (0, 1)
+        const double* angleUniforms;   // pairs values in (0, 1)
+        double installment;
+        double drift;
+        double diffusion;
+        double* values;                // 2 * pairs path values, updated in place
+    };
+
+    /**
+     * Uniforms for one step of quads * 4 paths, from Philox blocks
+     * (firstQuad + q, step) under key. Fills 2 * quads entries of each array:
+     * block q supplies pair q (words 0 and 1) and pair quads + q (words 2 and 3).
+     */
+    static void fillUniforms(uint64_t firstQuad, size_t quads, uint64_t step, uint64_t key,
+                             double* radiusUniforms, double* angleUniforms) {
+#ifdef SIP_PATH_KERNEL_AVX2
+        if (hasAvx2()) {
+            fillUniformsAvx2(firstQuad, quads, step, key, radiusUniforms, angleUniforms);
+            return;
+        }
+#endif
+        fillUniformsScalar(firstQuad, quads, step, key, radiusUniforms, angleUniforms, 0);
+    }
+
+    static void fillUniformsScalar(uint64_t firstQuad, size_t quads, uint64_t step, uint64_t key,
+                                   double* radiusUniforms, double* angleUniforms, size_t first) {
+        for (size_t q = first; q < quads; ++q) {
+            Philox4x32::Block block = Philox4x32::generate(firstQuad + q, step, key);
+            radiusUniforms[q] = Philox4x32::toUniform(block.v[0]);
+            angleUniforms[q] = Philox4x32::toUniform(block.v[1]);
+            radiusUniforms[quads + q] = Philox4x32::toUniform(block.v[2]);
+            angleUniforms[quads + q] = Philox4x32::toUniform(block.v[3]);
+        }
+    }
+
+    static void advance(const Step& step) {
+#ifdef SIP_PATH_KERNEL_AVX2
+        if (hasAvx2()) {
+            advanceAvx2(step);
+            return;
+        }
+#endif
+        advanceScalar(step, 0);
+    }
+
+    /**
+     * Scalar implementation, starting at pair `first` (the AVX2 version uses
+     * it for its tail).
+     */
+    static void advanceScalar(const Step& s, size_t first) {
+        for (size_t k = first; k < s.pairs; ++k) {
+            double radius = std::sqrt(-2.0 * logScalar(s.radiusUniforms[k]));
+            double sine, cosine;
+            sinCosTwoPiScalar(s.angleUniforms[k], sine, cosine);
+            double& a = s.values[k];
+            double& b = s.values[s.pairs + k];
+            a = (a + s.installment) * expScalar(s.drift + s.diffusion * (radius * cosine));
+            b = (b + s.installment) * expScalar(s.drift + s.diffusion * (radius * sine));
+        }
+    }
+
+    /**
+     * Name of the implementation advance() dispatches to.
+     */
+    static const char* implementationName() {
+#ifdef SIP_PATH_KERNEL_AVX2
+        if (hasAvx2()) {
+            return "avx2";
+        }
+#endif
+        return "scalar";
+    }
+
+    static double expScalar(double x) {
+        x = x < kExpMin ? kExpMin : (x > kExpMax ? kExpMax : x);
+        double shifted = x * kLog2E + kRoundMagic;
+        double n = shifted - kRoundMagic;
+        double r = (x - n * kLn2High) - n * kLn2Low;
+        // Taylor series of exp(r) for |r| <= ln(2)/2
+        double p = 1.0 / 479001600.0;
+        p = p * r + 1.0 / 39916800.0;
+        p = p * r + 1.0 / 3628800.0;
+        p = p * r + 1.0 / 362880.0;
+        p = p * r + 1.0 / 40320.0;
+        p = p * r + 1.0 / 5040.0;
+        p = p * r + 1.0 / 720.0;
+        p = p * r + 1.0 / 120.0;
+        p = p * r + 1.0 / 24.0;
+        p = p * r + 1.0 / 6.0;
+        p = p * r + 0.5;
+        p = p * r + 1.0;
+        p = p * r + 1.0;
+        int64_t exponent = bitsOf(shifted) - bitsOf(kRoundMagic);
+        return p * doubleOf(static_cast<uint64_t>(exponent + 1023) << 52);
+    }
+
+    // Natural log of a positive, normal x
+    static double logScalar(double x) {
+        uint64_t bits = bitsOfUnsigned(x);
+        double exponent = static_cast<double>(static_cast<int64_t>(bits >> 52) - 1023);
+        double mantissa = doubleOf((bits & kMantissaMask) | kOneBits);
+        if (mantissa > kSqrt2) {
+            mantissa = mantissa * 0.5;
+            exponent = exponent + 1.0;
+        }
+        double s = (mantissa - 1.0) / (mantissa + 1.0);
+        double s2 = s * s;
+        // log(m) = 2s * (1 + s^2/3 + s^4/5 + ... + s^20/21)
+        double p = 1.0 / 21.0;
+        p = p * s2 + 1.0 / 19.0;
+        p = p * s2 + 1.0 / 17.0;
+        p = p * s2 + 1.0 / 15.0;
+        p = p * s2 + 1.0 / 13.0;
+        p = p * s2 + 1.0 / 11.0;
+        p = p * s2 + 1.0 / 9.0;
+        p = p * s2 + 1.0 / 7.0;
+        p = p * s2 + 1.0 / 5.0;
+        p = p * s2 + 1.0 / 3.0;
+        p = p * s2 + 1.0;
+        return exponent * kLn2 + 2.0 * s * p;
+    }
+
+    // sin(2 pi u) and cos(2 pi u); reduction to [-pi/4, pi/4] is exact in u
+    static void sinCosTwoPiScalar(double u, double& sine, double& cosine) {
+        double shifted = u * 4.0 + kRoundMagic;
+        double quadrant = shifted - kRoundMagic;
+        int64_t q = bitsOf(shifted) - bitsOf(kRoundMagic);
+        double x = (u - quadrant * 0.25) * kTwoPi;
+        double s, c;
+        sinCosPolynomial(x, s, c);
+        if (q & 1) {
+            double t = s;
+            s = c;
+            c = t;
+        }
+        sine = (q & 2) ? -s : s;
+        cosine = ((q + 1) & 2) ? -c : c;
+    }
+
+#ifdef SIP_PATH_KERNEL_AVX2
+    static bool hasAvx2() {
+        static const bool supported = __builtin_cpu_supports("avx2") != 0;
+        return supported;
+    }
+
+    /**
+     * Eight Philox blocks per iteration, one per 32-bit lane.
+     */
+    __attribute__((target("avx2")))
+    static void fillUniformsAvx2(uint64_t firstQuad, size_t quads, uint64_t step, uint64_t key,
+                                 double* radiusUniforms, double* angleUniforms) {
+        const __m256i multiplier0 = _mm256_set1_epi32(static_cast<int>(0xD2511F53u));
+        const __m256i multiplier1 = _mm256_set1_epi32(static_cast<int>(0xCD9E8D57u));
+        const __m256i stepLow = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(step)));
+        const __m256i stepHigh = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(step >> 32)));
+        size_t q = 0;
+        for (; q + 8 <= quads; q += 8) {
+            uint32_t low[8], high[8];
+            for (int lane = 0; lane < 8; ++lane) {
+                uint64_t counter = firstQuad + q + static_cast<uint64_t>(lane);
+                low[lane] = static_cast<uint32_t>(counter);
+                high[lane] = static_cast<uint32_t>(counter >> 32);
+            }
+            __m256i c0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(low));
+            __m256i c1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(high));
+            __m256i c2 = stepLow;
+            __m256i c3 = stepHigh;
+            uint32_t key0 = static_cast<uint32_t>(key);
+            uint32_t key1 = static_cast<uint32_t>(key >> 32);
+            for (int round = 0; round < 10; ++round) {
+                __m256i hi0, lo0, hi1, lo1;
+                mulHiLoAvx2(multiplier0, c0, hi0, lo0);
+                mulHiLoAvx2(multiplier1, c2, hi1, lo1);
+                c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(static_cast<int>(key0)));
+                c1 = lo1;
+                c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(static_cast<int>(key1)));
+                c3 = lo0;
+                key0 += 0x9E3779B9u;
+                key1 += 0xBB67AE85u;
+            }
+            storeUniformsAvx2(c0, radiusUniforms + q);
+            storeUniformsAvx2(c1, angleUniforms + q);
+            storeUniformsAvx2(c2, radiusUniforms + quads + q);
+            storeUniformsAvx2(c3, angleUniforms + quads + q);
+        }
+        fillUniformsScalar(firstQuad, quads, step, key, radiusUniforms, angleUniforms, q);
+    }
+
+    __attribute__((target("avx2")))
+    static void advanceAvx2(const Step& s) {
+        const __m256d installment = _mm256_set1_pd(s.installment);
+        const __m256d drift = _mm256_set1_pd(s.drift);
+        const __m256d diffusion = _mm256_set1_pd(s.diffusion);
+        const __m256d minusTwo = _mm256_set1_pd(-2.0);
+        size_t k = 0;
+        for (; k + 4 <= s.pairs; k += 4) {
+            __m256d radius = _mm256_sqrt_pd(_mm256_mul_pd(minusTwo, logAvx2(_mm256_loadu_pd(s.radiusUniforms + k))));
+            __m256d sine, cosine;
+            sinCosTwoPiAvx2(_mm256_loadu_pd(s.angleUniforms + k), sine, cosine);
+
+            double* a = s.values + k;
+            double* b = s.values + s.pairs + k;
+            __m256d growthA = expAvx2(_mm256_add_pd(drift, _mm256_mul_pd(diffusion, _mm256_mul_pd(radius, cosine))));
+            __m256d growthB = expAvx2(_mm256_add_pd(drift, _mm256_mul_pd(diffusion, _mm256_mul_pd(radius, sine))));
+            _mm256_storeu_pd(a, _mm256_mul_pd(_mm256_add_pd(_mm256_loadu_pd(a), installment), growthA));
+            _mm256_storeu_pd(b, _mm256_mul_pd(_mm256_add_pd(_mm256_loadu_pd(b), installment), growthB));
+        }
+        advanceScalar(s, k);
+    }
+#endif
+
+private:
+    static constexpr double kExpMin = -708.0;
+    static constexpr double kExpMax = 709.0;
+    static constexpr double kRoundMagic = 6755399441055744.0;  // 1.5 * 2^52: x + magic rounds x to an integer
+    static constexpr double kLog2E = 1.4426950408889634;
+    static constexpr double kLn2 = 0.6931471805599453;
+    static constexpr double kLn2High = 6.93147180369123816490e-01;
+    static constexpr double kLn2Low = 1.90821492927058770002e-10;
+    static constexpr double kSqrt2 = 1.4142135623730951;
+    static constexpr double kTwoPi = 6.283185307179586;
+    static const uint64_t kMantissaMask = 0x000FFFFFFFFFFFFFULL;
+    static const uint64_t kOneBits = 0x3FF0000000000000ULL;
+
+    static uint64_t bitsOfUnsigned(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static int64_t bitsOf(double value) {
+        return static_cast<int64_t>(bitsOfUnsigned(value));
+    }
+
+    static double doubleOf(uint64_t bits) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Taylor series of sin and cos for |x| <= pi/4
+    static void sinCosPolynomial(double x, double& sine, double& cosine) {
+        double x2 = x * x;
+        double s = -1.0 / 121645100408832000.0;  // -1/19!
+        s = s * x2 + 1.0 / 355687428096000.0;
+        s = s * x2 - 1.0 / 1307674368000.0;
+        s = s * x2 + 1.0 / 6227020800.0;
+        s = s * x2 - 1.0 / 39916800.0;
+        s = s * x2 + 1.0 / 362880.0;
+        s = s * x2 - 1.0 / 5040.0;
+        s = s * x2 + 1.0 / 120.0;
+        s = s * x2 - 1.0 / 6.0;
+        s = s * x2 + 1.0;
+        double c = -1.0 / 6402373705728000.0;  // -1/18!
+        c = c * x2 + 1.0 / 20922789888000.0;
+        c = c * x2 - 1.0 / 87178291200.0;
+        c = c * x2 + 1.0 / 479001600.0;
+        c = c * x2 - 1.0 / 3628800.0;
+        c = c * x2 + 1.0 / 40320.0;
+        c = c * x2 - 1.0 / 720.0;
+        c = c * x2 + 1.0 / 24.0;
+        c = c * x2 - 0.5;
+        c = c * x2 + 1.0;
+        sine = x * s;
+        cosine = c;
+    }
+
+#ifdef SIP_PATH_KERNEL_AVX2
+    // Full 32x32 -> 64 bit products of each lane, split into high and low words
+    __attribute__((target("avx2")))
+    static void mulHiLoAvx2(__m256i multiplier, __m256i x, __m256i& high, __m256i& low) {
+        __m256i even = _mm256_mul_epu32(x, multiplier);
+        __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), multiplier);
+        high = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+        low = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    }
+
+    // Philox4x32::toUniform of eight lanes: (bits + 0.5) / 2^32, exact conversion via the sign flip
+    __attribute__((target("avx2")))
+    static void storeUniformsAvx2(__m256i bits, double* out) {
+        const __m256i signBit = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+        const __m256d offset = _mm256_set1_pd(2147483648.0);
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d scale = _mm256_set1_pd(1.0 / 4294967296.0);
+        __m256i flipped = _mm256_xor_si256(bits, signBit);
+        __m256d lowLanes = _mm256_add_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(flipped)), offset);
+        __m256d highLanes = _mm256_add_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(flipped, 1)), offset);
+        _mm256_storeu_pd(out, _mm256_mul_pd(_mm256_add_pd(lowLanes, half), scale));
+        _mm256_storeu_pd(out + 4, _mm256_mul_pd(_mm256_add_pd(highLanes, half), scale));
+    }
+
+    __attribute__((target("avx2")))
+    static __m256d expAvx2(__m256d x) {
+        const __m256d magic = _mm256_set1_pd(kRoundMagic);
+        x = _mm256_min_pd(_mm256_max_pd(x, _mm256_set1_pd(kExpMin)), _mm256_set1_pd(kExpMax));
+        __m256d shifted = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(kLog2E)), magic);
+        __m256d n = _mm256_sub_pd(shifted, magic);
+        __m256d r = _mm256_sub_pd(_mm256_sub_pd(x, _mm256_mul_pd(n, _mm256_set1_pd(kLn2High))),
+                                  _mm256_mul_pd(n, _mm256_set1_pd(kLn2Low)));
+        __m256d p = _mm256_set1_pd(1.0 / 479001600.0);
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.0 / 39916800.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.0 / 3628800.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.0 / 362880.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.0 / 40320.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.0 / 5040.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.0 / 720.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.0 / 120.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.0 / 24.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.0 / 6.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(0.5));
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(1.0));
+        __m256i exponent = _mm256_sub_epi64(_mm256_castpd_si256(shifted), _mm256_castpd_si256(magic));
+        __m256i scaleBits = _mm256_slli_epi64(_mm256_add_epi64(exponent, _mm256_set1_epi64x(1023)), 52);
+        return _mm256_mul_pd(p, _mm256_castsi256_pd(scaleBits));
+    }
+
+    __attribute__((target("avx2")))
+    static __m256d logAvx2(__m256d x) {
+        const __m256d magic = _mm256_set1_pd(kRoundMagic);
+        const __m256d one = _mm256_set1_pd(1.0);
+        __m256i bits = _mm256_castpd_si256(x);
+        // Biased exponent to double: bits of (magic + e) minus (magic + 1023)
+        __m256i biased = _mm256_srli_epi64(bits, 52);
+        __m256d exponent = _mm256_sub_pd(
+            _mm256_castsi256_pd(_mm256_add_epi64(_mm256_castpd_si256(magic), biased)),
+            _mm256_add_pd(magic, _mm256_set1_pd(1023.0)));
+        __m256d mantissa = _mm256_castsi256_pd(_mm256_or_si256(
+            _mm256_and_si256(bits, _mm256_set1_epi64x(static_cast<long long>(kMantissaMask))),
+            _mm256_set1_epi64x(static_cast<long long>(kOneBits))));
+        __m256d high = _mm256_cmp_pd(mantissa, _mm256_set1_pd(kSqrt2), _CMP_GT_OQ);
+        mantissa = _mm256_blendv_pd(mantissa, _mm256_mul_pd(mantissa, _mm256_set1_pd(0.5)), high);
+        exponent = _mm256_add_pd(exponent, _mm256_and_pd(one, high));
+
+        __m256d s = _mm256_div_pd(_mm256_sub_pd(mantissa, one), _mm256_add_pd(mantissa, one));
+        __m256d s2 = _mm256_mul_pd(s, s);
+        __m256d p = _mm256_set1_pd(1.0 / 21.0);
+        p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(1.0 / 19.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(1.0 / 17.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(1.0 / 15.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(1.0 / 13.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(1.0 / 11.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(1.0 / 9.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(1.0 / 7.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(1.0 / 5.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(1.0 / 3.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, s2), _mm256_set1_pd(1.0));
+        return _mm256_add_pd(_mm256_mul_pd(exponent, _mm256_set1_pd(kLn2)),
+                             _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), s), p));
+    }
+
+    __attribute__((target("avx2")))
+    static void sinCosTwoPiAvx2(__m256d u, __m256d& sine, __m256d& cosine) {
+        const __m256d magic = _mm256_set1_pd(kRoundMagic);
+        __m256d shifted = _mm256_add_pd(_mm256_mul_pd(u, _mm256_set1_pd(4.0)), magic);
+        __m256d quadrant = _mm256_sub_pd(shifted, magic);
+        __m256i q = _mm256_sub_epi64(_mm256_castpd_si256(shifted), _mm256_castpd_si256(magic));
+        __m256d x = _mm256_mul_pd(_mm256_sub_pd(u, _mm256_mul_pd(quadrant, _mm256_set1_pd(0.25))),
+                                  _mm256_set1_pd(kTwoPi));
+
+        __m256d x2 = _mm256_mul_pd(x, x);
+        __m256d s = _mm256_set1_pd(-1.0 / 121645100408832000.0);
+        s = _mm256_add_pd(_mm256_mul_pd(s, x2), _mm256_set1_pd(1.0 / 355687428096000.0));
+        s = _mm256_sub_pd(_mm256_mul_pd(s, x2), _mm256_set1_pd(1.0 / 1307674368000.0));
+        s = _mm256_add_pd(_mm256_mul_pd(s, x2), _mm256_set1_pd(1.0 / 6227020800.0));
+        s = _mm256_sub_pd(_mm256_mul_pd(s, x2), _mm256_set1_pd(1.0 / 39916800.0));
+        s = _mm256_add_pd(_mm256_mul_pd(s, x2), _mm256_set1_pd(1.0 / 362880.0));
+        s = _mm256_sub_pd(_mm256_mul_pd(s, x2), _mm256_set1_pd(1.0 / 5040.0));
+        s = _mm256_add_pd(_mm256_mul_pd(s, x2), _mm256_set1_pd(1.0 / 120.0));
+        s = _mm256_sub_pd(_mm256_mul_pd(s, x2), _mm256_set1_pd(1.0 / 6.0));
+        s = _mm256_add_pd(_mm256_mul_pd(s, x2), _mm256_set1_pd(1.0));
+        __m256d c = _mm256_set1_pd(-1.0 / 6402373705728000.0);
+        c = _mm256_add_pd(_mm256_mul_pd(c, x2), _mm256_set1_pd(1.0 / 20922789888000.0));
+        c = _mm256_sub_pd(_mm256_mul_pd(c, x2), _mm256_set1_pd(1.0 / 87178291200.0));
+        c = _mm256_add_pd(_mm256_mul_pd(c, x2), _mm256_set1_pd(1.0 / 479001600.0));
+        c = _mm256_sub_pd(_mm256_mul_pd(c, x2), _mm256_set1_pd(1.0 / 3628800.0));
+        c = _mm256_add_pd(_mm256_mul_pd(c, x2), _mm256_set1_pd(1.0 / 40320.0));
+        c = _mm256_sub_pd(_mm256_mul_pd(c, x2), _mm256_set1_pd(1.0 / 720.0));
+        c = _mm256_add_pd(_mm256_mul_pd(c, x2), _mm256_set1_pd(1.0 / 24.0));
+        c = _mm256_sub_pd(_mm256_mul_pd(c, x2), _mm256_set1_pd(0.5));
+        c = _mm256_add_pd(_mm256_mul_pd(c, x2), _mm256_set1_pd(1.0));
+        s = _mm256_mul_pd(x, s);
+
+        // Odd quadrants swap sine and cosine; signs flip in quadrants 2-3 (sine) and 1-2 (cosine)
+        __m256d swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(
+            _mm256_and_si256(q, _mm256_set1_epi64x(1)), _mm256_set1_epi64x(1)));
+        __m256d swappedSine = _mm256_blendv_pd(s, c, swap);
+        __m256d swappedCosine = _mm256_blendv_pd(c, s, swap);
+        __m256i sineSign = _mm256_slli_epi64(_mm256_and_si256(q, _mm256_set1_epi64x(2)), 62);
+        __m256i cosineSign = _mm256_slli_epi64(
+            _mm256_and_si256(_mm256_add_epi64(q, _mm256_set1_epi64x(1)), _mm256_set1_epi64x(2)), 62);
+        sine = _mm256_xor_pd(swappedSine, _mm256_castsi256_pd(sineSign));
+        cosine = _mm256_xor_pd(swappedCosine, _mm256_castsi256_pd(cosineSign));
+    }
+#endif
+};
+
+} // namespace sip
+
+#endif // PATH_KERNEL_H
@@ -0,0 +1,121 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <cmath>
+#include <cstdint>
+
+namespace sip {
+
+/**
+ * Philox4x32-10 counter-based random number generator (Salmon et al.,
+ * "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11).
+ *
+ * Output is a pure function of (counter, key): any thread can produce the
+ * numbers for any position of any stream directly, without sharing or
+ * advancing state. Simulations derive the counter from what they are
+ * computing (path, step, ...) so results do not depend on how work is split
+ * across threads.
+ */
+class Philox4x32 {
+public:
+    struct Block {
+        uint32_t v[4];
+    };
+
+    static Block generate(Block counter, uint32_t key0, uint32_t key1) {
+        for (int round = 0; round < 10; ++round) {
+            uint64_t product0 = static_cast<uint64_t>(0xD2511F53u) * counter.v[0];
+            uint64_t product1 = static_cast<uint64_t>(0xCD9E8D57u) * counter.v[2];
+            uint32_t hi0 = static_cast<uint32_t>(product0 >> 32), lo0 = static_cast<uint32_t>(product0);
+            uint32_t hi1 = static_cast<uint32_t>(product1 >> 32), lo1 = static_cast<uint32_t>(product1);
+            Block next;
+            next.v[0] = hi1 ^ counter.v[1] ^ key0;
+            next.v[1] = lo1;
+            next.v[2] = hi0 ^ counter.v[3] ^ key1;
+            next.v[3] = lo0;
+            counter = next;
+            key0 += 0x9E3779B9u;
+            key1 += 0xBB67AE85u;
+        }
+        return counter;
+    }
+
+    static Block generate(uint64_t counterLow, uint64_t counterHigh, uint64_t key) {
+        Block counter;
+        counter.v[0] = static_cast<uint32_t>(counterLow);
+        counter.v[1] = static_cast<uint32_t>(counterLow >> 32);
+        counter.v[2] = static_cast<uint32_t>(counterHigh);
+        counter.v[3] = static_cast<uint32_t>(counterHigh >> 32);
+        return generate(counter, static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32));
+    }
+
+    /**
+     * Map 32 random bits to a double in (0, 1) - never exactly 0 or 1.
+     */
+    static double toUniform(uint32_t bits) {
+        return (static_cast<double>(bits) + 0.5) * (1.0 / 4294967296.0);
+    }
+
+    /**
+     * Four standard normal variates from one block (Box-Muller on two pairs).
+     */
+    static void toNormals(const Block& block, double* out) {
+        static const double kTwoPi = 6.283185307179586;
+        for (int pair = 0; pair < 2; ++pair) {
+            double radius = std::sqrt(-2.0 * std::log(toUniform(block.v[2 * pair])));
+            double angle = kTwoPi * toUniform(block.v[2 * pair + 1]);
+            out[2 * pair] = radius * std::cos(angle);
+            out[2 * pair + 1] = radius * std::sin(angle);
+        }
+    }
+};
+
+/**
+ * Sequential view of one Philox stream, for code that just wants "the next
+ * number". Streams with different (seed, streamId) never overlap.
+ */
+class PhiloxStream {
+private:
+    uint64_t key;
+    uint64_t streamId;
+    uint64_t counter;
+    Philox4x32::Block buffer;
+    int available;
+
+public:
+    explicit PhiloxStream(uint64_t seed = 0, uint64_t streamId = 0)
+        : key(seed), streamId(streamId), counter(0), available(0) {}
+
+    uint32_t nextUInt32() {
+        if (available == 0) {
+            buffer = Philox4x32::generate(counter++, streamId, key);
+            available = 4;
+        }
+        return buffer.v[4 - available--];
+    }
+
+    uint64_t nextUInt64() {
+        uint64_t high = nextUInt32();
+        return (high << 32) | nextUInt32();
+    }
+
+    // Uniform double in (0, 1)
+    double nextUniform() {
+        return Philox4x32::toUniform(nextUInt32());
+    }
+
+    // Uniform double in [low, high)
+    double nextUniform(double low, double high) {
+        return low + (high - low) * nextUniform();
+    }
+
+    // Standard normal variate (Box-Muller; the second value of each pair is discarded)
+    double nextNormal() {
+        double radius = std::sqrt(-2.0 * std::log(nextUniform()));
+        return radius * std::cos(6.283185307179586 * nextUniform());
+    }
+};
+
+} // namespace sip
+
+#endif // PHILOX_H
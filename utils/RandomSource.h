@@ -0,0 +1,121 @@
+#ifndef RANDOM_SOURCE_H
+#define RANDOM_SOURCE_H
+
+#include "Philox.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Seedable source of independent Philox streams, shared by the mock services
+ * (price fluctuation, payment outcomes).
+ *
+ * Every thread draws from its own stream, so draws never contend on shared
+ * generator state. A thread that has not been bound gets the next unused
+ * stream on its first draw: single-threaded runs are reproducible from the
+ * seed alone. Parallel runs that must be reproducible bind each worker to a
+ * fixed stream (e.g. its chunk index) with bindThread, so the numbers a
+ * worker sees do not depend on which thread happened to start first.
+ */
+class RandomSource {
+private:
+    // Streams handed out on first use, kept apart from the ones callers bind
+    static const uint64_t kUnboundStreamBase = 1ULL << 63;
+
+    struct ThreadStream {
+        uint64_t sourceId;
+        std::weak_ptr<const void> owner;  // Expires with the source
+        PhiloxStream stream;
+    };
+
+    uint64_t seed;
+    uint64_t sourceId;  // Key of this source's per-thread streams (addresses may be reused)
+    std::shared_ptr<const void> lifetime;  // Lets threads drop streams of destroyed sources
+    std::atomic<uint64_t> nextUnboundStream;
+
+    static std::vector<ThreadStream>& threadStreams() {
+        static thread_local std::vector<ThreadStream> streams;
+        return streams;
+    }
+
+    static uint64_t nextSourceId() {
+        static std::atomic<uint64_t> next(1);
+        return next.fetch_add(1);
+    }
+
+    PhiloxStream* findThreadStream() {
+        for (ThreadStream& entry : threadStreams()) {
+            if (entry.sourceId == sourceId) {
+                return &entry.stream;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Add a stream for the calling thread, first dropping the thread's
+     * streams of sources that no longer exist, so the list holds at most
+     * one entry per live source.
+     */
+    PhiloxStream& addThreadStream(uint64_t streamId) {
+        std::vector<ThreadStream>& streams = threadStreams();
+        streams.erase(std::remove_if(streams.begin(), streams.end(),
+                                     [](const ThreadStream& entry) { return entry.owner.expired(); }),
+                      streams.end());
+        streams.push_back(ThreadStream{sourceId, lifetime, PhiloxStream(seed, streamId)});
+        return streams.back().stream;
+    }
+
+public:
+    explicit RandomSource(uint64_t seed = randomSeed())
+        : seed(seed), sourceId(nextSourceId()), lifetime(std::make_shared<char>(0)),
+          nextUnboundStream(kUnboundStreamBase) {}
+
+    RandomSource(const RandomSource&) = delete;
+    RandomSource& operator=(const RandomSource&) = delete;
+
+    /**
+     * A fresh seed from std::random_device, for runs that need not be reproducible.
+     */
+    static uint64_t randomSeed() {
+        std::random_device device;
+        return (static_cast<uint64_t>(device()) << 32) | device();
+    }
+
+    uint64_t getSeed() const {
+        return seed;
+    }
+
+    /**
+     * The calling thread's stream (assigned on first use unless bound).
+     */
+    PhiloxStream& threadStream() {
+        PhiloxStream* stream = findThreadStream();
+        if (stream) {
+            return *stream;
+        }
+        return addThreadStream(nextUnboundStream.fetch_add(1));
+    }
+
+    /**
+     * Make the calling thread draw from stream streamId, from its start.
+     * @param streamId Any value below 2^63
+     */
+    void bindThread(uint64_t streamId) {
+        PhiloxStream* stream = findThreadStream();
+        if (stream) {
+            *stream = PhiloxStream(seed, streamId);
+        } else {
+            addThreadStream(streamId);
+        }
+    }
+};
+
+} // namespace sip
+
+#endif // RANDOM_SOURCE_H
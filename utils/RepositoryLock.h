@@ -0,0 +1,34 @@
+#ifndef REPOSITORY_LOCK_H
+#define REPOSITORY_LOCK_H
+
+#include <memory>
+#include <mutex>
+
+namespace sip {
+
+/**
+ * Optional repository lock (see SIPScheduler::getRepositoryMutex).
+ * Services constructed without one run unlocked, as before.
+ */
+class RepositoryLock {
+public:
+    /**
+     * Lock mutex if it is set; otherwise return a lock that owns nothing.
+     */
+    static std::unique_lock<std::mutex> acquire(const std::shared_ptr<std::mutex>& mutex) {
+        return mutex ? std::unique_lock<std::mutex>(*mutex) : std::unique_lock<std::mutex>();
+    }
+
+    /**
+     * Unlock early a lock from acquire (unique_lock::unlock throws when it owns nothing).
+     */
+    static void release(std::unique_lock<std::mutex>& lock) {
+        if (lock.owns_lock()) {
+            lock.unlock();
+        }
+    }
+};
+
+} // namespace sip
+
+#endif // REPOSITORY_LOCK_H
@@ -0,0 +1,89 @@
+#ifndef STATEMENT_WRITER_H
+#define STATEMENT_WRITER_H
+
+#include "ChunkedWriter.h"
+#include "../models/Transaction.h"
+#include <ostream>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Streams transaction statements as CSV.
+ * Rows are formatted into one reusable chunk buffer (ChunkedWriter) that is
+ * handed to the stream in large writes, so exporting a statement allocates
+ * once up front regardless of the number of rows.
+ */
+class StatementWriter {
+private:
+    ChunkedWriter chunks;
+    size_t rowCount;
+
+    // Statements are date-ordered, so consecutive rows usually share a date
+    Date lastDate;
+    char lastDateText[16];
+    size_t lastDateLength;
+
+public:
+    /**
+     * Constructor.
+     * @param out Destination stream
+     * @param chunkSize Bytes buffered between writes to the stream
+     */
+    explicit StatementWriter(std::ostream& out, size_t chunkSize = 64 * 1024)
+        : chunks(out, chunkSize),
+          rowCount(0),
+          lastDateLength(0) {}
+
+    StatementWriter(const StatementWriter&) = delete;
+    StatementWriter& operator=(const StatementWriter&) = delete;
+
+    void writeHeader() {
+        chunks.writeRecord([](BufferWriter& writer) {
+            writer.append("date,transactionId,sipId,type,status,amount,units,nav\n");
+        });
+    }
+
+    void writeTransaction(const Transaction& txn) {
+        chunks.writeRecord([this, &txn](BufferWriter& writer) {
+            appendDate(writer, txn.getDate());
+            writer.append(',')
+                  .append(txn.getId()).append(',')
+                  .append(txn.getSipId()).append(',')
+                  .append(sip::toName(txn.getType())).append(',')
+                  .append(sip::toName(txn.getStatus())).append(',')
+                  .appendFixed(txn.getAmount(), 2).append(',')
+                  .appendFixed(txn.getUnits(), 4).append(',')
+                  .appendFixed(txn.getNav(), 4).append('\n');
+        });
+        ++rowCount;
+    }
+
+    void writeTransactions(const std::vector<Transaction>& transactions) {
+        for (const auto& txn : transactions) {
+            writeTransaction(txn);
+        }
+    }
+
+    /**
+     * Hand buffered rows to the stream.
+     */
+    void flush() {
+        chunks.flush();
+    }
+
+    size_t getRowCount() const { return rowCount; }
+
+private:
+    void appendDate(BufferWriter& writer, Date date) {
+        if (lastDateLength == 0 || date != lastDate) {
+            lastDate = date;
+            lastDateLength = DateUtils::formatDate(date, lastDateText, sizeof(lastDateText));
+        }
+        writer.append(lastDateText, lastDateLength);
+    }
+};
+
+} // namespace sip
+
+#endif // STATEMENT_WRITER_H
@@ -0,0 +1,133 @@
+#ifndef STEP_UP_ENGINE_H
+#define STEP_UP_ENGINE_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sip {
+
+/**
+ * Step-up SIP arithmetic shared by the scheduler and services.
+ *
+ * Installment n of a step-up SIP is baseAmount * (1 + r)^(n - 1), where r is
+ * stepUpPercentage / 100. Growth factors (1 + r)^k are cached in one table per
+ * distinct step-up rate, and cumulative totals use the closed-form geometric
+ * series, so both are O(1) per call.
+ */
+class StepUpEngine {
+public:
+    static const int kTableSize = 1200;       // Factors cached per rate: (1+r)^0 .. (1+r)^1199
+    static const size_t kMaxCachedRates = 1024;
+
+    /**
+     * Amount of the given installment (1-based).
+     * Formula: baseAmount * (1 + stepUpPercentage/100)^(installmentNumber - 1)
+     */
+    static double steppedUpAmount(double baseAmount, double stepUpPercentage, int installmentNumber) {
+        if (stepUpPercentage <= 0 || installmentNumber <= 1) {
+            return baseAmount;
+        }
+        return baseAmount * growthFactor(stepUpPercentage, installmentNumber - 1);
+    }
+
+    /**
+     * Total paid over installments 1..installments (closed form).
+     * Formula: baseAmount * ((1 + r)^n - 1) / r, or baseAmount * n when r = 0
+     */
+    static double cumulativeAmount(double baseAmount, double stepUpPercentage, int installments) {
+        if (installments <= 0) {
+            return 0.0;
+        }
+        if (stepUpPercentage <= 0) {
+            return baseAmount * installments;
+        }
+        double rate = stepUpPercentage / 100.0;
+        return baseAmount * (growthFactor(stepUpPercentage, installments) - 1.0) / rate;
+    }
+
+    /**
+     * Total paid over installments firstInstallment..lastInstallment inclusive (1-based).
+     */
+    static double cumulativeAmountBetween(double baseAmount, double stepUpPercentage,
+                                          int firstInstallment, int lastInstallment) {
+        if (firstInstallment < 1) {
+            firstInstallment = 1;
+        }
+        if (lastInstallment < firstInstallment) {
+            return 0.0;
+        }
+        return cumulativeAmount(baseAmount, stepUpPercentage, lastInstallment) -
+               cumulativeAmount(baseAmount, stepUpPercentage, firstInstallment - 1);
+    }
+
+    /**
+     * (1 + stepUpPercentage/100)^exponent, from the rate's cached table when possible.
+     */
+    static double growthFactor(double stepUpPercentage, int exponent) {
+        if (exponent <= 0) {
+            return 1.0;
+        }
+        if (exponent < kTableSize) {
+            std::shared_ptr<const std::vector<double>> table = factorTable(stepUpPercentage);
+            if (table) {
+                return (*table)[static_cast<size_t>(exponent)];
+            }
+        }
+        return std::pow(1.0 + stepUpPercentage / 100.0, exponent);
+    }
+
+private:
+    struct Cache {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, std::shared_ptr<const std::vector<double>>> tables;
+    };
+
+    static Cache& cache() {
+        static Cache instance;
+        return instance;
+    }
+
+    /**
+     * Factor table for a rate, or nullptr once the cache is full.
+     * Each thread remembers the last table it used, so runs over SIPs with the
+     * same step-up rate skip the shared lock entirely.
+     */
+    static std::shared_ptr<const std::vector<double>> factorTable(double stepUpPercentage) {
+        uint64_t key;
+        std::memcpy(&key, &stepUpPercentage, sizeof(key));
+
+        thread_local uint64_t lastKey = 0;
+        thread_local std::shared_ptr<const std::vector<double>> lastTable;
+        if (lastTable && lastKey == key) {
+            return lastTable;
+        }
+
+        Cache& shared = cache();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        auto it = shared.tables.find(key);
+        if (it == shared.tables.end()) {
+            if (shared.tables.size() >= kMaxCachedRates) {
+                return nullptr;
+            }
+            // std::pow per entry keeps results identical to the uncached formula
+            double growth = 1.0 + stepUpPercentage / 100.0;
+            auto table = std::make_shared<std::vector<double>>(static_cast<size_t>(kTableSize));
+            for (int k = 0; k < kTableSize; ++k) {
+                (*table)[static_cast<size_t>(k)] = std::pow(growth, k);
+            }
+            it = shared.tables.emplace(key, std::move(table)).first;
+        }
+        lastKey = key;
+        lastTable = it->second;
+        return lastTable;
+    }
+};
+
+} // namespace sip
+
+#endif // STEP_UP_ENGINE_H
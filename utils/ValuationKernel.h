@@ -0,0 +1,127 @@
+#ifndef VALUATION_KERNEL_H
+#define VALUATION_KERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIP_VALUATION_KERNEL_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace sip {
+
+/**
+ * Column-wise valuation of holdings:
+ *
+ *   currentValue[i]       = units[i] * navs[fundIndex[i]]
+ *   gainLoss[i]           = currentValue[i] - invested[i]
+ *   gainLossPercentage[i] = invested[i] > 0 ? gainLoss[i] / invested[i] * 100 : 0
+ *
+ * value() picks an AVX2 implementation at runtime when the CPU supports it
+ * and a scalar loop otherwise. Both perform the same IEEE operations in the
+ * same order, so their results are bit-identical. Every fundIndex[i] must be
+ * a valid index into navs.
+ */
+class ValuationKernel {
+public:
+    struct Columns {
+        size_t count;
+        const double* units;
+        const uint32_t* fundIndex;
+        const double* navs;
+        const double* invested;
+        double* currentValue;
+        double* gainLoss;            // May be null if not needed
+        double* gainLossPercentage;  // May be null if not needed
+    };
+
+    static void value(const Columns& columns) {
+#ifdef SIP_VALUATION_KERNEL_AVX2
+        if (hasAvx2()) {
+            valueAvx2(columns);
+            return;
+        }
+#endif
+        valueScalar(columns);
+    }
+
+    static void valueScalar(const Columns& c) {
+        for (size_t i = 0; i < c.count; ++i) {
+            double current = c.units[i] * c.navs[c.fundIndex[i]];
+            c.currentValue[i] = current;
+            if (c.gainLoss) {
+                c.gainLoss[i] = current - c.invested[i];
+            }
+            if (c.gainLossPercentage) {
+                double invested = c.invested[i];
+                c.gainLossPercentage[i] = invested > 0 ? ((current - invested) / invested) * 100.0 : 0.0;
+            }
+        }
+    }
+
+    /**
+     * Name of the implementation value() dispatches to.
+     */
+    static const char* implementationName() {
+#ifdef SIP_VALUATION_KERNEL_AVX2
+        if (hasAvx2()) {
+            return "avx2";
+        }
+#endif
+        return "scalar";
+    }
+
+#ifdef SIP_VALUATION_KERNEL_AVX2
+    static bool hasAvx2() {
+        static const bool supported = __builtin_cpu_supports("avx2") != 0;
+        return supported;
+    }
+
+    __attribute__((target("avx2")))
+    static void valueAvx2(const Columns& c) {
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d hundred = _mm256_set1_pd(100.0);
+        const __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        size_t i = 0;
+        for (; i + 4 <= c.count; i += 4) {
+            __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c.fundIndex + i));
+            __m256d nav = _mm256_mask_i32gather_pd(zero, c.navs, index, allLanes, 8);
+            __m256d current = _mm256_mul_pd(_mm256_loadu_pd(c.units + i), nav);
+            _mm256_storeu_pd(c.currentValue + i, current);
+
+            if (c.gainLoss || c.gainLossPercentage) {
+                __m256d invested = _mm256_loadu_pd(c.invested + i);
+                __m256d gain = _mm256_sub_pd(current, invested);
+                if (c.gainLoss) {
+                    _mm256_storeu_pd(c.gainLoss + i, gain);
+                }
+                if (c.gainLossPercentage) {
+                    // Lanes with invested <= 0 are masked to 0 after the divide
+                    __m256d positive = _mm256_cmp_pd(invested, zero, _CMP_GT_OQ);
+                    __m256d percent = _mm256_mul_pd(_mm256_div_pd(gain, invested), hundred);
+                    _mm256_storeu_pd(c.gainLossPercentage + i, _mm256_and_pd(percent, positive));
+                }
+            }
+        }
+
+        Columns tail = c;
+        tail.count = c.count - i;
+        tail.units += i;
+        tail.fundIndex += i;
+        tail.invested += i;
+        tail.currentValue += i;
+        if (tail.gainLoss) {
+            tail.gainLoss += i;
+        }
+        if (tail.gainLossPercentage) {
+            tail.gainLossPercentage += i;
+        }
+        valueScalar(tail);
+    }
+#endif
+};
+
+} // namespace sip
+
+#endif // VALUATION_KERNEL_H
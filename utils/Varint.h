@@ -0,0 +1,71 @@
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sip {
+
+/**
+ * LEB128-style variable-length integers: 7 bits per byte, low bits first,
+ * high bit set on every byte but the last. Signed values are zigzag-encoded
+ * first so small negative deltas stay small.
+ */
+class Varint {
+public:
+    static const size_t kMaxBytes = 10;  // Enough for any 64-bit value
+
+    static uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    static int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    static void append(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    static void appendSigned(std::vector<uint8_t>& out, int64_t value) {
+        append(out, zigzag(value));
+    }
+
+    /**
+     * Decode one value starting at data[pos] and advance pos past it.
+     * Returns false (leaving pos unchanged) if the input ends mid-value or
+     * the value is longer than kMaxBytes.
+     */
+    static bool read(const uint8_t* data, size_t size, size_t& pos, uint64_t& value) {
+        uint64_t result = 0;
+        size_t limit = size - pos < kMaxBytes ? size - pos : kMaxBytes;
+        for (size_t i = 0; i < limit; ++i) {
+            uint8_t byte = data[pos + i];
+            result |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+            if ((byte & 0x80) == 0) {
+                pos += i + 1;
+                value = result;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool readSigned(const uint8_t* data, size_t size, size_t& pos, int64_t& value) {
+        uint64_t raw;
+        if (!read(data, size, pos, raw)) {
+            return false;
+        }
+        value = unzigzag(raw);
+        return true;
+    }
+};
+
+} // namespace sip
+
+#endif // VARINT_H
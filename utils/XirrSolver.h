@@ -0,0 +1,197 @@
+#ifndef XIRR_SOLVER_H
+#define XIRR_SOLVER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace sip {
+
+/**
+ * Outcome of an XIRR solve. rate is annual and fractional (0.12 = 12%).
+ */
+struct XirrResult {
+    double rate;
+    int iterations;
+    bool converged;
+
+    XirrResult() : rate(0.0), iterations(0), converged(false) {}
+};
+
+/**
+ * Solves for the annual rate r at which the net present value of dated cash
+ * flows is zero:
+ *
+ *   sum(amounts[i] * (1 + r)^(-years[i])) = 0
+ *
+ * years[i] is the time of flow i in years relative to the valuation date
+ * (negative for past flows). Newton's method is tried first from the given
+ * guess; if it leaves the domain (r <= -1) or fails to converge, Brent's
+ * method takes over on a bracketing interval.
+ */
+class XirrSolver {
+public:
+    static const int kMaxNewtonIterations = 50;
+    static const int kMaxBrentIterations = 200;
+
+    static double npv(const double* years, const double* amounts, size_t count, double rate) {
+        double logGrowth = std::log1p(rate);
+        double sum = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            sum += amounts[i] * std::exp(-years[i] * logGrowth);
+        }
+        return sum;
+    }
+
+    static XirrResult solve(const double* years, const double* amounts, size_t count,
+                            double guess = 0.1) {
+        XirrResult result;
+        if (!isSolvable(years, amounts, count)) {
+            return result;
+        }
+
+        double scale = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            scale += std::fabs(amounts[i]);
+        }
+        const double valueTolerance = 1e-10 * scale;
+
+        // Newton
+        double rate = (std::isfinite(guess) && guess > -1.0) ? guess : 0.1;
+        for (int iteration = 1; iteration <= kMaxNewtonIterations; ++iteration) {
+            double value, derivative;
+            npvAndDerivative(years, amounts, count, rate, value, derivative);
+            result.iterations = iteration;
+            if (std::fabs(value) <= valueTolerance) {
+                result.rate = rate;
+                result.converged = true;
+                return result;
+            }
+            if (derivative == 0.0 || !std::isfinite(derivative)) {
+                break;
+            }
+            double next = rate - value / derivative;
+            if (!std::isfinite(next) || next <= -1.0) {
+                break;
+            }
+            if (std::fabs(next - rate) <= 1e-12 * std::max(1.0, std::fabs(rate))) {
+                result.rate = next;
+                result.converged = true;
+                return result;
+            }
+            rate = next;
+        }
+
+        // Brent fallback
+        double low = -0.999999;
+        double high = 1.0;
+        double fLow = npv(years, amounts, count, low);
+        double fHigh = npv(years, amounts, count, high);
+        while (fLow * fHigh > 0 && high < 1e6) {
+            high *= 4.0;
+            fHigh = npv(years, amounts, count, high);
+        }
+        if (fLow * fHigh > 0 || !std::isfinite(fLow) || !std::isfinite(fHigh)) {
+            return result;
+        }
+        return brent(years, amounts, count, low, high, fLow, fHigh, valueTolerance, result.iterations);
+    }
+
+private:
+    /**
+     * A rate only exists if there is both an outflow and an inflow and the
+     * flows span some time; otherwise every rate (or none) solves the equation.
+     */
+    static bool isSolvable(const double* years, const double* amounts, size_t count) {
+        bool hasInflow = false, hasOutflow = false;
+        double earliest = 0.0, latest = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            hasInflow = hasInflow || amounts[i] > 0;
+            hasOutflow = hasOutflow || amounts[i] < 0;
+            if (i == 0 || years[i] < earliest) {
+                earliest = years[i];
+            }
+            if (i == 0 || years[i] > latest) {
+                latest = years[i];
+            }
+        }
+        return hasInflow && hasOutflow && (latest - earliest) * 365.0 >= 0.5;
+    }
+
+    static void npvAndDerivative(const double* years, const double* amounts, size_t count,
+                                 double rate, double& value, double& derivative) {
+        double logGrowth = std::log1p(rate);
+        value = 0.0;
+        derivative = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            double term = amounts[i] * std::exp(-years[i] * logGrowth);
+            value += term;
+            derivative -= years[i] * term;
+        }
+        derivative /= 1.0 + rate;
+    }
+
+    static XirrResult brent(const double* years, const double* amounts, size_t count,
+                            double a, double b, double fa, double fb,
+                            double valueTolerance, int iterationsSoFar) {
+        XirrResult result;
+        result.iterations = iterationsSoFar;
+        double c = b, fc = fb, d = b - a, e = d;
+        for (int iteration = 1; iteration <= kMaxBrentIterations; ++iteration) {
+            result.iterations = iterationsSoFar + iteration;
+            if ((fb > 0 && fc > 0) || (fb < 0 && fc < 0)) {
+                c = a;
+                fc = fa;
+                d = e = b - a;
+            }
+            if (std::fabs(fc) < std::fabs(fb)) {
+                a = b; b = c; c = a;
+                fa = fb; fb = fc; fc = fa;
+            }
+            double tolerance = 2.0 * 1e-15 * std::fabs(b) + 0.5e-12;
+            double middle = 0.5 * (c - b);
+            if (std::fabs(middle) <= tolerance || std::fabs(fb) <= valueTolerance) {
+                result.rate = b;
+                result.converged = true;
+                return result;
+            }
+            if (std::fabs(e) >= tolerance && std::fabs(fa) > std::fabs(fb)) {
+                // Inverse quadratic interpolation (secant when a == c)
+                double s = fb / fa, p, q;
+                if (a == c) {
+                    p = 2.0 * middle * s;
+                    q = 1.0 - s;
+                } else {
+                    double r = fb / fc;
+                    q = fa / fc;
+                    p = s * (2.0 * middle * q * (q - r) - (b - a) * (r - 1.0));
+                    q = (q - 1.0) * (r - 1.0) * (s - 1.0);
+                }
+                if (p > 0) {
+                    q = -q;
+                } else {
+                    p = -p;
+                }
+                if (2.0 * p < std::min(3.0 * middle * q - std::fabs(tolerance * q), std::fabs(e * q))) {
+                    e = d;
+                    d = p / q;
+                } else {
+                    d = middle;
+                    e = d;
+                }
+            } else {
+                d = middle;
+                e = d;
+            }
+            a = b;
+            fa = fb;
+            b += std::fabs(d) > tolerance ? d : (middle > 0 ? tolerance : -tolerance);
+            fb = npv(years, amounts, count, b);
+        }
+        return result;
+    }
+};
+
+} // namespace sip
+
+#endif // XIRR_SOLVER_H